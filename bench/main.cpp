@@ -0,0 +1,599 @@
+#include <ecs/Database.hpp>
+#include <ecs/Any.hpp>
+#include <ecs/OrderedMap.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <limits>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/* Repeatable micro benchmarks of the database layer and the tools.
+ *
+ *     ecs_bench [--filter text] [--samples n] [--output file]
+ *
+ * The sqlite3 benchmarks run on an in-memory database. The postgresql
+ * and mariadb benchmarks only run when a server is configured with
+ * the environment variables ECS_BENCH_<BACKEND>_HOST, _PORT, _DB,
+ * _USER and _PASSWORD where <BACKEND> is POSTGRESQL or MARIADB. The
+ * results are written as JSON.
+ */
+
+namespace {
+
+using clock_T = std::chrono::steady_clock;
+
+/** Runs the given number of operations */
+using body_T = std::function<void(std::size_t)>;
+
+struct Options {
+	std::string  filter;
+	std::size_t  samples = 20;
+	std::string  output;
+	/** Minimum duration of a single sample */
+	std::chrono::milliseconds sampleTime{10};
+};
+
+struct Measurement {
+	std::string          name;
+	std::string          backend;
+	/** Operations per sample */
+	std::size_t          iterations = 0;
+	/** Items processed by one operation like rows or bytes */
+	std::size_t          items      = 1;
+	std::string          itemUnit;
+	/** Nanoseconds per operation of every sample */
+	std::vector<double>  samples;
+};
+
+Options                   options;
+std::vector<Measurement>  measurements;
+
+/** Keeps the compiler from removing the measured work. The empty
+ * assembly pretends to read the value through its address.
+ */
+template<typename T>
+void keep(const T &value) {
+#if defined(__GNUC__)
+	asm volatile("" : : "g"(&value) : "memory");
+#else
+	static const void *volatile sink;
+	sink = &value;
+#endif
+}
+
+double percentile(std::vector<double> values, double fraction) {
+	std::sort(values.begin(), values.end());
+	auto position = fraction * static_cast<double>(values.size() - 1);
+	auto lower    = static_cast<std::size_t>(std::floor(position));
+	auto upper    = std::min(lower + 1, values.size() - 1);
+	return values[lower] + (values[upper] - values[lower]) * (position - static_cast<double>(lower));
+}
+
+std::string escape(const std::string &value) {
+	std::string result;
+	for(auto c : value) {
+		if(c == '"' || c == '\\') {
+			result += '\\';
+		}
+		result += c;
+	}
+	return result;
+}
+
+double elapsed(const body_T &body, std::size_t iterations) {
+	auto start = clock_T::now();
+	body(iterations);
+	return std::chrono::duration<double, std::nano>(clock_T::now() - start).count();
+}
+
+/** Measures the body. The number of operations per sample is doubled
+ * until a sample takes at least the sample time.
+ */
+void bench(const std::string &backend, const std::string &name, const body_T &body,
+		std::size_t items = 1, const std::string &itemUnit = std::string()) {
+	auto fullName = backend + "/" + name;
+	if(!options.filter.empty() && fullName.find(options.filter) == std::string::npos) {
+		return;
+	}
+
+	std::size_t iterations = 1;
+	while(elapsed(body, iterations) < std::chrono::duration<double, std::nano>(options.sampleTime).count() &&
+			iterations < (std::size_t(1) << 30)) {
+		iterations *= 2;
+	}
+
+	Measurement measurement;
+	measurement.name       = name;
+	measurement.backend    = backend;
+	measurement.iterations = iterations;
+	measurement.items      = items;
+	measurement.itemUnit   = itemUnit;
+	for(std::size_t i = 0;i < options.samples;i++) {
+		measurement.samples.push_back(elapsed(body, iterations) / static_cast<double>(iterations));
+	}
+
+	std::cerr << fullName << ": " << percentile(measurement.samples, 0.5) << " ns" << std::endl;
+	measurements.push_back(std::move(measurement));
+}
+
+void writeJson(std::ostream &stream) {
+	stream << std::fixed << std::setprecision(1);
+	stream << "{\n";
+	stream << "  \"version\": \"" << ECS_BENCH_VERSION << "\",\n";
+	stream << "  \"samples\": " << options.samples << ",\n";
+	stream << "  \"benchmarks\": [";
+
+	for(std::size_t i = 0;i < measurements.size();i++) {
+		auto &measurement = measurements[i];
+		auto &samples     = measurement.samples;
+		auto  mean        = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size());
+		auto  variance    = 0.0;
+		for(auto sample : samples) {
+			variance += (sample - mean) * (sample - mean);
+		}
+		variance /= static_cast<double>(samples.size());
+
+		stream << (i == 0 ? "\n" : ",\n");
+		stream << "    {\"backend\": \"" << escape(measurement.backend) << "\", "
+				<< "\"name\": \"" << escape(measurement.name) << "\", "
+				<< "\"iterations\": " << measurement.iterations << ", "
+				<< "\"min_ns\": " << *std::min_element(samples.begin(), samples.end()) << ", "
+				<< "\"median_ns\": " << percentile(samples, 0.5) << ", "
+				<< "\"mean_ns\": " << mean << ", "
+				<< "\"p90_ns\": " << percentile(samples, 0.9) << ", "
+				<< "\"max_ns\": " << *std::max_element(samples.begin(), samples.end()) << ", "
+				<< "\"stddev_ns\": " << std::sqrt(variance);
+		if(!measurement.itemUnit.empty()) {
+			stream << ", \"items_per_op\": " << measurement.items
+					<< ", \"item_unit\": \"" << escape(measurement.itemUnit) << "\""
+					<< ", \"items_per_second\": " << static_cast<double>(measurement.items) * 1e9 / percentile(samples, 0.5);
+		}
+		stream << "}";
+	}
+
+	stream << "\n  ]\n}\n";
+}
+
+/** Differences of the SQL dialects */
+struct Dialect {
+	std::string  backend;
+	bool         dollarParameters = false;
+	std::string  blobType;
+	std::string  uuidQuery;
+	std::string  timestampQuery;
+
+	std::string parameter(int n) const {
+		return dollarParameters ? "$" + std::to_string(n) : "?";
+	}
+};
+
+void benchDatabase(ecs::db3::DbConnection &connection, const Dialect &dialect) {
+	using namespace ecs::db3;
+
+	const std::string &backend = dialect.backend;
+	const std::int64_t rows    = 10000;
+
+	connection.execute("DROP TABLE IF EXISTS bench_items;");
+	connection.execute("DROP TABLE IF EXISTS bench_blobs;");
+	if(!connection.execute("CREATE TABLE bench_items(id BIGINT PRIMARY KEY, name VARCHAR(64), value DOUBLE PRECISION);") ||
+			!connection.execute("CREATE TABLE bench_blobs(id BIGINT PRIMARY KEY, data " + dialect.blobType + ");")) {
+		std::cerr << backend << ": creating the tables failed" << std::endl;
+		return;
+	}
+
+	auto insertQuery = "INSERT INTO bench_items(id, name, value) VALUES(" +
+			dialect.parameter(1) + ", " + dialect.parameter(2) + ", " + dialect.parameter(3) + ");";
+	auto selectQuery = "SELECT id, name, value FROM bench_items WHERE id = " + dialect.parameter(1) + ";";
+
+	/* Fill the table for the scans */
+	{
+		connection.startTransation();
+		auto insert = connection.prepare(insertQuery);
+		for(std::int64_t id = 0;id < rows;id++) {
+			insert->reset();
+			insert->bind(id);
+			insert->bind(std::string("name") + std::to_string(id));
+			insert->bind(static_cast<double>(id) * 0.5);
+			insert->execute();
+		}
+		connection.commitTransaction();
+	}
+
+	bench(backend, "prepare", [&](std::size_t n){
+		for(std::size_t i = 0;i < n;i++) {
+			connection.prepare(selectQuery);
+		}
+	});
+
+	auto select = connection.prepare(selectQuery);
+	bench(backend, "bind_execute_select", [&](std::size_t n){
+		for(std::size_t i = 0;i < n;i++) {
+			select->reset();
+			select->bind(static_cast<std::int64_t>(i % rows));
+			select->execute().fetch();
+		}
+	});
+
+	std::int64_t nextId = rows;
+	auto insert = connection.prepare(insertQuery);
+	bench(backend, "bind_execute_insert", [&](std::size_t n){
+		for(std::size_t i = 0;i < n;i++) {
+			insert->reset();
+			insert->bind(nextId++);
+			insert->bind(std::string("inserted"));
+			insert->bind(1.0);
+			insert->execute();
+		}
+	});
+
+	const std::size_t batch = 100;
+	bench(backend, "bind_execute_batch", [&](std::size_t n){
+		for(std::size_t i = 0;i < n;i++) {
+			connection.startTransation();
+			for(std::size_t j = 0;j < batch;j++) {
+				insert->reset();
+				insert->bind(nextId++);
+				insert->bind(std::string("batched"));
+				insert->bind(2.0);
+				insert->execute();
+			}
+			connection.commitTransaction();
+		}
+	}, batch, "rows");
+
+	connection.execute("DELETE FROM bench_items WHERE id >= " + std::to_string(rows) + ";");
+
+	auto scan = connection.prepare("SELECT id, name, value FROM bench_items;");
+	bench(backend, "scan_fetch", [&](std::size_t n){
+		for(std::size_t i = 0;i < n;i++) {
+			scan->reset();
+			auto result = scan->execute();
+			while(result.fetch());
+		}
+	}, rows, "rows");
+
+	bench(backend, "scan_fetch_all", [&](std::size_t n){
+		for(std::size_t i = 0;i < n;i++) {
+			scan->reset();
+			scan->execute().fetchAll();
+		}
+	}, rows, "rows");
+
+	auto insertBlob = connection.prepare("INSERT INTO bench_blobs(id, data) VALUES(" +
+			dialect.parameter(1) + ", " + dialect.parameter(2) + ");");
+	auto selectBlob = connection.prepare("SELECT data FROM bench_blobs WHERE id = " + dialect.parameter(1) + ";");
+	std::int64_t blobId = 0;
+
+	for(std::size_t size : {std::size_t(1024), std::size_t(64 * 1024), std::size_t(1024 * 1024)}) {
+		std::string data(size, 'x');
+		auto        suffix = std::to_string(size / 1024) + "k";
+
+		bench(backend, "blob_insert_" + suffix, [&](std::size_t n){
+			for(std::size_t i = 0;i < n;i++) {
+				insertBlob->reset();
+				insertBlob->bind(blobId++);
+				insertBlob->bind(std::make_shared<std::stringbuf>(data));
+				insertBlob->execute();
+			}
+		}, size, "bytes");
+
+		auto readId = blobId - 1;
+		bench(backend, "blob_read_" + suffix, [&](std::size_t n){
+			for(std::size_t i = 0;i < n;i++) {
+				selectBlob->reset();
+				selectBlob->bind(readId);
+				auto row = selectBlob->execute().fetch();
+				if(row && row.at(0).getTypeId() == types::typeId::blob) {
+					std::istream stream(row.at(0).cast_reference<types::Blob::type>().get());
+					stream.ignore(std::numeric_limits<std::streamsize>::max());
+				}
+			}
+		}, size, "bytes");
+
+		connection.execute("DELETE FROM bench_blobs;");
+	}
+
+	if(!dialect.uuidQuery.empty()) {
+		auto uuid = connection.prepare(dialect.uuidQuery);
+		bench(backend, "sql_uuid", [&](std::size_t n){
+			for(std::size_t i = 0;i < n;i++) {
+				uuid->reset();
+				uuid->execute().fetch();
+			}
+		});
+	}
+
+	if(!dialect.timestampQuery.empty()) {
+		auto timestamp = connection.prepare(dialect.timestampQuery);
+		bench(backend, "sql_timestamp", [&](std::size_t n){
+			for(std::size_t i = 0;i < n;i++) {
+				timestamp->reset();
+				timestamp->execute().fetch();
+			}
+		});
+	}
+
+	connection.execute("DROP TABLE bench_items;");
+	connection.execute("DROP TABLE bench_blobs;");
+}
+
+/** Same statements as benchDatabase() on the null backend which
+ * has no backend cost. The difference to another backend is the time
+ * spent in the database.
+ */
+void benchNull() {
+	using namespace ecs::db3;
+
+	const std::size_t rows = 10000;
+
+	ConnectionParameters parameters;
+	parameters.setBackend("null");
+
+	SyntheticResult synthetic;
+	synthetic.rows    = rows;
+	synthetic.columns = {types::typeId::int64_T, types::typeId::string, types::typeId::double_T};
+	parameters.setSyntheticResult(synthetic);
+
+	auto connection = parameters.connect();
+
+	bench("null", "prepare", [&](std::size_t n){
+		for(std::size_t i = 0;i < n;i++) {
+			connection->prepare("SELECT id, name, value FROM bench_items WHERE id = ?;");
+		}
+	});
+
+	auto insert = connection->prepare("INSERT INTO bench_items(id, name, value) VALUES(?, ?, ?);");
+	bench("null", "bind_execute_insert", [&](std::size_t n){
+		for(std::size_t i = 0;i < n;i++) {
+			insert->reset();
+			insert->bind(static_cast<std::int64_t>(i));
+			insert->bind(std::string("inserted"));
+			insert->bind(1.0);
+			insert->execute();
+		}
+	});
+
+	auto scan = connection->prepare("SELECT id, name, value FROM bench_items;");
+	bench("null", "scan_fetch", [&](std::size_t n){
+		for(std::size_t i = 0;i < n;i++) {
+			scan->reset();
+			auto result = scan->execute();
+			while(result.fetch());
+		}
+	}, rows, "rows");
+
+	bench("null", "scan_fetch_all", [&](std::size_t n){
+		for(std::size_t i = 0;i < n;i++) {
+			scan->reset();
+			scan->execute().fetchAll();
+		}
+	}, rows, "rows");
+}
+
+void benchServer(const std::string &name, Dialect dialect) {
+	auto environment = [&](const char *key) {
+		auto value = std::getenv(("ECS_BENCH_" + name + "_" + key).c_str());
+		return std::string(value != nullptr ? value : "");
+	};
+
+	if(environment("HOST").empty()) {
+		std::cerr << dialect.backend << ": skipped because ECS_BENCH_" << name << "_HOST is not set" << std::endl;
+		return;
+	}
+
+	ecs::db3::ConnectionParameters parameters;
+	parameters.setBackend(dialect.backend);
+	parameters.setHostname(environment("HOST"));
+	if(!environment("PORT").empty()) {
+		parameters.setPort(std::atoi(environment("PORT").c_str()));
+	}
+	parameters.setDbName(environment("DB"));
+	parameters.setDbUser(environment("USER"));
+	parameters.setDbPassword(environment("PASSWORD"));
+
+	try {
+		auto connection = parameters.connect();
+		benchDatabase(*connection, dialect);
+	}catch(const std::exception &e){
+		std::cerr << dialect.backend << ": " << e.what() << std::endl;
+	}
+}
+
+void benchTools() {
+	using namespace ecs::db3;
+
+	bench("tools", "any_int64_make_cast", [](std::size_t n){
+		std::int64_t sum = 0;
+		for(std::size_t i = 0;i < n;i++) {
+			auto cell = ecs::tools::any::make_unique<types::Int64>(static_cast<std::int64_t>(i));
+			sum += cell->cast_reference<std::int64_t>();
+		}
+		keep(sum);
+	});
+
+	bench("tools", "any_string_make_cast", [](std::size_t n){
+		std::size_t length = 0;
+		for(std::size_t i = 0;i < n;i++) {
+			auto cell = ecs::tools::any::make_unique<types::String>("a string value");
+			length += cell->cast_reference<std::string>().size();
+		}
+		keep(length);
+	});
+
+	bench("tools", "any_copy", [](std::size_t n){
+		types::cell_T cell(std::string("a string value"), types::typeId::string);
+		for(std::size_t i = 0;i < n;i++) {
+			types::cell_T copy(cell);
+			keep(copy.has_value());
+		}
+	});
+
+	const std::size_t entries = 1000;
+	std::vector<std::string> keys;
+	for(std::size_t i = 0;i < entries;i++) {
+		keys.push_back("key" + std::to_string(i));
+	}
+
+	bench("tools", "ordered_map_push_back", [&](std::size_t n){
+		for(std::size_t i = 0;i < n;i++) {
+			ecs::tools::OrderedMap<std::string, std::size_t> map;
+			for(std::size_t j = 0;j < entries;j++) {
+				map.push_back(keys[j], j);
+			}
+		}
+	}, entries, "entries");
+
+	ecs::tools::OrderedMap<std::string, std::size_t> map;
+	for(std::size_t j = 0;j < entries;j++) {
+		map.push_back(keys[j], j);
+	}
+
+	bench("tools", "ordered_map_find", [&](std::size_t n){
+		std::size_t found = 0;
+		for(std::size_t i = 0;i < n;i++) {
+			found += map.find(keys[i % entries]) != map.end();
+		}
+		keep(found);
+	});
+
+	bench("tools", "ordered_map_iterate", [&](std::size_t n){
+		std::size_t sum = 0;
+		for(std::size_t i = 0;i < n;i++) {
+			for(auto &entry : map) {
+				sum += entry.second;
+			}
+		}
+		keep(sum);
+	}, entries, "entries");
+
+	bench("tools", "ordered_map_erase_insert", [&](std::size_t n){
+		for(std::size_t i = 0;i < n;i++) {
+			auto &key = keys[i % entries];
+			map.erase(key);
+			map.push_back(key, i);
+		}
+	});
+}
+
+bool parseArguments(int argc, char **argv) {
+	for(int i = 1;i < argc;i++) {
+		std::string argument = argv[i];
+		if(argument == "--filter" && i + 1 < argc) {
+			options.filter = argv[++i];
+		}else if(argument == "--samples" && i + 1 < argc) {
+			options.samples = std::max(1, std::atoi(argv[++i]));
+		}else if(argument == "--output" && i + 1 < argc) {
+			options.output = argv[++i];
+		}else{
+			std::cerr << "Usage: " << argv[0] << " [--filter text] [--samples n] [--output file]" << std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+}
+
+/** Scans with work for every row which is overlapped with the
+ * stepping of the rows when they are prefetched.
+ */
+void benchPrefetch(std::size_t depth, const std::string &name) {
+	using namespace ecs::db3;
+
+	const std::size_t rows = 10000;
+
+	ConnectionParameters parameters;
+	parameters.setBackend("sqlite3");
+	parameters.setDbFilename(":memory:");
+	parameters.setPrefetchDepth(depth);
+
+	auto connection = parameters.connect();
+	connection->execute("CREATE TABLE bench_items(id BIGINT PRIMARY KEY, name VARCHAR(64), value DOUBLE PRECISION);");
+	connection->execute("WITH RECURSIVE c(x) AS (SELECT 0 UNION ALL SELECT x + 1 FROM c WHERE x < " +
+			std::to_string(rows - 1) + ") INSERT INTO bench_items SELECT x, 'name' || x, x * 0.5 FROM c;");
+
+	auto scan = connection->prepare("SELECT id, name, value FROM bench_items;");
+	bench("sqlite3", name, [&](std::size_t n){
+		for(std::size_t i = 0;i < n;i++) {
+			scan->reset();
+			auto result = scan->execute();
+			while(auto row = result.fetch()) {
+				std::size_t hash = 0;
+				for(int round = 0;round < 8;round++) {
+					hash ^= std::hash<std::string>()(row[1].cast_reference<std::string>()) + round;
+				}
+				keep(hash);
+			}
+		}
+	}, rows, "rows");
+}
+
+int main(int argc, char **argv) {
+	if(!parseArguments(argc, argv)) {
+		return 1;
+	}
+
+	benchTools();
+	benchNull();
+
+	{
+		ecs::db3::ConnectionParameters parameters;
+		parameters.setBackend("sqlite3");
+		parameters.setDbFilename(":memory:");
+
+		Dialect dialect;
+		dialect.backend        = "sqlite3";
+		dialect.blobType       = "BLOB";
+		dialect.uuidQuery      = "SELECT uuid_generate_v4();";
+		dialect.timestampQuery = "SELECT utc_timestamp_us();";
+
+		auto connection = parameters.connect();
+		benchDatabase(*connection, dialect);
+	}
+
+	/* Both run the same way when the process has a single cpu */
+	benchPrefetch(0, "scan_fetch_work");
+	benchPrefetch(4, "scan_fetch_work_prefetch");
+
+	{
+		Dialect dialect;
+		dialect.backend          = "postgresql";
+		dialect.dollarParameters = true;
+		dialect.blobType         = "BYTEA";
+		dialect.uuidQuery        = "SELECT gen_random_uuid();";
+		dialect.timestampQuery   = "SELECT now();";
+		benchServer("POSTGRESQL", dialect);
+	}
+
+	{
+		Dialect dialect;
+		dialect.backend        = "mariadb";
+		dialect.blobType       = "LONGBLOB";
+		dialect.uuidQuery      = "SELECT UUID();";
+		dialect.timestampQuery = "SELECT UTC_TIMESTAMP(6);";
+		benchServer("MARIADB", dialect);
+	}
+
+	if(options.output.empty()) {
+		writeJson(std::cout);
+	}else{
+		std::ofstream stream(options.output);
+		writeJson(stream);
+		if(!stream) {
+			std::cerr << "Writing " << options.output << " failed" << std::endl;
+			return 1;
+		}
+	}
+
+	return 0;
+}
@@ -244,11 +244,21 @@ protected:
 
 	Tid id;
 
+	/** Replaces the value with a copy of the other value. The type id
+	 * is copied as well when there is no value (e.g. database NULL).
+	 */
 	void clone(const Any &other){
-		if (other.typeHolder != nullptr) {
-			typeHolder = other.typeHolder->clone();
-			id         = other.id;
+		if (this == &other) {
+			return;
+		}
+
+		AnyTypeBase::ptr_T holder = other.typeHolder != nullptr ? other.typeHolder->clone() : nullptr;
+		if (typeHolder != nullptr) {
+			delete typeHolder;
 		}
+
+		typeHolder = holder;
+		id         = other.id;
 	}
 };
 
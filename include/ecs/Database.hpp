@@ -8,12 +8,15 @@
 #include <ecs/database/Connection.hpp>
 #include <ecs/database/ConnectionParameters.hpp>
 #include <ecs/database/Connector.hpp>
+#include <ecs/database/GroupCommit.hpp>
 #include <ecs/database/Migrator.hpp>
 #include <ecs/database/Plugin.hpp>
 #include <ecs/database/QueryResult.hpp>
 #include <ecs/database/Row.hpp>
 #include <ecs/database/Statement.hpp>
 #include <ecs/database/Table.hpp>
+#include <ecs/database/WriteBehindTable.hpp>
+#include <ecs/database/MemoryTable.hpp>
 #include <ecs/database/DatabaseInterface.hpp>
 
 #define SQL_QUERY(...) #__VA_ARGS__
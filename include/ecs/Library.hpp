@@ -136,6 +136,13 @@ public:
 		return object.get();
 	}
 
+	/** Get the raw pointer of the stored object. The object is
+	 * only valid as long as this wrapper exists.
+	 */
+	inline TClass *get() const {
+		return object.get();
+	}
+
 protected:
 	/** Storage for the loaded library. This is
 	 * the shared library created by the inline
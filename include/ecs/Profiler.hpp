@@ -0,0 +1,164 @@
+/*
+ * Profiler.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SRC_ECSTOOLS_PROFILER_HPP_
+#define SRC_ECSTOOLS_PROFILER_HPP_
+
+#include <ecs/config.hpp>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ecs {
+namespace tools {
+
+/** A named code region. Zones are created by ECS_PROFILE_ZONE as
+ * static constants so the name is never copied.
+ */
+struct ProfilerZone {
+	const char *name;
+	const char *file;
+	int         line;
+};
+
+/** Aggregated calls of a zone at one position of the call tree.
+ * Times are nanoseconds.
+ */
+struct ECS_EXPORT ProfilerNode {
+	const char                *name            = "";
+	std::uint64_t              calls           = 0;
+	std::uint64_t              totalNanoseconds = 0;
+	/** Time not spent in child zones */
+	std::uint64_t              selfNanoseconds  = 0;
+	std::uint64_t              maxNanoseconds   = 0;
+	/** Sorted by the total time, largest first */
+	std::vector<ProfilerNode>  children;
+};
+
+/** Collects the zones of all threads. Every thread writes the zones
+ * it left into a ring buffer of its own without locks. The buffers
+ * are drained when the statistics are read so the oldest zones of a
+ * thread are lost when more than bufferSize zones are recorded
+ * between two reads.
+ *
+ * Zones are placed with ECS_PROFILE_ZONE which is compiled out unless
+ * the library is built with the ECS_PROFILER option.
+ */
+class ECS_EXPORT Profiler {
+public:
+	static constexpr std::size_t bufferSize = 1 << 14;
+
+	/** A zone which was left */
+	struct Event {
+		const ProfilerZone *zone;
+		std::uint64_t       start;
+		std::uint64_t       end;
+		std::uint32_t       thread;
+		/** Number of zones the thread was in when entering this one */
+		std::uint32_t       depth;
+	};
+
+	static Profiler &instance();
+
+	/** Nanoseconds of the steady clock */
+	static std::uint64_t now();
+
+	/** Called by the zones of the current thread */
+	void record(const ProfilerZone &zone, std::uint64_t start, std::uint64_t end, std::uint32_t depth);
+
+	/** Zones recorded since the last clear() */
+	std::vector<Event> getEvents();
+
+	/** Zones lost because a ring buffer was full */
+	std::uint64_t getDropped();
+
+	/** Merge the recorded zones of all threads into one tree. The
+	 * root has no name and holds the top level zones.
+	 */
+	ProfilerNode getCallTree();
+
+	/** Write the recorded zones in the Chrome trace event format
+	 * which can be opened with chrome://tracing or Perfetto.
+	 */
+	void writeChromeTrace(std::ostream &stream);
+
+	/** Drop all recorded zones */
+	void clear();
+
+private:
+	struct ThreadBuffer;
+
+	Profiler() = default;
+
+	ThreadBuffer &getBuffer();
+
+	/** Move the zones of the ring buffers into events */
+	void drain();
+
+	std::mutex                                  mutex;
+	std::vector<std::shared_ptr<ThreadBuffer>>  buffers;
+	std::vector<Event>                          events;
+	std::uint64_t                               dropped = 0;
+	std::uint32_t                               nextThread = 0;
+};
+
+/** Records the time from construction to destruction */
+class ECS_EXPORT ProfilerScope {
+public:
+	explicit ProfilerScope(const ProfilerZone &zone);
+
+	ProfilerScope(const ProfilerScope &) = delete;
+	ProfilerScope &operator=(const ProfilerScope &) = delete;
+
+	~ProfilerScope();
+
+private:
+	const ProfilerZone &zone;
+	std::uint64_t       start;
+	std::uint32_t       depth;
+};
+
+}
+}
+
+#define ECS_PROFILE_CONCAT_IMPL(a, b) a##b
+#define ECS_PROFILE_CONCAT(a, b) ECS_PROFILE_CONCAT_IMPL(a, b)
+
+/** Profile the rest of the enclosing scope under the given
+ * string literal.
+ */
+#ifdef ECS_PROFILER
+#define ECS_PROFILE_ZONE(zoneName) \
+	static constexpr ::ecs::tools::ProfilerZone ECS_PROFILE_CONCAT(ecsProfileZone, __LINE__){zoneName, __FILE__, __LINE__}; \
+	::ecs::tools::ProfilerScope ECS_PROFILE_CONCAT(ecsProfileScope, __LINE__)(ECS_PROFILE_CONCAT(ecsProfileZone, __LINE__))
+#else
+#define ECS_PROFILE_ZONE(zoneName) do {} while(0)
+#endif
+
+#endif /* SRC_ECSTOOLS_PROFILER_HPP_ */
@@ -0,0 +1,148 @@
+/*
+ * RingBuffer.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SRC_ECSTOOLS_RINGBUFFER_HPP_
+#define SRC_ECSTOOLS_RINGBUFFER_HPP_
+
+#include <ecs/config.hpp>
+#include <ecs/PointerDefinitions.hpp>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace ecs {
+namespace tools {
+
+/** Bounded lock free queue for many producers and many consumers
+ * (Dmitry Vyukov's algorithm). Every slot carries a sequence number
+ * so producers and consumers only compete on one atomic counter each
+ * and never wait for each other. The capacity is rounded up to a
+ * power of two.
+ */
+template<typename T>
+class RingBuffer {
+public:
+	POINTER_DEFINITIONS(RingBuffer<T>);
+
+	explicit RingBuffer(std::size_t minimumCapacity) : mask(roundUp(minimumCapacity) - 1),
+			slots(new Slot[mask + 1]), head(0), tail(0) {
+		for(std::size_t i = 0;i <= mask;++i) {
+			slots[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	RingBuffer(const RingBuffer &buffer) = delete;
+
+	RingBuffer &operator=(const RingBuffer &buffer) = delete;
+
+	/** Returns false when the buffer is full */
+	bool tryPush(T &&value) {
+		Slot       *slot;
+		std::size_t position = tail.load(std::memory_order_relaxed);
+
+		for(;;) {
+			slot = &slots[position & mask];
+			auto sequence   = slot->sequence.load(std::memory_order_acquire);
+			auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+
+			if(difference == 0) {
+				if(tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+					break;
+				}
+			}else if(difference < 0) {
+				return false;
+			}else{
+				position = tail.load(std::memory_order_relaxed);
+			}
+		}
+
+		slot->value = std::move(value);
+		slot->sequence.store(position + 1, std::memory_order_release);
+		return true;
+	}
+
+	/** Returns false when the buffer is empty */
+	bool tryPop(T &value) {
+		Slot       *slot;
+		std::size_t position = head.load(std::memory_order_relaxed);
+
+		for(;;) {
+			slot = &slots[position & mask];
+			auto sequence   = slot->sequence.load(std::memory_order_acquire);
+			auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+
+			if(difference == 0) {
+				if(head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+					break;
+				}
+			}else if(difference < 0) {
+				return false;
+			}else{
+				position = head.load(std::memory_order_relaxed);
+			}
+		}
+
+		value = std::move(slot->value);
+		slot->value = T();
+		slot->sequence.store(position + mask + 1, std::memory_order_release);
+		return true;
+	}
+
+	std::size_t capacity() const {
+		return mask + 1;
+	}
+
+	/** Number of queued values. Only a hint while other threads
+	 * push or pop.
+	 */
+	std::size_t sizeApprox() const {
+		auto first = head.load(std::memory_order_relaxed);
+		auto last  = tail.load(std::memory_order_relaxed);
+		return last > first ? last - first : 0;
+	}
+
+private:
+	struct Slot {
+		std::atomic<std::size_t> sequence;
+		T                        value;
+	};
+
+	static std::size_t roundUp(std::size_t value) {
+		std::size_t result = 2;
+		while(result < value) {
+			result <<= 1;
+		}
+		return result;
+	}
+
+	const std::size_t                   mask;
+	std::unique_ptr<Slot[]>             slots;
+	/** Both counters on their own cache line */
+	alignas(64) std::atomic<std::size_t> head;
+	alignas(64) std::atomic<std::size_t> tail;
+};
+
+}
+}
+
+#endif /* SRC_ECSTOOLS_RINGBUFFER_HPP_ */
@@ -32,6 +32,7 @@
 #include <atomic>
 #include <memory>
 #include <condition_variable>
+#include <chrono>
 
 namespace ecs {
 namespace tools {
@@ -68,6 +69,9 @@ public:
 	 */
 	bool waitForTerminationRequest(std::chrono::milliseconds millis);
 
+	/** Check for a termination request without blocking */
+	bool isTerminationRequested() const;
+
 	/** Set the stop request to true and inform all
 	 * listeners that the application stop has been requested. This
 	 * is independent from system signals so you can safely use this
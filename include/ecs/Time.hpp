@@ -25,6 +25,8 @@
 #include <ecs/config.hpp>
 #include <ecs/PointerDefinitions.hpp>
 #include <ctime>
+#include <chrono>
+#include <cstddef>
 
 namespace ecs {
 namespace time {
@@ -35,6 +37,30 @@ ECS_EXPORT std::tm localtime(const std::time_t *time = nullptr);
 /** Threadsafe version of std::gmtime */
 ECS_EXPORT std::tm gmtime(const std::time_t *time = nullptr);
 
+/** Number of fractional second digits of a formatted timestamp */
+enum class Precision {
+	seconds,
+	milliseconds,
+	microseconds
+};
+
+/** Size of a buffer which is large enough for every
+ * timestamp written by formatISO8601 including the
+ * terminating null character.
+ */
+constexpr std::size_t ISO8601BufferSize = 40;
+
+/** Formats the time as ISO 8601 string (2021-05-17T10:20:30.123Z) into
+ * the buffer and returns the length without the terminating null.
+ * UTC times end with Z, local times with the offset (+0200).
+ *
+ * The date and time up to the seconds is cached per thread. As long as
+ * the second did not change only the fractional digits are written so
+ * this never takes a lock and is cheap when called in a loop.
+ */
+ECS_EXPORT std::size_t formatISO8601(std::chrono::system_clock::time_point time, char *buffer,
+		Precision precision = Precision::seconds, bool localtime = false);
+
 }
 }
 
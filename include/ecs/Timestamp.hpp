@@ -29,28 +29,118 @@
 #include <chrono>
 #include <cstdint>
 #include <string>
+#include <string_view>
+#include <cstddef>
+#include <ecs/Time.hpp>
 
 namespace ecs {
 namespace time {
 
-class TimestampImpl;
-
-/** @todo complete */
-class Timestamp {
-	friend class TimestampImpl;
+/** Point in time as microseconds since 1970-01-01T00:00:00Z. The
+ * value is a single 64 bit integer so it is cheap to copy, compare
+ * and store and never allocates.
+ */
+class ECS_EXPORT Timestamp {
 public:
 	POINTER_DEFINITIONS(Timestamp);
 
-	Timestamp();
+	using duration   = std::chrono::microseconds;
+	using time_point = std::chrono::time_point<std::chrono::system_clock, duration>;
+
+	/** The epoch 1970-01-01T00:00:00Z */
+	constexpr Timestamp() noexcept : micros(0) {
+
+	}
+
+	constexpr explicit Timestamp(duration sinceEpoch) noexcept : micros(sinceEpoch.count()) {
+
+	}
+
+	template<typename Duration>
+	constexpr explicit Timestamp(std::chrono::time_point<std::chrono::system_clock, Duration> time) noexcept :
+		micros(std::chrono::duration_cast<duration>(time.time_since_epoch()).count()) {
+
+	}
+
+	static Timestamp now() noexcept;
+
+	static constexpr Timestamp fromMicroseconds(std::int64_t microseconds) noexcept {
+		return Timestamp(duration(microseconds));
+	}
+
+	/** Build a UTC timestamp from the date and time fields of the
+	 * gregorian calendar. The fields are not validated.
+	 */
+	static Timestamp fromCivil(std::int64_t year, unsigned month, unsigned day,
+			unsigned hour = 0, unsigned minute = 0, unsigned second = 0,
+			std::uint32_t microsecond = 0) noexcept;
+
+	/** Parses ISO 8601 / RFC 3339 timestamps like 2021-05-17,
+	 * 2021-05-17T10:20:30Z, 2021-05-17 10:20:30.123456+02:00 or
+	 * 2021-05-17T10:20:30+0200. Times without an offset are UTC and
+	 * fractional digits after the microseconds are truncated.
+	 * Returns false when the text is not a valid timestamp.
+	 */
+	static bool parse(std::string_view text, Timestamp &result) noexcept;
+
+	/** Same as parse but throws an ecs::Exception on invalid input */
+	static Timestamp fromISO8601(std::string_view text);
+
+	constexpr std::int64_t getMicroseconds() const noexcept {
+		return micros;
+	}
+
+	constexpr time_point toTimePoint() const noexcept {
+		return time_point(duration(micros));
+	}
+
+	/** Writes the UTC ISO 8601 form into a buffer of at least
+	 * ISO8601BufferSize characters and returns the length.
+	 */
+	std::size_t format(char *buffer, Precision precision = Precision::microseconds) const;
+
+	std::string toISO8601(Precision precision = Precision::microseconds) const;
+
+	template<typename Rep, typename Period>
+	constexpr Timestamp &operator+=(std::chrono::duration<Rep, Period> offset) noexcept {
+		micros += std::chrono::duration_cast<duration>(offset).count();
+		return *this;
+	}
+
+	template<typename Rep, typename Period>
+	constexpr Timestamp &operator-=(std::chrono::duration<Rep, Period> offset) noexcept {
+		micros -= std::chrono::duration_cast<duration>(offset).count();
+		return *this;
+	}
+
+	template<typename Rep, typename Period>
+	friend constexpr Timestamp operator+(Timestamp time, std::chrono::duration<Rep, Period> offset) noexcept {
+		return time += offset;
+	}
+
+	template<typename Rep, typename Period>
+	friend constexpr Timestamp operator-(Timestamp time, std::chrono::duration<Rep, Period> offset) noexcept {
+		return time -= offset;
+	}
+
+	friend constexpr duration operator-(Timestamp a, Timestamp b) noexcept {
+		return duration(a.micros - b.micros);
+	}
 
-	virtual ~Timestamp();
+	friend constexpr bool operator==(Timestamp a, Timestamp b) noexcept { return a.micros == b.micros; }
+	friend constexpr bool operator!=(Timestamp a, Timestamp b) noexcept { return a.micros != b.micros; }
+	friend constexpr bool operator<(Timestamp a, Timestamp b) noexcept { return a.micros < b.micros; }
+	friend constexpr bool operator<=(Timestamp a, Timestamp b) noexcept { return a.micros <= b.micros; }
+	friend constexpr bool operator>(Timestamp a, Timestamp b) noexcept { return a.micros > b.micros; }
+	friend constexpr bool operator>=(Timestamp a, Timestamp b) noexcept { return a.micros >= b.micros; }
 
 protected:
-	std::shared_ptr<TimestampImpl> impl;
+	std::int64_t micros;
 };
 
 namespace ISO8601 {
-	ECS_EXPORT std::string now(std::chrono::seconds offset = std::chrono::seconds(0), bool localtime = false);
+	ECS_EXPORT std::string now(std::chrono::seconds offset = std::chrono::seconds(0), bool localtime = false,
+			Precision precision = Precision::seconds);
 }
 
 }
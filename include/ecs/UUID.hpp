@@ -24,21 +24,47 @@
 #define SRC_ECSTOOLS_UUID_HPP_
 
 #include <ecs/config.hpp>
+#include <array>
 #include <string>
+#include <string_view>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
 
 namespace ecs {
 namespace tools {
 
 class UUID;
 
-/** Random UUID generator version 4*/
+/** Random UUID generator version 4. The bytes come from the random
+ * source of the operating system. Every thread buffers them on its
+ * own so generating never waits for a lock.
+ */
 class ECS_EXPORT UUIDGenerator {
 public:
 	virtual ~UUIDGenerator();
 	UUIDGenerator();
 
 	virtual void generate(UUID &target) const;
+
+	/** Fill n UUIDs at once */
+	virtual void generate(UUID *targets, std::size_t n) const;
+};
+
+/** Time ordered UUID version 7 (RFC 9562). The first 48 bits are
+ * the unix time in milliseconds followed by a 12 bit counter so
+ * UUIDs generated by one thread are strictly increasing. New keys
+ * are always appended to the end of a B-tree index instead of being
+ * inserted at random positions.
+ */
+class ECS_EXPORT UUIDGenerator7 : public UUIDGenerator {
+public:
+	virtual ~UUIDGenerator7();
+	UUIDGenerator7();
+
+	virtual void generate(UUID &target) const;
+
+	virtual void generate(UUID *targets, std::size_t n) const;
 };
 
 #ifdef ECS_HAVE_LIBUUID
@@ -52,26 +78,95 @@ public:
 
 	virtual void generate(UUID &target) const;
 
+	virtual void generate(UUID *targets, std::size_t n) const;
+
 protected:
 	bool useSecure;
 };
 #endif
 
+/** UUID stored as its 16 bytes in network byte order. The
+ * default value is the nil UUID.
+ */
 class ECS_EXPORT UUID {
 	friend class UUIDGenerator;
+	friend class UUIDGenerator7;
 	friend class UUIDGenerator2;
 public:
-	virtual ~UUID();
-	UUID();
+	using bytes_T = std::array<std::uint8_t, 16>;
+
+	/** Length of the canonical text form without terminating zero */
+	static constexpr std::size_t StringSize = 36;
+
+	constexpr UUID() noexcept : bytes{} {
+
+	}
+
+	constexpr explicit UUID(const bytes_T &bytes) noexcept : bytes(bytes) {
+
+	}
+
 	UUID(const UUIDGenerator &generator);
 
+	/** Parses the canonical form. Upper case digits, missing dashes
+	 * and surrounding braces are accepted. Returns false when the
+	 * text is not a valid UUID.
+	 */
+	static bool parse(std::string_view text, UUID &result) noexcept;
+
+	/** Same as parse but throws an ecs::Exception on invalid input */
+	static UUID fromString(std::string_view text);
+
+	/** Writes the lower case canonical form into a buffer of at
+	 * least StringSize characters. No terminating zero is written.
+	 */
+	void format(char *buffer) const noexcept;
+
 	std::string toString() const;
+
+	constexpr const bytes_T &getBytes() const noexcept {
+		return bytes;
+	}
+
+	const std::uint8_t *data() const noexcept {
+		return bytes.data();
+	}
+
+	std::uint8_t *data() noexcept {
+		return bytes.data();
+	}
+
+	constexpr int getVersion() const noexcept {
+		return bytes[6] >> 4;
+	}
+
+	bool isNil() const noexcept;
+
+	std::size_t hash() const noexcept;
+
+	friend bool operator==(const UUID &a, const UUID &b) noexcept { return a.bytes == b.bytes; }
+	friend bool operator!=(const UUID &a, const UUID &b) noexcept { return a.bytes != b.bytes; }
+	friend bool operator<(const UUID &a, const UUID &b) noexcept { return a.bytes < b.bytes; }
+	friend bool operator<=(const UUID &a, const UUID &b) noexcept { return a.bytes <= b.bytes; }
+	friend bool operator>(const UUID &a, const UUID &b) noexcept { return a.bytes > b.bytes; }
+	friend bool operator>=(const UUID &a, const UUID &b) noexcept { return a.bytes >= b.bytes; }
+
 protected:
-	std::string data;
+	bytes_T bytes;
 };
 
 }
 }
 
+namespace std {
+
+template<>
+struct hash<ecs::tools::UUID> {
+	std::size_t operator()(const ecs::tools::UUID &uuid) const noexcept {
+		return uuid.hash();
+	}
+};
+
+}
 
 #endif /* SRC_ECSTOOLS_UUID_HPP_ */
@@ -11,5 +11,6 @@
 #cmakedefine ECS_POSTGRESQL_DRIVER
 #cmakedefine ECS_SQLITE3_DRIVER
 #cmakedefine ECS_MARIADB_DRIVER
+#cmakedefine ECS_PROFILER
 
 #endif
@@ -0,0 +1,81 @@
+/*
+ * ChangeCapture.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef INCLUDE_ECS_DATABASE_CHANGECAPTURE_HPP_
+#define INCLUDE_ECS_DATABASE_CHANGECAPTURE_HPP_
+
+#include <ecs/config.hpp>
+#include <ecs/database/types.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ecs {
+namespace db3 {
+
+/** @addtogroup ecsdb
+ * @{
+ */
+
+enum class ChangeOperation {
+	insert,
+	update,
+	remove
+};
+
+/** A single row changed by a committed transaction */
+struct ECS_EXPORT ChangeEvent {
+	ChangeOperation             operation = ChangeOperation::insert;
+	/** Name of the attached database like "main" */
+	std::string                 database;
+	std::string                 table;
+	/** Row id before the change. Not set for inserts. */
+	std::int64_t                oldRowid  = 0;
+	/** Row id after the change. Not set for deletes. */
+	std::int64_t                newRowid  = 0;
+	/** Column values before the change. Empty for inserts or when
+	 * the backend does not provide the values.
+	 */
+	std::vector<types::cell_T>  oldValues;
+	/** Column values after the change. Empty for deletes or when
+	 * the backend does not provide the values.
+	 */
+	std::vector<types::cell_T>  newValues;
+};
+
+/** All rows changed by one committed transaction in the order
+ * of the changes. Changes which were rolled back are not part of
+ * a batch.
+ */
+struct ECS_EXPORT ChangeBatch {
+	/** Increases with every published batch of a connection */
+	std::uint64_t               sequence = 0;
+	std::vector<ChangeEvent>    events;
+};
+
+/** @} */
+
+}
+}
+
+#endif /* INCLUDE_ECS_DATABASE_CHANGECAPTURE_HPP_ */
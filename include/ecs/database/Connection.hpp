@@ -28,10 +28,21 @@
 #include <vector>
 #include <cstdint>
 #include <memory>
+#include <future>
+#include <chrono>
+#include <functional>
 #include <ecs/PointerDefinitions.hpp>
 #include <ecs/Library.hpp>
 #include <ecs/database/ConnectionParameters.hpp>
 #include <ecs/database/Statement.hpp>
+#include <ecs/database/MaintenanceStatistics.hpp>
+#include <ecs/database/ResultCacheStatistics.hpp>
+#include <ecs/database/StatementMetrics.hpp>
+#include <ecs/database/IndexAdvice.hpp>
+#include <ecs/database/ChangeCapture.hpp>
+#include <ecs/database/Notification.hpp>
+#include <ecs/Function.hpp>
+#include <ecs/database/MemoryTable.hpp>
 
 namespace ecs {
 namespace db3 {
@@ -67,6 +78,11 @@ class ECS_EXPORT DbConnection {
 public:
 	POINTER_DEFINITIONS(DbConnection);
 
+	/** Receives the remaining and the total number of pages
+	 * while a backup is running.
+	 */
+	using backupProgress_T = std::function<void(int remaining, int pageCount)>;
+
 	virtual ~DbConnection();
 
 	DbConnection(const DbConnection &connection) = delete;
@@ -110,6 +126,114 @@ public:
 	void rollbackTransaction();
 	void autocommit(bool);
 
+	/** Start an online backup of this database into the database described
+	 * by the connection parameters. The backup runs on the worker thread of this
+	 * connection and copies pagesPerStep pages at once. Between two steps the
+	 * thread sleeps for the given time so writers on this connection are never
+	 * blocked for longer than a single step. Asynchronous executions queued
+	 * after the backup wait until it has finished, and so does closing the
+	 * connection.
+	 *
+	 * The returned future throws when the backup failed. Only backends
+	 * supporting online backups (sqlite3) can be used as source and destination.
+	 */
+	std::future<void> backupTo(const ConnectionParameters &params,
+			int pagesPerStep = 64,
+			std::chrono::milliseconds sleep = std::chrono::milliseconds(10),
+			backupProgress_T progress = backupProgress_T());
+
+	/** Same as the backup into connection parameters but the destination is
+	 * an already opened connection. This allows backups into in-memory databases.
+	 * Both connections are kept open until the backup has finished.
+	 */
+	std::future<void> backupTo(DbConnection &destination,
+			int pagesPerStep = 64,
+			std::chrono::milliseconds sleep = std::chrono::milliseconds(10),
+			backupProgress_T progress = backupProgress_T());
+
+	/** Get a snapshot of the background maintenance statistics
+	 * (WAL checkpoints and incremental vacuum). The maintenance is
+	 * enabled with the connection parameters.
+	 */
+	MaintenanceStatistics getMaintenanceStatistics();
+
+	/** Get a snapshot of the query result cache counters. The
+	 * cache is enabled with the connection parameters.
+	 */
+	ResultCacheStatistics getResultCacheStatistics();
+
+	/** Get the metrics of every statement prepared or executed on
+	 * this connection and its clones. Statements are grouped by their
+	 * text with the literal values removed. The list is empty unless
+	 * the metrics are enabled with the connection parameters.
+	 */
+	std::vector<StatementStatistics> getStatementStatistics();
+
+	/** Same as getStatementStatistics() in the Prometheus text
+	 * exposition format. The statement text is the label of the
+	 * series so keep the number of different statements small.
+	 */
+	std::string dumpMetrics();
+
+	/** Get the metrics recorded by the instrumented backend for the
+	 * calls into the wrapped backend. The statement metrics include the
+	 * time spent in the library so the difference is its overhead. The
+	 * list is empty for all other backends.
+	 */
+	std::vector<StatementStatistics> getBackendStatistics();
+
+	/** True when the backend locks the whole database for the first
+	 * write of a transaction (only sqlite3 does). Transactions which
+	 * write should then start with BEGIN IMMEDIATE.
+	 */
+	bool locksDatabaseOnWrite() const;
+
+	/** Propose indexes for the statements captured since the
+	 * connection was opened. The most useful index comes first.
+	 * The indexes are not created.
+	 *
+	 * Throws when the backend has no index advisor (only sqlite3
+	 * has one) or when the workload capture is disabled in the
+	 * connection parameters.
+	 */
+	std::vector<IndexAdvice> adviseIndexes();
+
+	/** Get notified about the rows changed through this connection
+	 * and its clones. Every committed transaction is delivered as one
+	 * batch and rolled back changes are dropped. The subscribers run
+	 * on a thread of the connection so a slow subscriber delays the
+	 * following batches but never the writers.
+	 *
+	 * Throws when the backend does not support change capture (only
+	 * sqlite3 does).
+	 */
+	void subscribeChanges(ecs::tools::Function<void(ChangeBatch&)> subscriber);
+
+	/** Subscribe to the notifications of a channel (LISTEN in
+	 * postgres). The listener is called on a thread of the connection
+	 * as soon as the notification arrives. Listeners of one connection
+	 * are called one after another so they should return quickly.
+	 *
+	 * Throws when the backend does not support notifications (only
+	 * postgresql does) or when listening failed.
+	 */
+	void listen(const std::string &channel, notificationListener_T listener);
+
+	/** Remove all listeners of the channel */
+	void unlisten(const std::string &channel);
+
+	/** Make in-process data available to SQL under the given table
+	 * name so it can be joined against persisted tables without
+	 * inserting it first. The connection keeps the table alive but
+	 * the referenced data must outlive the connection and must not
+	 * change while a query reads it. Registering the same name again
+	 * replaces the table.
+	 *
+	 * Throws when the backend does not support memory tables (only
+	 * sqlite3 does).
+	 */
+	void registerTable(const std::string &name, MemoryTable::sharedPtr_T table);
+
 protected:
 	/** Implementation details for the connection.
 	 *
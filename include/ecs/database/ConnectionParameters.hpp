@@ -27,6 +27,10 @@
 #include <ecs/PointerDefinitions.hpp>
 #include <string>
 #include <memory>
+#include <chrono>
+#include <cstddef>
+#include <ecs/database/SlowQuery.hpp>
+#include <ecs/database/SyntheticResult.hpp>
 
 namespace ecs {
 namespace db3 {
@@ -98,6 +102,116 @@ public:
 
 	void setUseTLS(bool);
 
+	/** Number of WAL pages after which a background checkpoint is
+	 * started. When this is greater than 0 the backend disables its
+	 * own automatic checkpoints which would otherwise run inline on
+	 * the committing writer. The default of 0 keeps the backend
+	 * behaviour. Only used by the sqlite3 backend.
+	 */
+	void setWalCheckpointPages(int pages);
+
+	int getWalCheckpointPages() const;
+
+	/** When no commit happened for this amount of time the background
+	 * maintenance checkpoints the WAL even if it did not reach the page
+	 * limit and runs the incremental vacuum.
+	 */
+	void setMaintenanceIdleTime(std::chrono::milliseconds idleTime);
+
+	std::chrono::milliseconds getMaintenanceIdleTime() const;
+
+	/** Maximum number of free pages released by a single
+	 * incremental vacuum run. 0 disables the incremental vacuum.
+	 */
+	void setIncrementalVacuumPages(int pages);
+
+	int getIncrementalVacuumPages() const;
+
+	/** Byte budget of the query result cache. Results of read only
+	 * queries are kept until a referenced table changes or until the
+	 * least recently used results must make room for new ones. The
+	 * default of 0 disables the cache. Only used by the sqlite3 backend.
+	 *
+	 * The cache only sees changes made through the same connection so
+	 * do not enable it when other connections or processes write to
+	 * the database.
+	 */
+	void setResultCacheBytes(std::size_t bytes);
+
+	std::size_t getResultCacheBytes() const;
+
+	/** Collect execution counts, fetched rows and latency histograms
+	 * for every statement of the connection. Disabled by default.
+	 */
+	void setStatementMetrics(bool enabled);
+
+	bool getStatementMetrics() const;
+
+	/** Statements running longer than the threshold are given to
+	 * the slow query sink together with their query plan. The default
+	 * of 0 disables the slow query log. Only used by the sqlite3
+	 * backend which measures in milliseconds.
+	 */
+	void setSlowQueryThreshold(std::chrono::microseconds threshold);
+
+	std::chrono::microseconds getSlowQueryThreshold() const;
+
+	/** Receives the slow queries. The sink is called on a thread of
+	 * the connection so it never delays the statements. Slow queries
+	 * are dropped while too many of them wait for the sink.
+	 */
+	void setSlowQuerySink(slowQuerySink_T sink);
+
+	const slowQuerySink_T &getSlowQuerySink() const;
+
+	/** Sum up the statement counters of every statement which scans a
+	 * table or builds an automatic index. The captured workload is used
+	 * by DbConnection::adviseIndexes(). Only used by the sqlite3 backend.
+	 */
+	void setWorkloadCapture(bool enabled);
+
+	bool getWorkloadCapture() const;
+
+	/** Backend used by the "instrumented" backend. The instrumented
+	 * backend forwards every call to it and records the time spent in
+	 * the backend, the fetched rows and bytes and the errors. Compare
+	 * DbConnection::getBackendStatistics() with the statement metrics to
+	 * see the overhead of the library.
+	 */
+	void setWrappedBackend(const std::string &backend);
+
+	const std::string &getWrappedBackend() const;
+
+	/** Result of every statement of the "null" backend. The backend
+	 * does no I/O so it measures the cost of the library alone.
+	 */
+	void setSyntheticResult(const SyntheticResult &result);
+
+	const SyntheticResult &getSyntheticResult() const;
+
+	/** Number of row batches a thread of the statement steps ahead of
+	 * the fetching thread for read only queries. The scan overlaps with
+	 * the processing of the rows then. The default of 0 steps the rows
+	 * while they are fetched, which is also done when the process can
+	 * only run on a single cpu. Only used by the sqlite3 backend.
+	 */
+	void setPrefetchDepth(std::size_t depth);
+
+	std::size_t getPrefetchDepth() const;
+
+	/** Return integers of columns declared as TIMESTAMP or DATETIME
+	 * as types::Timestamp holding microseconds since the epoch. This is
+	 * how timestamps are bound. Disabled by default because existing
+	 * databases often store seconds or milliseconds in such columns.
+	 *
+	 * The postgresql and mariadb backends return timestamp and date
+	 * columns as types::Timestamp and uuid or BINARY(16) columns as
+	 * types::Uuid only with this enabled. Otherwise they are strings.
+	 */
+	void setNativeTimestamps(bool enabled);
+
+	bool getNativeTimestamps() const;
+
 	inline std::shared_ptr<DbConnection> connect() {
 		return std::shared_ptr<DbConnection>(connectPtr());
 	}
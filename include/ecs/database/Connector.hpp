@@ -26,6 +26,7 @@
 #include <ecs/config.hpp>
 #include <memory>
 #include <ecs/PointerDefinitions.hpp>
+#include <ecs/Library.hpp>
 #include <ecs/database/Connection.hpp>
 #include <ecs/database/ConnectionParameters.hpp>
 
@@ -37,6 +38,7 @@ namespace db3 {
  */
 
 class MigratorImpl;
+class ConnectionImpl;
 
 /** Plugin loader class for a database plugin defined
  * by the database parameters. Before you can make any 
@@ -73,6 +75,12 @@ public:
 	 * always the possibility to get all the parameters.
 	 */
 	DbConnection::ptr_T loadPtr(const ConnectionParameters &params);
+
+	/** Create the unconnected implementation of a backend. Builtin
+	 * backends are used first, then the plugin directory is searched.
+	 * Throws when the backend does not exist.
+	 */
+	static ecs::dynlib::Class<ConnectionImpl> loadModule(const ConnectionParameters &params, const std::string &backend);
 protected:
 
 
@@ -0,0 +1,126 @@
+/*
+ * GroupCommit.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDE_ECS_DATABASE_GROUPCOMMIT_HPP_
+#define INCLUDE_ECS_DATABASE_GROUPCOMMIT_HPP_
+
+#include <ecs/config.hpp>
+#include <ecs/PointerDefinitions.hpp>
+#include <ecs/database/Connection.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+
+namespace ecs {
+namespace db3 {
+
+/** @addtogroup ecsdb
+ * @{
+ */
+
+struct ECS_EXPORT GroupCommitStatistics {
+	/** Number of committed or rolled back transactions */
+	std::uint64_t transactions = 0;
+	/** Number of executed submissions */
+	std::uint64_t submissions  = 0;
+	/** Submissions which threw and were rolled back */
+	std::uint64_t failures     = 0;
+	/** Largest number of submissions in one transaction */
+	std::uint64_t largestBatch = 0;
+};
+
+/** Coalesces many small write transactions of different threads
+ * into one transaction on a shared connection. A commit waits for
+ * the disk so committing a batch of submissions at once costs about
+ * the same as committing a single one.
+ *
+ * Every submission runs inside its own savepoint. A submission which
+ * throws is rolled back to its savepoint and its future throws while
+ * the other submissions of the batch are committed. When rolling
+ * back to the savepoint fails the whole batch is rolled back and all
+ * futures throw. The futures are resolved after the transaction has
+ * been committed.
+ *
+ * The closures run on the worker thread of the group commit and must
+ * only use the connection they receive.
+ */
+class ECS_EXPORT GroupCommit {
+public:
+	POINTER_DEFINITIONS(GroupCommit);
+
+	using work_T = std::function<void(DbConnection &connection)>;
+
+	/** A batch is committed when the first submission waited for
+	 * the given window or when maxBatch submissions are queued.
+	 */
+	GroupCommit(DbConnection::sharedPtr_T connection,
+			std::chrono::microseconds window = std::chrono::milliseconds(2),
+			std::size_t maxBatch = 128);
+
+	/** Commits all queued submissions before returning */
+	~GroupCommit();
+
+	GroupCommit(const GroupCommit &groupCommit) = delete;
+
+	GroupCommit &operator=(const GroupCommit &groupCommit) = delete;
+
+	std::future<void> submit(work_T work);
+
+	GroupCommitStatistics getStatistics();
+
+protected:
+	struct Submission {
+		work_T             work;
+		std::promise<void> promise;
+	};
+
+	DbConnection::sharedPtr_T  connection;
+	std::chrono::microseconds  window;
+	std::size_t                maxBatch;
+	std::string                beginQuery;
+	/** Numbers the savepoint names, only used by the worker */
+	std::uint64_t              batchNumber;
+
+	std::mutex                 mutex;
+	std::condition_variable    condition;
+	std::deque<Submission>     queue;
+	bool                       stop;
+	GroupCommitStatistics      statistics;
+	std::thread                worker;
+
+	void run();
+
+	void commitBatch(std::deque<Submission> &batch);
+};
+
+/** @} */
+
+}
+}
+
+#endif /* INCLUDE_ECS_DATABASE_GROUPCOMMIT_HPP_ */
@@ -0,0 +1,59 @@
+/*
+ * IndexAdvice.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef INCLUDE_ECS_DATABASE_INDEXADVICE_HPP_
+#define INCLUDE_ECS_DATABASE_INDEXADVICE_HPP_
+
+#include <ecs/config.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ecs {
+namespace db3 {
+
+/** @addtogroup ecsdb
+ * @{
+ */
+
+/** An index proposed by the index advisor for the captured workload */
+struct ECS_EXPORT IndexAdvice {
+	/** CREATE INDEX statement which creates the index */
+	std::string               createStatement;
+	std::string               table;
+	std::vector<std::string>  columns;
+	/** Virtual machine steps spent in table scans and automatic
+	 * indexes by the statements which would use the index. This
+	 * is an estimate of the steps saved by creating it.
+	 */
+	std::uint64_t             savedSteps   = 0;
+	/** Statements of the workload which would use the index */
+	std::vector<std::string>  statements;
+};
+
+/** @} */
+
+}
+}
+
+#endif /* INCLUDE_ECS_DATABASE_INDEXADVICE_HPP_ */
@@ -0,0 +1,72 @@
+/*
+ * MaintenanceStatistics.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDE_ECS_DATABASE_MAINTENANCESTATISTICS_HPP_
+#define INCLUDE_ECS_DATABASE_MAINTENANCESTATISTICS_HPP_
+
+#include <ecs/config.hpp>
+#include <chrono>
+#include <cstdint>
+
+namespace ecs {
+namespace db3 {
+
+/** @addtogroup ecsdb
+ * @{
+ */
+
+/** Snapshot of the work done by the background maintenance
+ * of a connection. All values are zero when the backend does
+ * not run a background maintenance.
+ */
+struct ECS_EXPORT MaintenanceStatistics {
+	/** True when the background maintenance is running */
+	bool                      active                = false;
+	/** Number of finished WAL checkpoints */
+	std::uint64_t             checkpoints           = 0;
+	/** Checkpoints started because the WAL reached the page limit */
+	std::uint64_t             sizeCheckpoints       = 0;
+	/** Checkpoints started because the connection was idle */
+	std::uint64_t             idleCheckpoints       = 0;
+	/** Sum of the frames moved into the database file */
+	std::uint64_t             checkpointedFrames    = 0;
+	std::chrono::microseconds lastCheckpointDuration{0};
+	std::chrono::microseconds maxCheckpointDuration{0};
+	std::chrono::microseconds totalCheckpointDuration{0};
+	/** Number of pages in the WAL after the last commit */
+	std::uint64_t             walPages              = 0;
+	/** Largest WAL size in pages seen after a commit */
+	std::uint64_t             maxWalPages           = 0;
+	/** Sum of the pages appended to the WAL by all commits */
+	std::uint64_t             walPagesWritten       = 0;
+	/** Number of incremental vacuum runs which released pages */
+	std::uint64_t             vacuums               = 0;
+	/** Sum of the pages released by the incremental vacuum */
+	std::uint64_t             vacuumedPages         = 0;
+};
+
+/** @} */
+
+}
+}
+
+#endif /* INCLUDE_ECS_DATABASE_MAINTENANCESTATISTICS_HPP_ */
@@ -0,0 +1,227 @@
+/*
+ * MemoryTable.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDE_ECS_DATABASE_MEMORYTABLE_HPP_
+#define INCLUDE_ECS_DATABASE_MEMORYTABLE_HPP_
+
+#include <ecs/config.hpp>
+#include <ecs/PointerDefinitions.hpp>
+#include <ecs/database/types.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace ecs {
+namespace db3 {
+
+/** @addtogroup ecsdb
+ * @{
+ */
+
+/** Description of a single column of a memory table. Only
+ * int64_T, double_T and string are supported as types. When sorted
+ * is set the values of the column are in ascending order which allows
+ * a binary search for equality and range filters.
+ */
+struct ECS_EXPORT MemoryColumn {
+	std::string    name;
+	types::typeId  type;
+	bool           sorted;
+};
+
+/** In-process data which can be queried with SQL without copying
+ * it into a table first. The database reads the values directly
+ * from the memory so the data must not be changed while a query
+ * is running.
+ *
+ * Use RowVectorTable or ColumnBatch instead of implementing
+ * this interface directly.
+ */
+class ECS_EXPORT MemoryTable {
+public:
+	POINTER_DEFINITIONS(MemoryTable);
+
+	virtual ~MemoryTable();
+
+	virtual const std::vector<MemoryColumn> &getColumns() const = 0;
+
+	virtual std::size_t size() const = 0;
+
+	/** Only called for int64_T columns */
+	virtual std::int64_t getInt64(std::size_t row, std::size_t column) const;
+
+	/** Only called for double_T columns */
+	virtual double getDouble(std::size_t row, std::size_t column) const;
+
+	/** Only called for string columns. The view must stay valid
+	 * until the data changes.
+	 */
+	virtual std::string_view getText(std::size_t row, std::size_t column) const;
+
+	/** Map a C++ type to the column type used in the database */
+	template<typename T>
+	static constexpr types::typeId columnType() {
+		if constexpr (std::is_integral_v<T>) {
+			return types::typeId::int64_T;
+		}else if constexpr (std::is_floating_point_v<T>) {
+			return types::typeId::double_T;
+		}else {
+			static_assert(std::is_convertible_v<const T&, std::string_view>,
+					"Only integral, floating point and string columns are supported");
+			return types::typeId::string;
+		}
+	}
+};
+
+/** Exposes a vector of structs. Every column is generated from
+ * a member pointer:
+ *
+ *     RowVectorTable<Item> table(items);
+ *     table.field("id", &Item::id, true).field("name", &Item::name);
+ *
+ * The vector is referenced and not copied.
+ */
+template<typename T>
+class RowVectorTable : public MemoryTable {
+public:
+	POINTER_DEFINITIONS(RowVectorTable<T>);
+
+	explicit RowVectorTable(const std::vector<T> &rows) : rows(rows) {
+
+	}
+
+	template<typename M>
+	RowVectorTable &field(const std::string &name, M T::*member, bool sorted = false) {
+		columns.push_back(MemoryColumn{name, columnType<M>(), sorted});
+		fields.push_back(std::make_unique<Field<M>>(member));
+		return *this;
+	}
+
+	const std::vector<MemoryColumn> &getColumns() const override {
+		return columns;
+	}
+
+	std::size_t size() const override {
+		return rows.size();
+	}
+
+	std::int64_t getInt64(std::size_t row, std::size_t column) const override {
+		return fields[column]->getInt64(rows[row]);
+	}
+
+	double getDouble(std::size_t row, std::size_t column) const override {
+		return fields[column]->getDouble(rows[row]);
+	}
+
+	std::string_view getText(std::size_t row, std::size_t column) const override {
+		return fields[column]->getText(rows[row]);
+	}
+
+protected:
+	struct FieldBase {
+		virtual ~FieldBase() = default;
+		virtual std::int64_t getInt64(const T &row) const = 0;
+		virtual double getDouble(const T &row) const = 0;
+		virtual std::string_view getText(const T &row) const = 0;
+	};
+
+	template<typename M>
+	struct Field : FieldBase {
+		explicit Field(M T::*member) : member(member) {}
+
+		std::int64_t getInt64(const T &row) const override {
+			if constexpr (columnType<M>() == types::typeId::int64_T) {
+				return static_cast<std::int64_t>(row.*member);
+			}
+			return 0;
+		}
+
+		double getDouble(const T &row) const override {
+			if constexpr (columnType<M>() == types::typeId::double_T) {
+				return static_cast<double>(row.*member);
+			}
+			return 0.0;
+		}
+
+		std::string_view getText(const T &row) const override {
+			if constexpr (columnType<M>() == types::typeId::string) {
+				return std::string_view(row.*member);
+			}
+			return std::string_view();
+		}
+
+		M T::*member;
+	};
+
+	const std::vector<T>                     &rows;
+	std::vector<MemoryColumn>                 columns;
+	std::vector<std::unique_ptr<FieldBase>>   fields;
+};
+
+/** Exposes one vector per column. All columns must have the
+ * same size. The vectors are referenced and not copied.
+ */
+class ECS_EXPORT ColumnBatch : public MemoryTable {
+public:
+	POINTER_DEFINITIONS(ColumnBatch);
+
+	ColumnBatch &column(const std::string &name, const std::vector<std::int64_t> &values, bool sorted = false);
+
+	ColumnBatch &column(const std::string &name, const std::vector<double> &values, bool sorted = false);
+
+	ColumnBatch &column(const std::string &name, const std::vector<std::string> &values, bool sorted = false);
+
+	const std::vector<MemoryColumn> &getColumns() const override;
+
+	std::size_t size() const override;
+
+	std::int64_t getInt64(std::size_t row, std::size_t column) const override;
+
+	double getDouble(std::size_t row, std::size_t column) const override;
+
+	std::string_view getText(std::size_t row, std::size_t column) const override;
+
+protected:
+	/** Only the pointer matching the column type is set */
+	struct Values {
+		const std::vector<std::int64_t> *int64s  = nullptr;
+		const std::vector<double>       *doubles = nullptr;
+		const std::vector<std::string>  *texts   = nullptr;
+	};
+
+	void addColumn(const std::string &name, types::typeId type, bool sorted, std::size_t columnSize, Values values);
+
+	std::vector<MemoryColumn>  columns;
+	std::vector<Values>        values;
+	std::size_t                rows = 0;
+};
+
+/** @} */
+
+}
+}
+
+#endif /* INCLUDE_ECS_DATABASE_MEMORYTABLE_HPP_ */
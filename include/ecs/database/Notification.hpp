@@ -0,0 +1,55 @@
+/*
+ * Notification.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef INCLUDE_ECS_DATABASE_NOTIFICATION_HPP_
+#define INCLUDE_ECS_DATABASE_NOTIFICATION_HPP_
+
+#include <ecs/config.hpp>
+#include <functional>
+#include <string>
+
+namespace ecs {
+namespace db3 {
+
+/** @addtogroup ecsdb
+ * @{
+ */
+
+/** Asynchronous notification sent by the database server to
+ * the listeners of a channel (e.g. NOTIFY in postgres).
+ */
+struct ECS_EXPORT Notification {
+	std::string channel;
+	std::string payload;
+	/** Process id of the server process which sent the notification */
+	int         processId = 0;
+};
+
+using notificationListener_T = std::function<void(const Notification&)>;
+
+/** @} */
+
+}
+}
+
+#endif /* INCLUDE_ECS_DATABASE_NOTIFICATION_HPP_ */
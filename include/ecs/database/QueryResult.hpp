@@ -28,6 +28,8 @@
 #include <string>
 #include <memory>
 #include <iterator>
+#include <future>
+#include <vector>
 #include <ecs/database/Table.hpp>
 #include <ecs/database/Row.hpp>
 
@@ -117,6 +119,19 @@ public:
 	 * because the result table is moved.
 	 */
 	TableResult fetchAll();
+
+	/** Fetch all results and store the text values of the named
+	 * columns in a dictionary of the table. Use this for large results
+	 * where the columns have few distinct values. The encoded columns
+	 * are read with TableResult::getText(). Throws when a column does
+	 * not exist.
+	 */
+	TableResult fetchAll(const std::vector<std::string> &encodedColumns);
+
+	/** Fetch all rows on the worker thread of the connection.
+	 * The result is moved into the task and is invalid afterwards.
+	 */
+	std::future<TableResult> fetchAllAsync();
 protected:
 	/** Implementation details */
 	ResultImpl *impl;
@@ -0,0 +1,63 @@
+/*
+ * ResultCacheStatistics.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDE_ECS_DATABASE_RESULTCACHESTATISTICS_HPP_
+#define INCLUDE_ECS_DATABASE_RESULTCACHESTATISTICS_HPP_
+
+#include <ecs/config.hpp>
+#include <cstddef>
+#include <cstdint>
+
+namespace ecs {
+namespace db3 {
+
+/** @addtogroup ecsdb
+ * @{
+ */
+
+/** Snapshot of the query result cache of a connection. All
+ * values are zero when the backend has no result cache or when
+ * it is disabled in the connection parameters.
+ */
+struct ECS_EXPORT ResultCacheStatistics {
+	/** Byte budget of the cache */
+	std::size_t               capacity              = 0;
+	/** Estimated memory used by the cached results */
+	std::size_t               bytes                 = 0;
+	/** Number of cached results */
+	std::size_t               entries               = 0;
+	/** Executions answered from the cache */
+	std::uint64_t             hits                  = 0;
+	/** Cacheable executions which had to run the query */
+	std::uint64_t             misses                = 0;
+	/** Results removed because a referenced table changed */
+	std::uint64_t             invalidations         = 0;
+	/** Results removed to stay within the byte budget */
+	std::uint64_t             evictions             = 0;
+};
+
+/** @} */
+
+}
+}
+
+#endif /* INCLUDE_ECS_DATABASE_RESULTCACHESTATISTICS_HPP_ */
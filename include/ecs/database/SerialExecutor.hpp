@@ -0,0 +1,102 @@
+/*
+ * SerialExecutor.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDE_ECS_DATABASE_SERIALEXECUTOR_HPP_
+#define INCLUDE_ECS_DATABASE_SERIALEXECUTOR_HPP_
+
+#include <ecs/config.hpp>
+#include <ecs/PointerDefinitions.hpp>
+#include <functional>
+#include <future>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace ecs {
+namespace db3 {
+
+/** @addtogroup ecsdb
+ * @{
+ */
+
+/** Runs tasks one after another on a single worker thread. Every
+ * connection owns one executor so all asynchronous work of a
+ * connection is serialized and a statement is only used by one
+ * thread at a time.
+ *
+ * Tasks submitted from the worker thread itself are run
+ * immediately because waiting for them would never return.
+ */
+class ECS_EXPORT SerialExecutor {
+public:
+	POINTER_DEFINITIONS(SerialExecutor);
+
+	using task_T = std::function<void()>;
+
+	SerialExecutor();
+
+	/** Runs all queued tasks before the worker is stopped */
+	~SerialExecutor();
+
+	SerialExecutor(const SerialExecutor &executor) = delete;
+
+	SerialExecutor &operator=(const SerialExecutor &executor) = delete;
+
+	/** Queue a function and get a future for its return value.
+	 * Exceptions thrown by the function are rethrown by the future.
+	 */
+	template<typename F>
+	std::future<std::invoke_result_t<std::decay_t<F>>> submit(F &&function) {
+		using result_T = std::invoke_result_t<std::decay_t<F>>;
+
+		auto task   = std::make_shared<std::packaged_task<result_T()>>(std::forward<F>(function));
+		auto result = task->get_future();
+
+		post([task](){
+			(*task)();
+		});
+
+		return result;
+	}
+
+	/** Queue a task without a result. Exceptions are dropped. */
+	void post(task_T task);
+
+	/** True when called from the worker thread */
+	bool isWorkerThread() const;
+
+private:
+	struct State;
+
+	std::shared_ptr<State> state;
+	std::thread            worker;
+
+	static void run(std::shared_ptr<State> state);
+};
+
+/** @} */
+
+}
+}
+
+#endif /* INCLUDE_ECS_DATABASE_SERIALEXECUTOR_HPP_ */
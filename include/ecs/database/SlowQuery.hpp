@@ -0,0 +1,72 @@
+/*
+ * SlowQuery.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef INCLUDE_ECS_DATABASE_SLOWQUERY_HPP_
+#define INCLUDE_ECS_DATABASE_SLOWQUERY_HPP_
+
+#include <ecs/config.hpp>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace ecs {
+namespace db3 {
+
+/** @addtogroup ecsdb
+ * @{
+ */
+
+/** A statement which took longer than the slow query threshold of
+ * the connection parameters. The counters are those of the sqlite3
+ * statement status and only cover the slow execution.
+ */
+struct ECS_EXPORT SlowQuery {
+	/** Statement with the bound values inserted */
+	std::string                            sql;
+	std::chrono::nanoseconds               duration{0};
+	/** End of the execution */
+	std::chrono::system_clock::time_point  time;
+	/** Output of EXPLAIN QUERY PLAN with one line per step. Child
+	 * steps are indented by two spaces.
+	 */
+	std::string                            plan;
+	/** Rows visited by full table scans */
+	std::int64_t                           fullscanSteps  = 0;
+	/** Sort operations */
+	std::int64_t                           sorts          = 0;
+	/** Rows inserted into automatic indexes */
+	std::int64_t                           autoindexes    = 0;
+	/** Virtual machine operations */
+	std::int64_t                           vmSteps        = 0;
+};
+
+/** Receives the slow queries on a thread of the connection */
+using slowQuerySink_T = std::function<void(const SlowQuery&)>;
+
+/** @} */
+
+}
+}
+
+#endif /* INCLUDE_ECS_DATABASE_SLOWQUERY_HPP_ */
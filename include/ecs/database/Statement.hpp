@@ -30,6 +30,7 @@
 #include <string>
 #include <cstddef>
 #include <memory>
+#include <future>
 #include <vector>
 #include <streambuf>
 #include <istream>
@@ -58,6 +59,8 @@ class StatementInternals;
  * is an expensive operation so you should keep them and reset them if needed. 
  * 
  * A statement is not threadsafe so you must be sure to access a statement from one thread only. 
+ * While an asynchronous execution is running the statement belongs to the worker thread
+ * of its connection and every other access throws.
  */
 class ECS_EXPORT Statement : public std::enable_shared_from_this<Statement> {
 	friend class DbConnection;
@@ -85,6 +88,12 @@ public:
 
 	bool bind(float value);
 
+	/** Bound as native timestamp type of the backend */
+	bool bind(const ecs::time::Timestamp &value);
+
+	/** Bound as native uuid type of the backend */
+	bool bind(const ecs::tools::UUID &value);
+
 	bool bind(std::unique_ptr<std::basic_istream<char>> stream);
 
 	bool bind(const std::shared_ptr<std::basic_streambuf<char>> &stream);
@@ -112,6 +121,14 @@ public:
 	Result execute();
 	std::unique_ptr<Result> executePtr();
 
+	/** Execute the query on the worker thread of the connection.
+	 * Queries on different connections run concurrently while queries
+	 * on the same connection run one after another. Bind all values
+	 * before and do not use the statement until the future is ready.
+	 * Failures are thrown by the future.
+	 */
+	std::future<Result> executeAsync();
+
 	/** Get the last inserted row id. This may not be
 	 * implemented in every database plugin and may throw.
 	 * Thread safe for every connection.
@@ -144,10 +161,20 @@ protected:
 private:
 	StatementInternals *impl;
 
+	/** Throws when an asynchronous execution owns the statement
+	 * and the caller is not the worker thread.
+	 */
+	void checkOwner() const;
+
 	/** Fetch a single row from the result after calling
 	 * execute.
 	 */
 	Row::uniquePtr_T fetch();
+
+	/** Append all remaining rows to the table when the backend
+	 * supports fetching them at once. Returns false otherwise.
+	 */
+	bool fetchAll(TableBase &table);
 };
 
 /** @} */
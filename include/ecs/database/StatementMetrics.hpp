@@ -0,0 +1,210 @@
+/*
+ * StatementMetrics.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef INCLUDE_ECS_DATABASE_STATEMENTMETRICS_HPP_
+#define INCLUDE_ECS_DATABASE_STATEMENTMETRICS_HPP_
+
+#include <ecs/config.hpp>
+#include <ecs/PointerDefinitions.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ecs {
+namespace db3 {
+
+/** @addtogroup ecsdb
+ * @{
+ */
+
+class RowBase;
+
+/** Latency histogram with log-linear buckets like HdrHistogram. Values
+ * are nanoseconds. Every power of two is split into eight buckets so the
+ * reported values are at most 12.5% above the recorded ones. Values above
+ * 2^40 ns (about 18 minutes) are counted in the last bucket.
+ */
+class ECS_EXPORT LatencyHistogram {
+public:
+	static constexpr std::size_t subBucketBits  = 3;
+	static constexpr std::size_t subBuckets     = std::size_t(1) << subBucketBits;
+	static constexpr std::size_t maxExponent    = 40;
+	static constexpr std::size_t bucketCount    = 2 * subBuckets + (maxExponent - subBucketBits) * subBuckets;
+
+	using buckets_T = std::array<std::uint64_t, bucketCount>;
+
+	void record(std::uint64_t nanoseconds);
+
+	void merge(const LatencyHistogram &other);
+
+	/** Number of recorded values */
+	std::uint64_t getCount() const;
+
+	/** Sum of all recorded values in nanoseconds */
+	std::uint64_t getSum() const;
+
+	std::uint64_t getMax() const;
+
+	/** Value below or equal to which the given fraction (0.0 to 1.0) of
+	 * the recorded values are. Returns 0 when nothing was recorded.
+	 */
+	std::uint64_t percentile(double fraction) const;
+
+	/** Number of recorded values which are at most the given value. Values
+	 * are counted by the upper bound of their bucket.
+	 */
+	std::uint64_t countAtMost(std::uint64_t nanoseconds) const;
+
+	const buckets_T &getBuckets() const;
+
+	static std::size_t bucketIndex(std::uint64_t nanoseconds);
+
+	/** Largest value counted in the bucket */
+	static std::uint64_t bucketUpperBound(std::size_t index);
+
+protected:
+	friend class StatementMetrics;
+
+	buckets_T      buckets{};
+	std::uint64_t  count = 0;
+	std::uint64_t  sum   = 0;
+	std::uint64_t  max   = 0;
+};
+
+/** Counters of one normalized statement merged from all threads */
+struct ECS_EXPORT StatementStatistics {
+	/** Statement text with literals replaced by ? */
+	std::string       statement;
+	/** Number of prepared statements */
+	std::uint64_t     prepares            = 0;
+	/** Time spent preparing the statements */
+	std::uint64_t     prepareNanoseconds  = 0;
+	/** Bound parameters. Only recorded by the instrumented backend */
+	std::uint64_t     binds               = 0;
+	std::uint64_t     bindNanoseconds     = 0;
+	std::uint64_t     executions          = 0;
+	/** Failed executions and bindings */
+	std::uint64_t     errors              = 0;
+	/** Rows fetched from the results */
+	std::uint64_t     rows                = 0;
+	/** Estimated size of the fetched values */
+	std::uint64_t     bytes               = 0;
+	/** Retries because the database was locked by another connection */
+	std::uint64_t     busyRetries         = 0;
+	LatencyHistogram  execute;
+	/** Time of every single row fetch */
+	LatencyHistogram  fetch;
+};
+
+/** Collects the statement metrics of a connection. Every thread records
+ * into a shard of its own without locks or atomic read-modify-write
+ * operations. The shards are merged when the statistics are read so
+ * reading is expensive compared to recording.
+ *
+ * Statements are identified by their normalized text. Register the
+ * text once with getStatementId() and record with the returned id.
+ */
+class ECS_EXPORT StatementMetrics {
+public:
+	POINTER_DEFINITIONS(StatementMetrics);
+
+	using clock_T = std::chrono::steady_clock;
+
+	StatementMetrics();
+
+	StatementMetrics(const StatementMetrics&) = delete;
+
+	StatementMetrics &operator=(const StatementMetrics&) = delete;
+
+	virtual ~StatementMetrics();
+
+	/** Replace string and number literals by ? and collapse
+	 * whitespace so statements which only differ in their values
+	 * share the metrics.
+	 */
+	static std::string normalize(const std::string &query);
+
+	/** Get the id of the normalized query. This takes a lock so
+	 * it should be called once per prepared statement.
+	 */
+	std::size_t getStatementId(const std::string &query);
+
+	void recordPrepare(std::size_t statement, std::chrono::nanoseconds duration);
+
+	void recordBind(std::size_t statement, std::chrono::nanoseconds duration, bool succeeded);
+
+	void recordExecute(std::size_t statement, std::chrono::nanoseconds duration,
+			bool succeeded, std::uint64_t busyRetries);
+
+	/** Record a single fetch. The row count is 0 when the fetch
+	 * reached the end of the result.
+	 */
+	void recordFetch(std::size_t statement, std::chrono::nanoseconds duration,
+			std::uint64_t rows, std::uint64_t bytes, std::uint64_t busyRetries);
+
+	/** Size of the values in the row as they are transferred. Blobs
+	 * are streamed and not counted.
+	 */
+	static std::uint64_t estimateBytes(RowBase &row);
+
+	/** Merge the shards of all threads. Statements are sorted
+	 * by their text.
+	 */
+	std::vector<StatementStatistics> getStatistics() const;
+
+	/** Statistics in the Prometheus text exposition format */
+	std::string dumpPrometheus() const;
+
+private:
+	struct Counters;
+	struct Shard;
+
+	Counters &getCounters(std::size_t statement);
+
+	/** Unique for every instance. Threads find their shard by this id */
+	const std::uint64_t                       instance;
+
+	/** Expires with the instance so threads can drop their entries */
+	std::shared_ptr<const bool>               lifetime;
+
+	/** Shards of all threads which recorded into this instance */
+	std::atomic<Shard*>                       shards;
+
+	mutable std::mutex                        statementsMutex;
+	std::unordered_map<std::string, std::size_t> statementIds;
+	std::vector<std::string>                  statements;
+};
+
+/** @} */
+
+}
+}
+
+#endif /* INCLUDE_ECS_DATABASE_STATEMENTMETRICS_HPP_ */
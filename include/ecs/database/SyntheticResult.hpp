@@ -0,0 +1,57 @@
+/*
+ * SyntheticResult.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef INCLUDE_ECS_DATABASE_SYNTHETICRESULT_HPP_
+#define INCLUDE_ECS_DATABASE_SYNTHETICRESULT_HPP_
+
+#include <ecs/config.hpp>
+#include <ecs/database/types.hpp>
+#include <cstddef>
+#include <vector>
+
+namespace ecs {
+namespace db3 {
+
+/** @addtogroup ecsdb
+ * @{
+ */
+
+/** Result returned by every statement of the "null" backend. The
+ * values are generated from the row number: integers and timestamps
+ * are the row number, floating point values the row number plus 0.5
+ * and strings have textBytes characters. Uuid values are nil and
+ * null columns have no value. Blobs are not supported. The columns
+ * are named column0, column1 and so on.
+ */
+struct ECS_EXPORT SyntheticResult {
+	std::size_t                  rows      = 0;
+	std::vector<types::typeId>   columns;
+	std::size_t                  textBytes = 16;
+};
+
+/** @} */
+
+}
+}
+
+#endif /* INCLUDE_ECS_DATABASE_SYNTHETICRESULT_HPP_ */
@@ -29,6 +29,10 @@
 #include <memory>
 #include <iterator>
 #include <string>
+#include <string_view>
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
 #include <ecs/database/Row.hpp>
 #include <ostream>
 #include <ecs/PointerDefinitions.hpp>
@@ -63,6 +67,13 @@ public:
 	virtual const std::string &getColumnName(int n) const = 0;
 
 	virtual RowBase & at(int n) const;
+
+	/** Text of a string cell. Throws when the cell is not a string.
+	 * The view is valid as long as the table exists.
+	 */
+	virtual std::string_view getText(int row, int column) const;
+
+	virtual bool isEncoded(int column) const;
 };
 
 class ECS_EXPORT Table : public TableBase {
@@ -91,6 +102,53 @@ public:
 	
 	virtual const std::string &getColumnName(int n) const;
 
+	/** Code of NULL and of the values which are not text */
+	static constexpr std::uint32_t noCode = 0xffffffff;
+
+	/** Store the text values of the column as 32 bit codes into the
+	 * dictionary of the table so every distinct text is only stored
+	 * once. Use this for columns with few distinct values. The rows
+	 * already in the table are encoded as well.
+	 *
+	 * The cells of the column hold no value and have the type id
+	 * dictionary afterwards so they must be read with getText().
+	 * NULL and values which are not text are kept as they are.
+	 */
+	void encodeColumn(int column);
+
+	bool isEncoded(int column) const override;
+
+	std::string_view getText(int row, int column) const override;
+
+	/** Equal texts of the encoded columns have equal codes. Returns
+	 * noCode for NULL, for values which are not text and for
+	 * columns which are not encoded.
+	 */
+	std::uint32_t getCode(int row, int column) const;
+
+	std::string_view getDictionaryValue(std::uint32_t code) const;
+
+	/** Number of distinct texts of all encoded columns */
+	std::size_t getDictionarySize() const;
+
+protected:
+	struct EncodedColumn {
+		int                         column;
+		/** One code for every row of the table */
+		std::vector<std::uint32_t>  codes;
+	};
+
+	/** Replaces the text of the cell with a dictionary cell */
+	std::uint32_t encodeCell(types::cell_T &cell);
+
+	void encodeRow(RowBase &row);
+
+	const EncodedColumn *findEncoded(int column) const;
+
+	std::vector<EncodedColumn>                             encodedColumns;
+	/** Stable storage of the distinct texts indexed by their code */
+	std::deque<std::string>                                dictionary;
+	std::unordered_map<std::string_view, std::uint32_t>    dictionaryCodes;
 };
 
 class TableResult {
@@ -99,13 +157,13 @@ public:
 
 	TableResult(const TableResult &other) = delete;
 
-	TableResult(TableResult &&other) = delete;
+	TableResult(TableResult &&other) = default;
 
 	virtual ~TableResult();
 
 	TableResult &operator=(const TableResult &other) = delete;
 
-	TableResult &operator=(TableResult &&other) = delete;
+	TableResult &operator=(TableResult &&other) = default;
 
 	RowBase &at(int n) const;
 
@@ -113,6 +171,11 @@ public:
 
 	const std::string &getColumnName(int n) const;
 
+	/** Text of a string cell or of a dictionary encoded cell */
+	std::string_view getText(int row, int column) const;
+
+	bool isEncoded(int column) const;
+
 	operator bool() const;
 
 
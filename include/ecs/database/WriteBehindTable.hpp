@@ -0,0 +1,177 @@
+/*
+ * WriteBehindTable.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDE_ECS_DATABASE_WRITEBEHINDTABLE_HPP_
+#define INCLUDE_ECS_DATABASE_WRITEBEHINDTABLE_HPP_
+
+#include <ecs/config.hpp>
+#include <ecs/PointerDefinitions.hpp>
+#include <ecs/RingBuffer.hpp>
+#include <ecs/Signals.hpp>
+#include <ecs/database/Connection.hpp>
+#include <ecs/database/Statement.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace ecs {
+namespace db3 {
+
+/** @addtogroup ecsdb
+ * @{
+ */
+
+struct ECS_EXPORT WriteBehindStatistics {
+	/** Rows inserted and committed */
+	std::uint64_t rowsWritten  = 0;
+	/** Rows which failed to insert or whose transaction failed */
+	std::uint64_t rowsFailed   = 0;
+	/** Rows rejected by tryAppend because the buffer was full */
+	std::uint64_t rowsRejected = 0;
+	/** Number of committed transactions */
+	std::uint64_t flushes      = 0;
+	/** Message of the most recent failed insert or transaction
+	 * statement, empty when nothing failed so far.
+	 */
+	std::string   lastError;
+};
+
+/** Buffers rows for a single prepared INSERT and writes them from a
+ * background thread. Appending never waits for the database: rows
+ * go into a lock free ring buffer and are inserted in one transaction
+ * when batchSize rows are queued or at the latest after maxAge.
+ *
+ *     WriteBehindTable table(connection, "INSERT INTO samples(ts, value) VALUES(?, ?);");
+ *     table.append(ecs::time::Timestamp::now(), 0.5);
+ *
+ * The values must match one of the Statement::bind overloads. The
+ * connection should not be used by other threads because the rows
+ * are written inside transactions. Rows are not acknowledged, use
+ * flush() to wait until everything appended so far is committed.
+ *
+ * When drainOnTermination is set a SignalHandler is installed and a
+ * SIGTERM or SIGINT writes all queued rows and stops accepting rows.
+ */
+class ECS_EXPORT WriteBehindTable {
+public:
+	POINTER_DEFINITIONS(WriteBehindTable);
+
+	/** Binds the values of one row to the insert statement */
+	using row_T = std::function<void(Statement &statement)>;
+
+	WriteBehindTable(DbConnection::sharedPtr_T connection, const std::string &insertQuery,
+			std::size_t capacity = 65536, std::size_t batchSize = 1024,
+			std::chrono::milliseconds maxAge = std::chrono::milliseconds(100),
+			bool drainOnTermination = false);
+
+	/** Writes all queued rows before returning */
+	~WriteBehindTable();
+
+	WriteBehindTable(const WriteBehindTable &table) = delete;
+
+	WriteBehindTable &operator=(const WriteBehindTable &table) = delete;
+
+	/** Queue a row and wait while the buffer is full. Throws when
+	 * the table has been closed.
+	 */
+	template<typename ...TValues>
+	void append(TValues ...values) {
+		appendRow(makeRow(std::move(values)...));
+	}
+
+	/** Queue a row without waiting. Returns false when the buffer
+	 * is full or the table has been closed.
+	 */
+	template<typename ...TValues>
+	bool tryAppend(TValues ...values) {
+		return tryAppendRow(makeRow(std::move(values)...));
+	}
+
+	void appendRow(row_T row);
+
+	bool tryAppendRow(row_T row);
+
+	/** Block until every row appended before the call is written */
+	void flush();
+
+	/** Write all queued rows and stop accepting new ones */
+	void close();
+
+	bool isClosed() const;
+
+	WriteBehindStatistics getStatistics() const;
+
+protected:
+	template<typename ...TValues>
+	static row_T makeRow(TValues ...values) {
+		return [values...](Statement &statement) {
+			(statement.bind(values), ...);
+		};
+	}
+
+	DbConnection::sharedPtr_T                      connection;
+	Statement::sharedPtr_T                         statement;
+	ecs::tools::RingBuffer<row_T>                  buffer;
+	std::size_t                                    batchSize;
+	std::chrono::milliseconds                      maxAge;
+	std::unique_ptr<ecs::tools::SignalHandler>     signals;
+
+	std::atomic<bool>                              closed;
+	std::atomic<std::uint64_t>                     appended;
+	std::atomic<std::uint64_t>                     processed;
+	std::atomic<std::uint64_t>                     rowsWritten;
+	std::atomic<std::uint64_t>                     rowsFailed;
+	std::atomic<std::uint64_t>                     rowsRejected;
+	std::atomic<std::uint64_t>                     flushes;
+
+	std::mutex                                     mutex;
+	std::condition_variable                        wakeup;
+	std::condition_variable                        flushed;
+	bool                                           flushRequested;
+	bool                                           stop;
+	std::thread                                    worker;
+
+	/** Guards lastError which is written by the worker */
+	mutable std::mutex                             errorMutex;
+	std::string                                    lastError;
+
+	void run();
+
+	void setLastError(const std::exception &e);
+
+	/** Writes everything in the buffer, batchSize rows per transaction */
+	void writeRows();
+};
+
+/** @} */
+
+}
+}
+
+#endif /* INCLUDE_ECS_DATABASE_WRITEBEHINDTABLE_HPP_ */
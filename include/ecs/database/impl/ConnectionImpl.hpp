@@ -30,9 +30,20 @@
 #include <ecs/database/impl/StatementImpl.hpp>
 #include <ecs/database/Connection.hpp>
 #include <ecs/database/ConnectionParameters.hpp>
+#include <ecs/database/MaintenanceStatistics.hpp>
+#include <ecs/database/ResultCacheStatistics.hpp>
+#include <ecs/database/ChangeCapture.hpp>
+#include <ecs/database/Notification.hpp>
+#include <ecs/database/StatementMetrics.hpp>
+#include <ecs/database/IndexAdvice.hpp>
+#include <ecs/database/MemoryTable.hpp>
+#include <ecs/database/SerialExecutor.hpp>
 #include <ecs/Library.hpp>
+#include <ecs/Function.hpp>
 #include <memory>
 #include <mutex>
+#include <chrono>
+#include <functional>
 
 namespace ecs {
 namespace db3 {
@@ -86,6 +97,73 @@ public:
 
 	virtual void autocommit(bool);
 
+	/** Copy the main database of this connection into the destination
+	 * connection. The copy is done in steps of pagesPerStep pages and the
+	 * implementation sleeps between two steps so writers on the source
+	 * are only blocked for the duration of a single step. The progress
+	 * function receives the remaining and the total page count after every
+	 * step.
+	 *
+	 * The default implementation does not support backups and returns false.
+	 */
+	virtual bool backup(ConnectionImpl *destination, int pagesPerStep,
+			std::chrono::milliseconds sleep,
+			const std::function<void(int, int)> &progress);
+
+	/** Fill the statistics of the background maintenance. The
+	 * default implementation has no maintenance and leaves the
+	 * statistics untouched.
+	 */
+	virtual void getMaintenanceStatistics(MaintenanceStatistics &statistics);
+
+	/** Fill the statistics of the query result cache. The default
+	 * implementation has no cache and leaves the statistics untouched.
+	 */
+	virtual void getResultCacheStatistics(ResultCacheStatistics &statistics);
+
+	/** Make in-process data available as a table with the given
+	 * name. The default implementation does not support memory tables
+	 * and returns false.
+	 */
+	virtual bool registerTable(const std::string &name, MemoryTable::sharedPtr_T table);
+
+	/** Start collecting the rows changed by every transaction. The
+	 * function receives the changes of a transaction when it commits.
+	 * It is called while the database is locked so it must only queue
+	 * the batch. The default implementation does not support change
+	 * capture and returns false.
+	 */
+	virtual bool captureChanges(std::function<void(ChangeBatch&&)> publish);
+
+	/** Call the listener for every notification sent to the channel.
+	 * Listeners are called on a thread of the backend. The default
+	 * implementation does not support notifications and returns false.
+	 */
+	virtual bool listen(const std::string &channel, notificationListener_T listener);
+
+	/** Remove all listeners of the channel. The default implementation
+	 * does not support notifications and returns false.
+	 */
+	virtual bool unlisten(const std::string &channel);
+
+	/** Propose indexes for the captured workload ranked by the
+	 * estimated savings. The default implementation does not
+	 * capture a workload and returns false.
+	 */
+	virtual bool adviseIndexes(std::vector<IndexAdvice> &advice);
+
+	/** Metrics recorded at the backend boundary by a backend wrapping
+	 * another one. The default implementation returns an empty pointer.
+	 */
+	virtual StatementMetrics::sharedPtr_T getBackendMetrics() const;
+
+	/** True when the backend locks the whole database for the first
+	 * write of a transaction (sqlite3). Writers should then take the
+	 * lock when the transaction starts, otherwise two writers may
+	 * deadlock while upgrading their locks. The default returns false.
+	 */
+	virtual bool locksDatabaseOnWrite() const;
+
 	/** Get the implementation for the migrator. Plugin developers 
 	 * may provide their own migrator. Inside the plugin.
 	 */
@@ -95,10 +173,42 @@ public:
 	
 	void setErrorMessage(const std::string &message);
 
+	/** Worker thread of this connection which runs the asynchronous
+	 * statement executions. The thread is started on first use.
+	 */
+	SerialExecutor &getExecutor();
+
+	/** Add a subscriber for the committed changes. Change capture is
+	 * started with the first subscriber. Subscribers are called one
+	 * after another on a thread of their own.
+	 */
+	bool subscribeChanges(ecs::tools::Function<void(ChangeBatch&)> subscriber);
+
+	/** Start collecting statement metrics. This is called by the
+	 * plugin loader before the connection is used.
+	 */
+	void enableStatementMetrics();
+
+	/** Metrics shared by all statements of this connection. Empty
+	 * when the metrics are disabled.
+	 */
+	StatementMetrics::sharedPtr_T getStatementMetrics() const;
+
 protected:
 	std::mutex           errorMessageMutex;
 	std::string          errorMessage;
 	ConnectionParameters connectionParameters;
+
+private:
+	std::once_flag                   executorCreated;
+	std::unique_ptr<SerialExecutor>  executor;
+
+	struct ChangeFeed;
+
+	std::mutex                       changeFeedMutex;
+	std::shared_ptr<ChangeFeed>      changeFeed;
+
+	StatementMetrics::sharedPtr_T    statementMetrics;
 };
 
 /** @} */
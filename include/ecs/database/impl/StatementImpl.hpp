@@ -84,9 +84,25 @@ public:
 	 * more data to fetch from the query.
 	 */
 	virtual Row::uniquePtr_T fetch() = 0;
+
+	/** Append all remaining rows to the table at once. Implement
+	 * this when the backend can decode a whole result faster than
+	 * row by row. Returning false means that the rows are fetched
+	 * with fetch() instead which is what the default implementation
+	 * does.
+	 */
+	virtual bool fetchAll(TableBase &table);
+
+	/** Returns the number of retries because the database was busy
+	 * since the last call and resets the counter.
+	 */
+	std::uint64_t takeBusyRetries();
 protected:
 	/** Error string for last operation */
 	std::string dbErrorString;
+
+	/** Increment this on every retry of a busy database */
+	std::uint64_t busyRetries = 0;
 };
 
 /** @} */
@@ -11,7 +11,9 @@
 #include <ecs/database/impl/StatementImpl.hpp>
 #include <ecs/database/impl/DbConnectionImpl.hpp>
 #include <ecs/database/Connection.hpp>
+#include <ecs/database/StatementMetrics.hpp>
 #include <memory>
+#include <atomic>
 
 namespace ecs {
 namespace db3 {
@@ -51,6 +53,25 @@ public:
 	 * as well.
 	 */
 	std::vector<ecs::db3::types::cell_T::uniquePtr_T> bindings;
+
+	/** Number of asynchronous tasks queued for this statement
+	 * on the worker thread of the connection.
+	 */
+	std::atomic<int> pendingTasks{0};
+
+	/** Metrics of the connection or empty when they are
+	 * disabled. The id identifies the normalized query.
+	 */
+	StatementMetrics::sharedPtr_T metrics;
+	std::size_t                   metricsId = 0;
+};
+
+/** Releases the statement when an asynchronous task has finished */
+struct PendingTask {
+	explicit PendingTask(std::atomic<int> &counter) : counter(counter) {}
+	~PendingTask() { counter--; }
+
+	std::atomic<int> &counter;
 };
 
 }
@@ -0,0 +1,153 @@
+/*
+ * Instrumented.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef INCLUDE_ECS_DATABASE_INSTRUMENTED_INSTRUMENTED_HPP_
+#define INCLUDE_ECS_DATABASE_INSTRUMENTED_INSTRUMENTED_HPP_
+
+#include <ecs/config.hpp>
+#include <ecs/database/impl/ConnectionImpl.hpp>
+#include <ecs/database/impl/StatementImpl.hpp>
+#include <ecs/database/StatementMetrics.hpp>
+#include <ecs/Library.hpp>
+
+namespace ecs {
+namespace db3 {
+
+/** @addtogroup ecsdb
+ * @{
+ */
+
+/** Forwards every call to the statement of the wrapped backend and
+ * records the time spent in it.
+ */
+class InstrumentedStatement : public StatementImpl {
+public:
+	InstrumentedStatement(StatementImpl::sharedPtr_T statement,
+			StatementMetrics::sharedPtr_T metrics, std::size_t metricsId);
+
+	virtual ~InstrumentedStatement();
+
+	int execute(Table *table) final override;
+
+	bool bind(ecs::db3::types::cell_T *parameter, const std::string *parameterName, int n) final override;
+
+	std::int64_t lastInsertId() final override;
+
+	void reset() final override;
+
+	void clearBindings() final override;
+
+	int getStatus() const final override;
+
+	Row::uniquePtr_T fetch() final override;
+
+	bool fetchAll(TableBase &table) final override;
+
+protected:
+	/** Take over the error string and the busy retries of the
+	 * wrapped statement after every call.
+	 */
+	void update();
+
+	StatementImpl::sharedPtr_T     statement;
+	StatementMetrics::sharedPtr_T  metrics;
+	std::size_t                    metricsId;
+};
+
+/** Backend wrapping the backend set with
+ * ConnectionParameters::setWrappedBackend(). It is selected with the
+ * backend name "instrumented" so any backend can be measured without
+ * changing the application. Every call is forwarded unchanged.
+ */
+class ECS_EXPORT InstrumentedConnection : public ConnectionImpl {
+public:
+	InstrumentedConnection();
+
+	virtual ~InstrumentedConnection();
+
+	std::string getPluginVersion();
+
+	std::string getPluginDescription();
+
+	std::string getPluginAuthor();
+
+	std::string getPluginName();
+
+	/** Loads and connects the wrapped backend */
+	bool connect(const ConnectionParameters &parameters) final override;
+
+	bool disconnect() final override;
+
+	bool execute(const std::string &query) final override;
+
+	StatementImpl::ptr_T prepare(const std::string &query) final override;
+
+	void startTransation() final override;
+
+	void commitTransaction() final override;
+
+	void rollbackTransaction() final override;
+
+	void autocommit(bool enabled) final override;
+
+	/** An instrumented destination is replaced by its wrapped backend */
+	bool backup(ConnectionImpl *destination, int pagesPerStep,
+			std::chrono::milliseconds sleep,
+			const std::function<void(int, int)> &progress) final override;
+
+	void getMaintenanceStatistics(MaintenanceStatistics &statistics) final override;
+
+	void getResultCacheStatistics(ResultCacheStatistics &statistics) final override;
+
+	bool registerTable(const std::string &name, MemoryTable::sharedPtr_T table) final override;
+
+	bool captureChanges(std::function<void(ChangeBatch&&)> publish) final override;
+
+	bool listen(const std::string &channel, notificationListener_T listener) final override;
+
+	bool unlisten(const std::string &channel) final override;
+
+	bool adviseIndexes(std::vector<IndexAdvice> &advice) final override;
+
+	StatementMetrics::sharedPtr_T getBackendMetrics() const final override;
+
+	bool locksDatabaseOnWrite() const final override;
+
+	ecs::db3::MigratorImpl* getMigrator(DbConnection *connection) final override;
+
+protected:
+	/** Take over the error message of the wrapped backend when
+	 * the call failed.
+	 */
+	bool forward(bool succeeded);
+
+	ecs::dynlib::Class<ConnectionImpl>  backend;
+	StatementMetrics::sharedPtr_T       metrics;
+};
+
+/** @} */
+
+}
+}
+
+#endif /* INCLUDE_ECS_DATABASE_INSTRUMENTED_INSTRUMENTED_HPP_ */
@@ -68,6 +68,8 @@ public:
 		std::mutex             connectionMutex;
 		unsigned int           connectionTimout;
 		std::thread::id        threadId;
+		/** Fetch temporal and BINARY(16) columns as native cells */
+		bool                   nativeTimestamps;
 	};
 
 	MariaDBConnection();
@@ -144,7 +146,8 @@ public:
 			std::int64_t,
 			std::uint64_t,
 			float,
-			double> values;
+			double,
+			MYSQL_TIME> values;
 		MYSQL_BIND    *binding;
 		unsigned long  length;
 		my_bool        isnull;
@@ -0,0 +1,123 @@
+/*
+ * Null.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef INCLUDE_ECS_DATABASE_NULL_NULL_HPP_
+#define INCLUDE_ECS_DATABASE_NULL_NULL_HPP_
+
+#include <ecs/config.hpp>
+#include <ecs/database/impl/ConnectionImpl.hpp>
+#include <ecs/database/impl/StatementImpl.hpp>
+#include <ecs/database/SyntheticResult.hpp>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ecs {
+namespace db3 {
+
+/** @addtogroup ecsdb
+ * @{
+ */
+
+/** Shared by the connection and its statements */
+struct NullResultSource {
+	SyntheticResult             result;
+	/** Value of every string column */
+	std::string                 text;
+	std::vector<std::string>    columnNames;
+	/** Incremented by every execution */
+	std::atomic<std::int64_t>   executions{0};
+};
+
+/** Returns the synthetic result of the connection parameters and
+ * ignores all bindings.
+ */
+class NullStatement : public StatementImpl {
+public:
+	explicit NullStatement(std::shared_ptr<NullResultSource> source);
+
+	virtual ~NullStatement();
+
+	int execute(Table *table) final override;
+
+	bool bind(ecs::db3::types::cell_T *parameter, const std::string *parameterName, int n) final override;
+
+	/** Number of executions on the connection until the last
+	 * execution of this statement.
+	 */
+	std::int64_t lastInsertId() final override;
+
+	void reset() final override;
+
+	void clearBindings() final override;
+
+	Row::uniquePtr_T fetch() final override;
+
+protected:
+	std::shared_ptr<NullResultSource>  source;
+	/** Next row to fetch */
+	std::size_t                        position;
+	std::int64_t                       insertId;
+};
+
+/** Backend without a database. Every statement succeeds and returns
+ * the result set with ConnectionParameters::setSyntheticResult() so
+ * the cost of the library can be measured without any I/O.
+ */
+class ECS_EXPORT NullConnection : public ConnectionImpl {
+public:
+	NullConnection();
+
+	virtual ~NullConnection();
+
+	std::string getPluginVersion();
+
+	std::string getPluginDescription();
+
+	std::string getPluginAuthor();
+
+	std::string getPluginName();
+
+	/** Fails for column types which can not be generated */
+	bool connect(const ConnectionParameters &parameters) final override;
+
+	bool disconnect() final override;
+
+	bool execute(const std::string &query) final override;
+
+	StatementImpl::ptr_T prepare(const std::string &query) final override;
+
+	/** There is no schema so no migrator is provided */
+	ecs::db3::MigratorImpl* getMigrator(DbConnection *connection) final override;
+
+protected:
+	std::shared_ptr<NullResultSource>  source;
+};
+
+/** @} */
+
+}
+}
+
+#endif /* INCLUDE_ECS_DATABASE_NULL_NULL_HPP_ */
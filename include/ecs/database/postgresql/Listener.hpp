@@ -0,0 +1,135 @@
+/*
+ * Listener.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef INCLUDE_ECS_DATABASE_POSTGRESQL_LISTENER_HPP_
+#define INCLUDE_ECS_DATABASE_POSTGRESQL_LISTENER_HPP_
+
+#include <ecs/database/Notification.hpp>
+#include <ecs/RingBuffer.hpp>
+#include <libpq-fe.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ecs {
+namespace db3 {
+
+/** Receives LISTEN/NOTIFY notifications on a connection of its own.
+ * The listener thread sleeps in epoll on the socket of the connection
+ * and drains all notifications as soon as data arrives. They are
+ * handed over to the dispatcher thread through a lock free queue so
+ * slow listeners never keep the socket from being read.
+ *
+ * The connection is reset and all channels are listened again when
+ * the server connection is lost.
+ */
+class PostgresqlListener {
+public:
+	/** Opens the connection and starts the threads. Throws when the
+	 * connection can not be opened.
+	 */
+	PostgresqlListener(const std::string &connectionString, std::size_t queueSize = 4096);
+
+	~PostgresqlListener();
+
+	PostgresqlListener(const PostgresqlListener &) = delete;
+	PostgresqlListener &operator=(const PostgresqlListener &) = delete;
+
+	/** Adds a listener. The first listener of a channel runs LISTEN
+	 * and the function returns when the server confirmed it. Throws
+	 * on failure.
+	 */
+	void listen(const std::string &channel, notificationListener_T listener);
+
+	/** Removes the listeners and runs UNLISTEN. Throws on failure. */
+	void unlisten(const std::string &channel);
+
+protected:
+	/** LISTEN or UNLISTEN which must run on the listener thread
+	 * because a libpq connection must only be used by one thread.
+	 */
+	struct Command {
+		bool                listen;
+		std::string         channel;
+		std::promise<void>  done;
+	};
+
+	void run();
+
+	void dispatch();
+
+	/** Queues the command and waits until it was executed */
+	void execute(bool listen, const std::string &channel);
+
+	void runCommands();
+
+	/** Used while the connection is broken */
+	void failCommands();
+
+	void runCommand(bool listen, const std::string &channel);
+
+	/** Reads the socket and queues all notifications. Returns false
+	 * when the connection is broken.
+	 */
+	bool receive();
+
+	bool reconnect();
+
+	void watchSocket();
+
+	void wakeup();
+
+	PGconn                                                      *connection;
+	int                                                          epollFd;
+	int                                                          wakeupFd;
+	int                                                          socket;
+
+	std::mutex                                                   mutex;
+	std::deque<Command>                                          commands;
+	std::map<std::string, std::vector<notificationListener_T>>   listeners;
+
+	ecs::tools::RingBuffer<Notification>                         queue;
+	std::mutex                                                   dispatchMutex;
+	std::condition_variable                                      dispatchWakeup;
+	/** Signalled by the dispatcher when the listener thread waits
+	 * for a free slot in the queue.
+	 */
+	std::condition_variable                                      spaceAvailable;
+	std::atomic<bool>                                            producerWaiting;
+
+	std::atomic<bool>                                            stop;
+	std::thread                                                  listenerThread;
+	std::thread                                                  dispatcherThread;
+};
+
+}
+}
+
+#endif /* INCLUDE_ECS_DATABASE_POSTGRESQL_LISTENER_HPP_ */
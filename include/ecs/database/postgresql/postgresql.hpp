@@ -25,12 +25,14 @@
 #include <ecs/database/impl/ConnectionImpl.hpp>
 #include <ecs/database/impl/StatementImpl.hpp>
 #include <ecs/database/types.hpp>
+#include <ecs/database/postgresql/Listener.hpp>
 #include <postgres.h>
 #include <libpq-fe.h>
 #include <catalog/pg_type.h>
 #include <vector>
 #include <list>
 #include <string>
+#include <string_view>
 #include <ecs/UUID.hpp>
 #include <algorithm>
 #include <memory>
@@ -49,12 +51,21 @@ class PostgresqlStatement : public StatementImpl {
 public:
 	static void PGresultDeleter(PGresult *obj);
 
-	PostgresqlStatement(PGconn *connection, const std::string &query);
+	/** Timestamp, date and uuid columns are only returned as native
+	 * cells with nativeTimestamps. Otherwise they are strings.
+	 */
+	PostgresqlStatement(PGconn *connection, const std::string &query,
+			bool nativeTimestamps = false);
 
 	virtual ~PostgresqlStatement();
 
 	Row::uniquePtr_T fetch();
 
+	/** Large results are split into row ranges which are decoded
+	 * by the decode workers and the calling thread at once.
+	 */
+	bool fetchAll(TableBase &table) override;
+
 	virtual int execute(Table *resultTable);
 
 	virtual bool bind(ecs::db3::types::cell_T *parameter, const std::string *parameterName, int n);
@@ -67,6 +78,42 @@ public:
 	virtual void clearBindings();
 
 protected:
+	/** Microseconds between the unix epoch and 2000-01-01 which
+	 * is the epoch of binary timestamps in postgres.
+	 */
+	static constexpr std::int64_t postgresEpochOffset = 946684800000000LL;
+
+	/** Timestamps which can not be parsed like infinity are
+	 * returned as string.
+	 */
+	static void fetchTimestamp(Row &row, std::string_view text);
+
+	static void fetchUuid(Row &row, std::string_view text);
+
+	/** Decoding of a result column chosen once per execution */
+	enum class Column {
+		integer,
+		floating,
+		timestamp,
+		uuid,
+		text,
+		boolean,
+		unsupported
+	};
+
+	/** Results with fewer cells are decoded by the calling thread
+	 * only. Every worker decodes at least this many cells.
+	 */
+	static constexpr std::size_t parallelCells = 16384;
+
+	static Column getColumn(Oid type, bool nativeTimestamps);
+
+	/** Decode a row of the result with the plan of the execution.
+	 * Returns false when a column is not supported. The result is
+	 * only read so several threads can decode rows at once.
+	 */
+	bool decodeRow(int rowNumber, Row &row) const;
+
 	std::unique_ptr<PGresult, decltype(&PGresultDeleter)> result;
 
 	/** Connection context. Never end this connection
@@ -78,6 +125,9 @@ protected:
 	std::list<ecs::db3::types::cell_T*>  bindings;
 	/** Full query string */
 	std::string                          query;
+	/** Decoding of every result column */
+	std::vector<Column>                  plan;
+	const bool                           nativeTimestamps;
 
 	int iRow;
 };
@@ -104,8 +154,31 @@ public:
 
 	bool disconnect();
 
+	void startTransation() final override;
+
+	void commitTransaction() final override;
+
+	void rollbackTransaction() final override;
+
+	/** Notifications are received by a listener with a connection
+	 * of its own which is opened with the first listen.
+	 */
+	bool listen(const std::string &channel, notificationListener_T listener);
+
+	bool unlisten(const std::string &channel);
+
 protected:
 	PGconn *connection;
+	bool    nativeTimestamps;
+
+	/** Options the connection was opened with */
+	std::string                          connectionString;
+
+	std::mutex                           listenerMutex;
+	std::unique_ptr<PostgresqlListener>  listener;
+
+	/** Runs a transaction control statement and throws on failure */
+	void executeTransactionQuery(const char *query);
 };
 
 }
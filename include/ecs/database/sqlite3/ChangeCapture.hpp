@@ -0,0 +1,87 @@
+/*
+ * ChangeCapture.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef INCLUDE_ECS_DATABASE_SQLITE3_CHANGECAPTURE_HPP_
+#define INCLUDE_ECS_DATABASE_SQLITE3_CHANGECAPTURE_HPP_
+
+#include <ecs/database/sqlite3/sqlite3.h>
+#include <ecs/database/ChangeCapture.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ecs {
+namespace db3 {
+
+enum class Sqlite3Savepoint {
+	none,
+	begin,
+	release,
+	rollback
+};
+
+/** Collects the changed rows of the running transaction and
+ * publishes them as one batch when the transaction commits. Changes
+ * undone by a rollback or by rolling back to a savepoint are dropped.
+ *
+ * All functions are called from the hooks of the connection while
+ * the database mutex is held so there is no locking of its own.
+ */
+class Sqlite3ChangeCapture {
+public:
+	using publish_T = std::function<void(ChangeBatch&&)>;
+
+	explicit Sqlite3ChangeCapture(publish_T publish);
+
+	Sqlite3ChangeCapture(const Sqlite3ChangeCapture &) = delete;
+	Sqlite3ChangeCapture &operator=(const Sqlite3ChangeCapture &) = delete;
+
+	/** Records a row change. The old and new values are read from
+	 * the preupdate hook when a connection is given.
+	 */
+	void record(sqlite3 *connection, int operation, const char *database, const char *table,
+			sqlite3_int64 oldRowid, sqlite3_int64 newRowid);
+
+	void savepoint(Sqlite3Savepoint operation, const std::string &name);
+
+	void commit();
+
+	void rollback();
+
+protected:
+	static types::cell_T value(sqlite3_value *value);
+
+	publish_T                                          publish;
+	std::vector<ChangeEvent>                           events;
+	/** Name and number of recorded events for every open savepoint */
+	std::vector<std::pair<std::string, std::size_t>>   savepoints;
+	std::uint64_t                                      sequence;
+};
+
+}
+}
+
+#endif /* INCLUDE_ECS_DATABASE_SQLITE3_CHANGECAPTURE_HPP_ */
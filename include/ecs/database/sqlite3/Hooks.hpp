@@ -0,0 +1,131 @@
+/*
+ * Hooks.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef INCLUDE_ECS_DATABASE_SQLITE3_HOOKS_HPP_
+#define INCLUDE_ECS_DATABASE_SQLITE3_HOOKS_HPP_
+
+#include <ecs/database/sqlite3/sqlite3.h>
+#include <ecs/database/sqlite3/ChangeCapture.hpp>
+#include <ecs/database/sqlite3/ResultCache.hpp>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ecs {
+namespace db3 {
+
+/** Tables and operations of a statement as reported by the
+ * authorizer while the statement is prepared. Tables are named
+ * "database.table" like "main.items".
+ */
+struct Sqlite3QueryAccess {
+	std::vector<std::string> reads;
+	std::vector<std::string> writes;
+	/** False when the result depends on more than the table contents
+	 * like random(), the current time, pragmas or memory tables.
+	 */
+	bool                     deterministic  = true;
+	/** True for statements which may change any result like CREATE,
+	 * DROP, ALTER or ROLLBACK TO.
+	 */
+	bool                     invalidatesAll = false;
+	Sqlite3Savepoint         savepoint      = Sqlite3Savepoint::none;
+	std::string              savepointName;
+};
+
+/** Owns the update, preupdate, commit and rollback hooks of a
+ * connection. A connection has only one hook of every kind so the
+ * changes are forwarded from here to the result cache and to the
+ * change capture. The statements share this object and report the
+ * statements they executed.
+ */
+class Sqlite3Hooks {
+public:
+	/** The result cache is optional */
+	Sqlite3Hooks(sqlite3 *connection, std::shared_ptr<Sqlite3ResultCache> resultCache);
+
+	Sqlite3Hooks(const Sqlite3Hooks &) = delete;
+	Sqlite3Hooks &operator=(const Sqlite3Hooks &) = delete;
+
+	/** Removes the hooks. Must be called before the connection is
+	 * closed because statements may keep this object alive.
+	 */
+	void detach();
+
+	const std::shared_ptr<Sqlite3ResultCache> &getResultCache() const;
+
+	/** Starts the change capture. Replaces a running capture. */
+	void captureChanges(Sqlite3ChangeCapture::publish_T publish);
+
+	/** True once the change capture was started */
+	bool isCapturing() const;
+
+	/** Statements only need the authorizer with a result cache or
+	 * a running change capture.
+	 */
+	bool isActive() const;
+
+	/** Prepares the statement with an authorizer which records the
+	 * tables and operations of the statement.
+	 */
+	int prepare(const std::string &query, sqlite3_stmt **stmt, const char **tail,
+			Sqlite3QueryAccess &access);
+
+	/** Records the access of a statement prepared without the
+	 * authorizer by preparing its query once more.
+	 */
+	void classify(sqlite3_stmt *stmt, Sqlite3QueryAccess &access);
+
+	/** Called after a statement was executed */
+	void executed(const Sqlite3QueryAccess &access, bool succeeded);
+
+protected:
+	struct AuthorizerContext {
+		Sqlite3Hooks       *hooks;
+		Sqlite3QueryAccess *access;
+	};
+
+	static int authorizer(void *data, int action, const char *argument1, const char *argument2,
+			const char *database, const char *trigger);
+
+	static void updateHook(void *data, int operation, const char *database, const char *table,
+			sqlite3_int64 rowid);
+
+	static void preupdateHook(void *data, sqlite3 *connection, int operation, const char *database,
+			const char *table, sqlite3_int64 oldRowid, sqlite3_int64 newRowid);
+
+	static int commitHook(void *data);
+
+	static void rollbackHook(void *data);
+
+	sqlite3                               *connection;
+	std::shared_ptr<Sqlite3ResultCache>    resultCache;
+	std::unique_ptr<Sqlite3ChangeCapture>  capture;
+	std::atomic<bool>                      capturing;
+};
+
+}
+}
+
+#endif /* INCLUDE_ECS_DATABASE_SQLITE3_HOOKS_HPP_ */
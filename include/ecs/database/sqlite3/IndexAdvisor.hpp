@@ -0,0 +1,96 @@
+/*
+ * IndexAdvisor.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef INCLUDE_ECS_DATABASE_SQLITE3_INDEXADVISOR_HPP_
+#define INCLUDE_ECS_DATABASE_SQLITE3_INDEXADVISOR_HPP_
+
+#include <ecs/database/sqlite3/sqlite3.h>
+#include <ecs/database/sqlite3/QueryLog.hpp>
+#include <ecs/database/IndexAdvice.hpp>
+#include <cstddef>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ecs {
+namespace db3 {
+
+/** Proposes indexes for statements which scan tables. The schema of
+ * the connection is copied into a private in-memory database where
+ * every column read by a statement is tried as index. An index is
+ * proposed when the query planner uses it to search the table instead
+ * of scanning it. Equality columns used together by the planner are
+ * combined into one index.
+ *
+ * The private database has no statistics so the planner assumes large
+ * tables and prefers indexes more than with the real data.
+ */
+class Sqlite3IndexAdvisor {
+public:
+	/** Throws std::runtime_error when the schema can not be copied */
+	explicit Sqlite3IndexAdvisor(sqlite3 *connection);
+
+	Sqlite3IndexAdvisor(const Sqlite3IndexAdvisor &) = delete;
+	Sqlite3IndexAdvisor &operator=(const Sqlite3IndexAdvisor &) = delete;
+
+	~Sqlite3IndexAdvisor();
+
+	/** Look for indexes which replace the table scans of the
+	 * statement. Statements which can not be prepared are ignored.
+	 */
+	void add(const Sqlite3WorkloadEntry &entry);
+
+	/** Proposed indexes with the highest savings first */
+	std::vector<IndexAdvice> getAdvice() const;
+
+protected:
+	/** Columns of the candidate index used by a search and if
+	 * the first column is compared for equality.
+	 */
+	struct Usage {
+		std::size_t  columns   = 0;
+		bool         equality  = false;
+	};
+
+	using columns_T = std::map<std::string, std::vector<std::string>>;
+
+	static int readAuthorizer(void *data, int action, const char *argument1, const char *argument2,
+			const char *database, const char *trigger);
+
+	/** Columns read by the statement grouped by table */
+	bool readColumns(const std::string &query, columns_T &columns);
+
+	Usage evaluate(const std::string &query, const std::string &table, const std::vector<std::string> &columns);
+
+	void propose(const std::string &table, const std::vector<std::string> &columns,
+			std::uint64_t savedSteps, const std::string &query);
+
+	sqlite3                                                            *whatIf;
+	std::map<std::pair<std::string, std::vector<std::string>>, IndexAdvice>  advice;
+};
+
+}
+}
+
+#endif /* INCLUDE_ECS_DATABASE_SQLITE3_INDEXADVISOR_HPP_ */
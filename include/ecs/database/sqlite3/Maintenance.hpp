@@ -0,0 +1,119 @@
+/*
+ * Maintenance.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDE_ECS_DATABASE_SQLITE3_MAINTENANCE_HPP_
+#define INCLUDE_ECS_DATABASE_SQLITE3_MAINTENANCE_HPP_
+
+#include <ecs/database/sqlite3/sqlite3.h>
+#include <ecs/database/MaintenanceStatistics.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace ecs {
+namespace db3 {
+
+/** Runs WAL checkpoints and the incremental vacuum of a sqlite3
+ * database on a background thread. The automatic checkpoint of the
+ * observed connection is replaced by a WAL hook which only records
+ * the WAL size so a commit never pays for a checkpoint.
+ *
+ * The thread uses its own connection to the database file. A
+ * PASSIVE checkpoint is started when the WAL reached the page limit
+ * or when no commit happened for the idle time. The incremental vacuum
+ * only runs when the database is idle because it needs the write lock.
+ */
+class Sqlite3Maintenance {
+public:
+	/** Installs the WAL hook on the connection and starts the
+	 * background thread. Throws when the maintenance connection
+	 * can not be opened.
+	 */
+	Sqlite3Maintenance(sqlite3 *connection, int checkpointPages,
+			std::chrono::milliseconds idleTime, int vacuumPages);
+
+	/** Stops the thread and restores the default automatic
+	 * checkpoint on the observed connection.
+	 */
+	~Sqlite3Maintenance();
+
+	Sqlite3Maintenance(const Sqlite3Maintenance &) = delete;
+	Sqlite3Maintenance &operator=(const Sqlite3Maintenance &) = delete;
+
+	void getStatistics(MaintenanceStatistics &statistics) const;
+
+protected:
+	static int walHook(void *data, sqlite3 *connection, const char *dbName, int pages);
+
+	void run();
+
+	void checkpoint(bool idle);
+
+	void incrementalVacuum();
+
+	std::int64_t now() const;
+
+	sqlite3                         *connection;
+	sqlite3                         *maintenanceConnection;
+	const int                        checkpointPages;
+	const std::chrono::milliseconds  idleTime;
+	const int                        vacuumPages;
+
+	std::mutex                       mutex;
+	std::condition_variable          wakeup;
+	bool                             stop;
+
+	/** Written by the WAL hook of the committing thread */
+	std::atomic<std::uint64_t>       walPages;
+	std::atomic<std::uint64_t>       maxWalPages;
+	std::atomic<std::uint64_t>       walPagesWritten;
+	std::atomic<std::int64_t>        lastCommit;
+	std::atomic<bool>                checkpointRequested;
+
+	/** Pages written into the WAL when the last checkpoint started */
+	std::atomic<std::uint64_t>       checkpointedWritten;
+	/** Commit time the last idle run was done for. Only used by
+	 * the maintenance thread.
+	 */
+	std::int64_t                     idleHandledCommit;
+
+	std::atomic<std::uint64_t>       checkpoints;
+	std::atomic<std::uint64_t>       sizeCheckpoints;
+	std::atomic<std::uint64_t>       idleCheckpoints;
+	std::atomic<std::uint64_t>       checkpointedFrames;
+	std::atomic<std::int64_t>        lastCheckpointDuration;
+	std::atomic<std::int64_t>        maxCheckpointDuration;
+	std::atomic<std::int64_t>        totalCheckpointDuration;
+	std::atomic<std::uint64_t>       vacuums;
+	std::atomic<std::uint64_t>       vacuumedPages;
+
+	std::thread                      thread;
+};
+
+}
+}
+
+#endif /* INCLUDE_ECS_DATABASE_SQLITE3_MAINTENANCE_HPP_ */
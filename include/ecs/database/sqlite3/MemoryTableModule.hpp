@@ -0,0 +1,117 @@
+/*
+ * MemoryTableModule.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDE_ECS_DATABASE_SQLITE3_MEMORYTABLEMODULE_HPP_
+#define INCLUDE_ECS_DATABASE_SQLITE3_MEMORYTABLEMODULE_HPP_
+
+#include <ecs/database/sqlite3/sqlite3.h>
+#include <ecs/database/MemoryTable.hpp>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace ecs {
+namespace db3 {
+
+/** Virtual table module which reads the rows of a MemoryTable.
+ * Every registered table is its own eponymous-only module so it can
+ * be used in queries without CREATE VIRTUAL TABLE.
+ *
+ * Equality and range constraints are passed into the module. On
+ * columns flagged as sorted they are resolved with a binary search,
+ * on the other columns the rows are filtered while scanning. The
+ * filters never drop rows SQLite would keep so SQLite still checks
+ * the constraints itself.
+ */
+class Sqlite3MemoryTableModule {
+public:
+	/** Register the table with the given name. An existing table
+	 * with the same name is replaced.
+	 */
+	static int registerTable(sqlite3 *connection, const std::string &name, MemoryTable::sharedPtr_T table);
+
+protected:
+	struct VirtualTable : sqlite3_vtab {
+		MemoryTable::sharedPtr_T table;
+	};
+
+	struct Filter {
+		std::size_t    column;
+		/** One of the SQLITE_INDEX_CONSTRAINT values */
+		unsigned char  op;
+		sqlite3_value *value;
+	};
+
+	struct Cursor : sqlite3_vtab_cursor {
+		MemoryTable  *table;
+		std::size_t   row;
+		std::size_t   end;
+		std::vector<Filter> filters;
+	};
+
+	/** True when values of the sqlite type can be compared
+	 * natively with values of the column type.
+	 */
+	static bool comparable(types::typeId type, int valueType);
+
+	/** Compare the column value of a row with a constraint value.
+	 * Returns false when both can not be compared natively, the
+	 * filter is skipped then.
+	 */
+	static bool compare(const MemoryTable *table, std::size_t row, std::size_t column,
+			sqlite3_value *value, int &result);
+
+	static bool matches(int comparison, unsigned char op);
+
+	static void moveToMatch(Cursor *cursor);
+
+	static void destroyModule(void *data);
+
+	static int xConnect(sqlite3 *connection, void *data, int argc, const char *const *argv,
+			sqlite3_vtab **vtab, char **error);
+
+	static int xDisconnect(sqlite3_vtab *vtab);
+
+	static int xBestIndex(sqlite3_vtab *vtab, sqlite3_index_info *info);
+
+	static int xOpen(sqlite3_vtab *vtab, sqlite3_vtab_cursor **cursor);
+
+	static int xClose(sqlite3_vtab_cursor *cursor);
+
+	static int xFilter(sqlite3_vtab_cursor *cursor, int idxNum, const char *idxStr,
+			int argc, sqlite3_value **argv);
+
+	static int xNext(sqlite3_vtab_cursor *cursor);
+
+	static int xEof(sqlite3_vtab_cursor *cursor);
+
+	static int xColumn(sqlite3_vtab_cursor *cursor, sqlite3_context *context, int column);
+
+	static int xRowid(sqlite3_vtab_cursor *cursor, sqlite3_int64 *rowid);
+
+	static const sqlite3_module module;
+};
+
+}
+}
+
+#endif /* INCLUDE_ECS_DATABASE_SQLITE3_MEMORYTABLEMODULE_HPP_ */
@@ -0,0 +1,179 @@
+/*
+ * Prefetch.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef INCLUDE_ECS_DATABASE_SQLITE3_PREFETCH_HPP_
+#define INCLUDE_ECS_DATABASE_SQLITE3_PREFETCH_HPP_
+
+#include <ecs/database/sqlite3/sqlite3.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ecs {
+namespace db3 {
+
+/** Raw values of rows copied by the prefetch thread. The rows are
+ * decoded on the fetching thread so the cells are allocated and freed
+ * by the same thread and only this dense buffer moves between the
+ * threads. The buffers are handed back and forth and reused.
+ */
+struct Sqlite3RowBatch {
+	struct Value {
+		/** Storage class of the value */
+		int                type;
+		/** Length of text and blob values */
+		int                bytes;
+		union {
+			sqlite3_int64  integer;
+			double         floating;
+			/** Position of text and blob values in data */
+			std::size_t    offset;
+		};
+	};
+
+	/** The values of all rows one row after another */
+	std::vector<Value>  values;
+	std::string         data;
+	std::size_t         rows = 0;
+
+	/** Keeps the memory for the next rows */
+	void clear();
+
+	/** Copy the current row of the statement */
+	void append(sqlite3_stmt *stmt, int columns);
+};
+
+/** Bounded queue of row batches between one producer and one
+ * consumer. The indices are atomics so nothing is locked while the
+ * queue is neither full nor empty. The mutex is only taken to sleep
+ * and to wake a sleeping side. A sleeping side is only woken once
+ * half of the queue can be taken or filled, so the threads do not
+ * switch for every batch.
+ */
+class Sqlite3RowQueue {
+public:
+	using batch_T = Sqlite3RowBatch;
+
+	explicit Sqlite3RowQueue(std::size_t depth);
+
+	Sqlite3RowQueue(const Sqlite3RowQueue &) = delete;
+
+	Sqlite3RowQueue &operator=(const Sqlite3RowQueue &) = delete;
+
+	/** Blocks while the queue is full. Returns false when the
+	 * consumer cancelled. The batch is swapped with a batch the
+	 * consumer is done with.
+	 */
+	bool push(batch_T &batch);
+
+	/** Blocks while the queue is empty. Returns false when the
+	 * producer closed the queue and all batches were taken. The
+	 * given batch is swapped in and reused by the producer.
+	 */
+	bool pop(batch_T &batch);
+
+	/** Called by the producer after the last batch */
+	void close();
+
+	/** Called by the consumer to stop the producer */
+	void cancel();
+
+	bool isCancelled() const;
+
+private:
+	template<typename P>
+	void wait(std::atomic<bool> &waiting, P ready);
+
+	void wake(std::atomic<bool> &waiting);
+
+	std::vector<batch_T>      slots;
+	const std::size_t         wakeBatches;
+	/** Number of taken batches. Only written by the consumer */
+	std::atomic<std::size_t>  head{0};
+	/** Number of pushed batches. Only written by the producer */
+	std::atomic<std::size_t>  tail{0};
+	std::atomic<bool>         closed{false};
+	std::atomic<bool>         cancelled{false};
+	std::atomic<bool>         producerWaiting{false};
+	std::atomic<bool>         consumerWaiting{false};
+	std::mutex                mutex;
+	std::condition_variable   condition;
+};
+
+/** Steps a statement on a thread of its own and copies the rows
+ * ahead of the consumer so the scan overlaps with the processing of
+ * the rows. The thread stops at the end of the result, on the first
+ * error or when the prefetcher is destroyed.
+ */
+class Sqlite3Prefetcher {
+public:
+	/** Called on the prefetch thread. Returns 1 and appends the
+	 * row to the batch while there are rows like
+	 * Sqlite3Statement::step().
+	 */
+	using step_T = std::function<int(Sqlite3RowBatch&)>;
+
+	Sqlite3Prefetcher(step_T step, std::size_t depth, std::size_t batchRows);
+
+	Sqlite3Prefetcher(const Sqlite3Prefetcher &) = delete;
+
+	Sqlite3Prefetcher &operator=(const Sqlite3Prefetcher &) = delete;
+
+	/** Stops the thread. The statement can be used afterwards */
+	~Sqlite3Prefetcher();
+
+	/** Batch holding the next row and the index of the row in
+	 * it. The batch is valid until the next call. Returns nullptr
+	 * at the end when the thread has finished. An exception thrown
+	 * on the thread is rethrown at the end instead.
+	 */
+	const Sqlite3RowBatch *next(std::size_t &row);
+
+	/** True when the process may run on more than one cpu so
+	 * the thread can step while the rows are processed.
+	 */
+	static bool hasSpareCpu();
+
+private:
+	void run();
+
+	step_T                     step;
+	const std::size_t          batchRows;
+	Sqlite3RowQueue            queue;
+	Sqlite3RowQueue::batch_T   current;
+	std::size_t                position = 0;
+	/** Set by the thread before it closes the queue */
+	std::exception_ptr         error;
+	std::thread                worker;
+};
+
+}
+}
+
+#endif /* INCLUDE_ECS_DATABASE_SQLITE3_PREFETCH_HPP_ */
@@ -0,0 +1,127 @@
+/*
+ * QueryLog.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef INCLUDE_ECS_DATABASE_SQLITE3_QUERYLOG_HPP_
+#define INCLUDE_ECS_DATABASE_SQLITE3_QUERYLOG_HPP_
+
+#include <ecs/database/sqlite3/sqlite3.h>
+#include <ecs/database/SlowQuery.hpp>
+#include <ecs/database/SerialExecutor.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ecs {
+namespace db3 {
+
+/** Statement status counters of one statement summed over all of its
+ * executions.
+ */
+struct Sqlite3WorkloadEntry {
+	/** Statement text with the parameters */
+	std::string    query;
+	std::uint64_t  executions     = 0;
+	std::uint64_t  fullscanSteps  = 0;
+	std::uint64_t  autoindexes    = 0;
+	std::uint64_t  vmSteps        = 0;
+};
+
+/** Times every statement of a connection with the profile trace and
+ * gives the slow ones to the sink. The trace can also capture the
+ * workload of statements which scan tables or build automatic indexes
+ * for the index advisor. The query plan of a slow query is explained
+ * inside the trace while the connection is locked, only the sink runs
+ * on a thread of its own.
+ *
+ * The time is measured by sqlite from the first step until the
+ * statement is done or reset so it includes the time the application
+ * spent between two fetches. The clock of sqlite has a resolution of
+ * one millisecond.
+ */
+class Sqlite3QueryLog {
+public:
+	/** Slow queries waiting for the sink before new ones are dropped */
+	static constexpr std::size_t maxPending = 1024;
+
+	/** Different statements in the captured workload */
+	static constexpr std::size_t maxWorkload = 4096;
+
+	/** Statements executed by the current thread while an instance
+	 * exists are not traced. Used for internal statements.
+	 */
+	struct Untraced {
+		Untraced();
+		~Untraced();
+	};
+
+	/** The slow query log is disabled without a sink */
+	Sqlite3QueryLog(sqlite3 *connection, std::chrono::nanoseconds threshold, slowQuerySink_T sink,
+			bool captureWorkload);
+
+	Sqlite3QueryLog(const Sqlite3QueryLog &) = delete;
+	Sqlite3QueryLog &operator=(const Sqlite3QueryLog &) = delete;
+
+	/** Removes the trace and waits for the queued slow queries. Must
+	 * be destroyed before the connection is closed.
+	 */
+	~Sqlite3QueryLog();
+
+	/** Number of slow queries dropped because the sink was too slow */
+	std::uint64_t getDropped() const;
+
+	bool isCapturingWorkload() const;
+
+	/** Statements which scanned a table or built an automatic index */
+	std::vector<Sqlite3WorkloadEntry> getWorkload() const;
+
+	/** EXPLAIN QUERY PLAN of the statement text with one line per
+	 * step. Child steps are indented by two spaces.
+	 */
+	static std::string explain(sqlite3 *connection, const std::string &query);
+
+protected:
+	static int trace(unsigned type, void *data, void *statement, void *value);
+
+	void profile(sqlite3_stmt *statement, sqlite3_int64 nanoseconds);
+
+	sqlite3                         *connection;
+	const std::chrono::nanoseconds   threshold;
+	slowQuerySink_T                  sink;
+	std::atomic<std::size_t>         pending;
+	std::atomic<std::uint64_t>       dropped;
+	const bool                       captureWorkload;
+	mutable std::mutex               workloadMutex;
+	std::unordered_map<std::string, Sqlite3WorkloadEntry> workload;
+	/** Destroyed first so the queued slow queries are delivered */
+	std::unique_ptr<SerialExecutor>  executor;
+};
+
+}
+}
+
+#endif /* INCLUDE_ECS_DATABASE_SQLITE3_QUERYLOG_HPP_ */
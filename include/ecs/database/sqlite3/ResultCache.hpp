@@ -0,0 +1,132 @@
+/*
+ * ResultCache.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef INCLUDE_ECS_DATABASE_SQLITE3_RESULTCACHE_HPP_
+#define INCLUDE_ECS_DATABASE_SQLITE3_RESULTCACHE_HPP_
+
+#include <ecs/database/ResultCacheStatistics.hpp>
+#include <ecs/database/Row.hpp>
+#include <ecs/database/types.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace ecs {
+namespace db3 {
+
+/** Materialized result of a query. The cells are copied for every
+ * execution which is answered from the cache.
+ */
+struct Sqlite3CachedResult {
+	std::vector<std::string>     columnNames;
+	std::vector<types::cell_T>   cells;
+	std::size_t                  rows  = 0;
+	std::vector<std::string>     tables;
+	std::size_t                  bytes = 0;
+
+	/** Copies the cells of the row. Returns false when a cell can not
+	 * be cached. Blobs are streams which can only be read once.
+	 */
+	bool append(RowBase &row);
+
+	Row::uniquePtr_T copyRow(std::size_t n) const;
+};
+
+/** Query result cache of a sqlite3 connection keyed by the SQL text
+ * and the bound parameters. The hooks of the connection remove cached
+ * results as soon as a table they read is changed through the
+ * connection. The least recently used results are evicted when the
+ * byte budget is exceeded.
+ *
+ * Changes made by other connections are not seen.
+ */
+class Sqlite3ResultCache {
+public:
+	explicit Sqlite3ResultCache(std::size_t capacity);
+
+	Sqlite3ResultCache(const Sqlite3ResultCache &) = delete;
+	Sqlite3ResultCache &operator=(const Sqlite3ResultCache &) = delete;
+
+	/** Counts a hit or a miss */
+	std::shared_ptr<const Sqlite3CachedResult> lookup(const std::string &key);
+
+	/** Changes whenever a result is invalidated. A result is only
+	 * stored when the version did not change while it was read.
+	 */
+	std::uint64_t getVersion() const;
+
+	void insert(const std::string &key, std::shared_ptr<const Sqlite3CachedResult> result,
+			std::uint64_t version);
+
+	void invalidate(const std::string &table);
+
+	void clear();
+
+	/** Memory tables can change without the update hook being called
+	 * so queries reading them are never cached.
+	 */
+	void addVolatileTable(const std::string &name);
+
+	bool isVolatileTable(const std::string &name) const;
+
+	std::size_t getCapacity() const;
+
+	void getStatistics(ResultCacheStatistics &statistics) const;
+
+protected:
+	struct Entry {
+		std::shared_ptr<const Sqlite3CachedResult> result;
+		std::list<std::string>::iterator           position;
+	};
+
+	/** Expects the mutex to be locked */
+	void remove(const std::string &key);
+
+	const std::size_t                                                capacity;
+
+	mutable std::mutex                                               mutex;
+	/** Most recently used key first */
+	std::list<std::string>                                           lru;
+	std::unordered_map<std::string, Entry>                           entries;
+	/** Keys of the cached results reading a table */
+	std::unordered_map<std::string, std::unordered_set<std::string>> tableKeys;
+	std::unordered_set<std::string>                                  volatileTables;
+	std::uint64_t                                                    version;
+	std::size_t                                                      bytes;
+
+	std::uint64_t                                                    hits;
+	std::uint64_t                                                    misses;
+	std::uint64_t                                                    invalidations;
+	std::uint64_t                                                    evictions;
+};
+
+}
+}
+
+#endif /* INCLUDE_ECS_DATABASE_SQLITE3_RESULTCACHE_HPP_ */
@@ -32,8 +32,15 @@
 #include <iostream>
 #include <memory>
 #include <thread>
+#include <mutex>
 #include <functional>
 #include <ecs/database/sqlite3/sqlite3.h>
+#include <ecs/database/sqlite3/Maintenance.hpp>
+#include <ecs/database/sqlite3/MemoryTableModule.hpp>
+#include <ecs/database/sqlite3/Hooks.hpp>
+#include <ecs/database/sqlite3/QueryLog.hpp>
+#include <ecs/database/sqlite3/IndexAdvisor.hpp>
+#include <ecs/database/sqlite3/Prefetch.hpp>
 #include <ecs/database/types.hpp>
 #include <ecs/database/impl/ConnectionImpl.hpp>
 #include <ecs/database/impl/StatementImpl.hpp>
@@ -71,16 +78,116 @@ public:
 		virtual Row::uniquePtr_T fetch(Sqlite3Statement *stmt) = 0;
 	};
 
+	/** Outcome of a step which is kept apart from the statement
+	 * while the rows are stepped on the prefetch thread.
+	 */
+	struct StepState {
+		int            status = 0;
+		std::string    error;
+		std::uint64_t  busyRetries = 0;
+	};
+
+	/** How the cells of a column are decoded. Taken from the
+	 * declared type because sqlite3 only knows the type of a
+	 * single value. The declared type decides which storage class
+	 * is checked first and how integers and blobs are returned.
+	 */
+	enum class ColumnKind {
+		integer,
+		floating,
+		text,
+		blob,
+		timestamp,
+		uuid,
+		any
+	};
+
+	/** Where fetch() takes the next row from */
+	enum class FetchState {
+		done,
+		/** The row stepped by execute() */
+		first,
+		stepping,
+		prefetched,
+		cached
+	};
+
+	/** Values of the row the statement is stepped to */
+	struct StatementColumns {
+		sqlite3_stmt *stmt;
+
+		int type(int column) const {return sqlite3_column_type(stmt, column);}
+		sqlite3_int64 integer(int column) const {return sqlite3_column_int64(stmt, column);}
+		double floating(int column) const {return sqlite3_column_double(stmt, column);}
+		const char *text(int column) const {return reinterpret_cast<const char*>(sqlite3_column_text(stmt, column));}
+		const void *blob(int column) const {return sqlite3_column_blob(stmt, column);}
+		/** Only valid after text() or blob() */
+		int bytes(int column) const {return sqlite3_column_bytes(stmt, column);}
+	};
+
+	/** Values of a row copied by the prefetch thread */
+	struct BatchColumns {
+		const Sqlite3RowBatch::Value *values;
+		const char                   *data;
+
+		int type(int column) const {return values[column].type;}
+		sqlite3_int64 integer(int column) const {return values[column].integer;}
+		double floating(int column) const {return values[column].floating;}
+		const char *text(int column) const {return data + values[column].offset;}
+		const void *blob(int column) const {return data + values[column].offset;}
+		int bytes(int column) const {return values[column].bytes;}
+	};
+
+	/** Appends the cell of a column to the row. Returns false
+	 * when the value is not supported.
+	 */
+	template<typename Columns>
+	using decode_T = bool(*)(const Columns &columns, int column, Row &row);
+
+	/** Rows stepped by the prefetch thread in one go */
+	static constexpr std::size_t prefetchBatchRows = 64;
+
 	static void sqliteStatementDeleter(sqlite3_stmt *stmt);
 
-	Sqlite3Statement(sqlite3 *connection, const std::string &query);
+	/** When the hooks of the connection are given the statement is
+	 * prepared with their authorizer, results of read only queries
+	 * are stored in the result cache and executed savepoints are
+	 * reported to the change capture. Without a cache or a capture
+	 * the authorizer is only run once the capture is started.
+	 *
+	 * With a prefetch depth read only queries are stepped on a
+	 * thread of their own which keeps up to this number of row
+	 * batches ahead of the consumer.
+	 *
+	 * Integers of TIMESTAMP and DATETIME columns are only returned
+	 * as timestamps with nativeTimestamps.
+	 */
+	Sqlite3Statement(sqlite3 *connection, const std::string &query,
+			std::shared_ptr<Sqlite3Hooks> hooks = nullptr, std::size_t prefetchDepth = 0,
+			bool nativeTimestamps = false);
 	virtual ~Sqlite3Statement();
 	int getStatus() const final override;
 	Row::uniquePtr_T fetch() final override;
+	/** Decodes the row with the plan of the current execution */
 	int step(Row::uniquePtr_T &row);
+	int step(Row::uniquePtr_T &row, StepState &state);
+	/** Copies the row into the batch instead of decoding it */
+	int step(Sqlite3RowBatch &batch, StepState &state);
 	int execute(Table *dbResultTable) final override;
 	std::int64_t lastInsertId() final override;
 	static void destroyBLOBArray(void *data);
+	/** Check the declared type of a result column. Columns declared as
+	 * TIMESTAMP or DATETIME holding integers and UUID columns holding
+	 * 16 byte blobs are returned as native timestamp and uuid cells.
+	 */
+	static bool isDeclaredAs(const char *declaredType, const char *type);
+	/** Uses the affinity rules of sqlite3 for the declared type */
+	static ColumnKind getColumnKind(const char *declaredType);
+	/** When ownBlobs is set the blob cells are copied so the row
+	 * stays valid after the next step.
+	 */
+	template<typename Columns>
+	static decode_T<Columns> getDecoder(ColumnKind kind, bool ownBlobs);
 	static void bindBLOB(sqlite3_stmt *stmt, int n, std::shared_ptr<std::basic_streambuf<char>> &streambuffer);
 	static void bindIstream(sqlite3_stmt *stmt, int n, std::shared_ptr<std::basic_istream<char>> &streambuffer);
 	bool bind(ecs::db3::types::cell_T *parameter, const std::string *parameterName, int n) final override;
@@ -88,6 +195,37 @@ public:
 	void clearBindings() final override;
 
 protected:
+	/** Serializes a parameter for the result cache key. Returns
+	 * false when the parameter is a stream which can not be compared.
+	 */
+	static bool bindingKey(const ecs::db3::types::cell_T &parameter, std::string &key);
+
+	/** SQL text and bound parameters. Returns false when the current
+	 * bindings are not cacheable.
+	 */
+	bool makeResultKey(std::string &key) const;
+
+	/** Decoder of every result column. Built once per execution */
+	void buildPlan();
+
+	template<ColumnKind kind, bool ownBlobs, typename Columns>
+	static bool decodeColumn(const Columns &columns, int column, Row &row);
+
+	/** Steps to the next row without decoding it. Returns 1 on a
+	 * row, 0 at the end and -1 on errors like step().
+	 */
+	int advance(StepState &state);
+
+	Row::uniquePtr_T nextRow();
+
+	/** Stops the prefetch thread and takes over the outcome of
+	 * its last step.
+	 */
+	void finishPrefetch();
+
+	/** Stops the prefetch thread and ends the result with the error */
+	void failPrefetch(const std::string &error);
+
 	int                           status;
 	/** The connection is not managed by this class so never
 	 * destroy the pointer on destruction. Every statement keeps
@@ -102,8 +240,42 @@ protected:
 	 */
 	Row::uniquePtr_T row;
 
-	std::function<Row::uniquePtr_T(Sqlite3Statement*)> doFetchRow;
+	FetchState                    fetchState;
+	/** Built by the first row of an execution because stepping may
+	 * prepare the statement again after a schema change.
+	 */
+	std::vector<decode_T<StatementColumns>> plan;
+	/** Decodes the rows copied by the prefetch thread. Only built
+	 * for a prefetched execution.
+	 */
+	std::vector<decode_T<BatchColumns>>     batchPlan;
+	/** Blobs are copied by the plan of a prefetched execution */
+	bool                          planOwnBlobs;
 	const char *pzTail;
+
+	std::shared_ptr<Sqlite3Hooks>        hooks;
+	std::shared_ptr<Sqlite3ResultCache>  cache;
+	Sqlite3QueryAccess                   access;
+	/** False until the access was recorded by the authorizer */
+	bool                                 classified;
+	/** True when results of this statement may be cached */
+	bool                                 cacheable;
+	/** Serialized parameters where an empty key is not cacheable */
+	std::vector<std::string>             bindingKeys;
+	std::string                          resultKey;
+	/** Rows of the running execution which are stored in the
+	 * cache when all of them were fetched.
+	 */
+	std::shared_ptr<Sqlite3CachedResult> collector;
+	std::uint64_t                        collectorVersion;
+	/** Result of the current execution when it was in the cache */
+	std::shared_ptr<const Sqlite3CachedResult> cachedResult;
+	std::size_t                          cachedRow;
+	const std::size_t                    prefetchDepth;
+	const bool                           nativeTimestamps;
+	/** Only present while a prefetched result is fetched */
+	std::unique_ptr<Sqlite3Prefetcher>   prefetcher;
+	StepState                            prefetchState;
 };
 
 class ECS_EXPORT Sqlite3Connection : public ConnectionImpl {
@@ -128,11 +300,64 @@ public:
 
 	ecs::db3::MigratorImpl* getMigrator(DbConnection *connection);
 
+	/** Online backup with the sqlite3 backup API. The destination
+	 * must be a sqlite3 connection as well.
+	 */
+	bool backup(ConnectionImpl *destination, int pagesPerStep,
+			std::chrono::milliseconds sleep,
+			const std::function<void(int, int)> &progress) final override;
+
+	void getMaintenanceStatistics(MaintenanceStatistics &statistics) final override;
+
+	void getResultCacheStatistics(ResultCacheStatistics &statistics) final override;
+
+	bool captureChanges(std::function<void(ChangeBatch&&)> publish) final override;
+
+	bool adviseIndexes(std::vector<IndexAdvice> &advice) final override;
+
+	bool locksDatabaseOnWrite() const final override;
+
+	/** Registers the table as eponymous virtual table */
+	bool registerTable(const std::string &name, MemoryTable::sharedPtr_T table) final override;
+
+	void startTransation() final override;
+
+	void commitTransaction() final override;
+
+	void rollbackTransaction() final override;
+
 protected:
+	/** Runs a transaction control statement and throws on failure */
+	void executeTransactionQuery(const char *query);
+
 	/** This holds a shared pointer to a sqlite3
 	 * connection.
 	 */
 	sqlite3 *sqlite3Con;
+
+	/** Background checkpoints and incremental vacuum. Only present
+	 * when enabled in the connection parameters.
+	 */
+	std::unique_ptr<Sqlite3Maintenance> maintenance;
+
+	/** Shared with the statements. Only present when enabled in
+	 * the connection parameters.
+	 */
+	std::shared_ptr<Sqlite3ResultCache> resultCache;
+
+	/** Shared with the statements so statements prepared before
+	 * captureChanges report their savepoints as well.
+	 */
+	std::shared_ptr<Sqlite3Hooks>       hooks;
+
+	/** Only present when a slow query threshold and a sink or
+	 * the workload capture are given in the connection parameters.
+	 */
+	std::unique_ptr<Sqlite3QueryLog>    queryLog;
+
+	/** Passed to the prepared statements */
+	std::size_t                         prefetchDepth;
+	bool                                nativeTimestamps;
 };
 
 }
@@ -24,6 +24,8 @@
 #define SRC_ECSDB_TYPES_HPP_
 
 #include <ecs/Any.hpp>
+#include <ecs/Timestamp.hpp>
+#include <ecs/UUID.hpp>
 #include <cstdint>
 #include <streambuf>
 #include <memory>
@@ -46,6 +48,12 @@ enum class typeId {
 	float_T,
 	blobInput,
 	boolean_T,
+	timestamp,
+	uuid,
+	/** Cell of a dictionary encoded column of a Table. The cell
+	 * holds no value, the text is read with Table::getText().
+	 */
+	dictionary,
 	undefined
 };
 
@@ -60,6 +68,15 @@ struct Float : ecs::tools::any::AnyTypedef<float, typeId, typeId::float_T> {};
 struct Blob : ecs::tools::any::AnyTypedef<std::shared_ptr<std::basic_streambuf<char>>, typeId, typeId::blob> {};
 struct BlobInput : ecs::tools::any::AnyTypedef<std::shared_ptr<std::basic_istream<char>>, typeId, typeId::blobInput> {};
 struct Boolean : ecs::tools::any::AnyTypedef<bool, typeId, typeId::boolean_T> {};
+/** Stored natively by the backends: timestamptz in postgres,
+ * DATETIME/TIMESTAMP in MariaDB and microseconds since the
+ * epoch as INTEGER in sqlite.
+ */
+struct Timestamp : ecs::tools::any::AnyTypedef<ecs::time::Timestamp, typeId, typeId::timestamp> {};
+/** Stored as uuid in postgres, BINARY(16) in MariaDB and
+ * as 16 byte BLOB in sqlite.
+ */
+struct Uuid : ecs::tools::any::AnyTypedef<ecs::tools::UUID, typeId, typeId::uuid> {};
 
 /** @} */
 
@@ -0,0 +1,277 @@
+/*
+ * Profiler.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <ecs/Profiler.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <list>
+#include <map>
+
+namespace {
+
+/** Number of zones the current thread is in */
+thread_local std::uint32_t zoneDepth = 0;
+
+struct BuildNode {
+	const char            *name;
+	ecs::tools::ProfilerNode  statistics;
+	std::list<BuildNode>   children;
+
+	BuildNode &child(const char *childName) {
+		for(auto &node : children) {
+			if(std::strcmp(node.name, childName) == 0) {
+				return node;
+			}
+		}
+		children.push_back(BuildNode{childName, {}, {}});
+		return children.back();
+	}
+
+	ecs::tools::ProfilerNode finish() const {
+		ecs::tools::ProfilerNode result = statistics;
+		result.name = name;
+
+		std::uint64_t childTime = 0;
+		for(auto &node : children) {
+			result.children.push_back(node.finish());
+			childTime += result.children.back().totalNanoseconds;
+		}
+		result.selfNanoseconds = result.totalNanoseconds > childTime ? result.totalNanoseconds - childTime : 0;
+
+		std::sort(result.children.begin(), result.children.end(),
+				[](const ecs::tools::ProfilerNode &a, const ecs::tools::ProfilerNode &b){
+			return a.totalNanoseconds > b.totalNanoseconds;
+		});
+		return result;
+	}
+};
+
+std::string escape(const char *value) {
+	std::string result;
+	for(;*value;++value) {
+		if(*value == '"' || *value == '\\') {
+			result += '\\';
+		}
+		result += *value;
+	}
+	return result;
+}
+
+}
+
+/** Ring buffer of one thread. Only the owning thread writes and
+ * only the profiler reads while holding its mutex.
+ */
+struct ecs::tools::Profiler::ThreadBuffer {
+	struct Slot {
+		std::atomic<const ProfilerZone*>  zone{nullptr};
+		std::atomic<std::uint64_t>        start{0};
+		std::atomic<std::uint64_t>        end{0};
+		std::atomic<std::uint32_t>        depth{0};
+	};
+
+	explicit ThreadBuffer(std::uint32_t thread) : thread(thread) {
+
+	}
+
+	const std::uint32_t                thread;
+	std::array<Slot, bufferSize>       slots;
+	/** Number of zones written */
+	std::atomic<std::uint64_t>         head{0};
+	/** Number of zones read by the profiler */
+	std::uint64_t                      tail = 0;
+};
+
+ecs::tools::Profiler &ecs::tools::Profiler::instance() {
+	static Profiler profiler;
+	return profiler;
+}
+
+std::uint64_t ecs::tools::Profiler::now() {
+	return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+ecs::tools::Profiler::ThreadBuffer &ecs::tools::Profiler::getBuffer() {
+	thread_local std::shared_ptr<ThreadBuffer> buffer;
+
+	if(!buffer) {
+		std::scoped_lock lock(mutex);
+		buffer = std::make_shared<ThreadBuffer>(nextThread++);
+		buffers.push_back(buffer);
+	}
+	return *buffer;
+}
+
+void ecs::tools::Profiler::record(const ProfilerZone &zone, std::uint64_t start, std::uint64_t end, std::uint32_t depth) {
+	auto &buffer   = getBuffer();
+	auto  position = buffer.head.load(std::memory_order_relaxed);
+	auto &slot     = buffer.slots[position % bufferSize];
+
+	slot.zone.store(&zone, std::memory_order_relaxed);
+	slot.start.store(start, std::memory_order_relaxed);
+	slot.end.store(end, std::memory_order_relaxed);
+	slot.depth.store(depth, std::memory_order_relaxed);
+	buffer.head.store(position + 1, std::memory_order_release);
+}
+
+void ecs::tools::Profiler::drain() {
+	for(auto it = buffers.begin();it != buffers.end();) {
+		auto &buffer = **it;
+		auto  head   = buffer.head.load(std::memory_order_acquire);
+		auto  from   = std::max(buffer.tail, head > bufferSize ? head - bufferSize : 0);
+
+		std::vector<Event> copied;
+		copied.reserve(head - from);
+		for(auto position = from;position < head;position++) {
+			auto &slot = buffer.slots[position % bufferSize];
+			copied.push_back(Event{
+				slot.zone.load(std::memory_order_relaxed),
+				slot.start.load(std::memory_order_relaxed),
+				slot.end.load(std::memory_order_relaxed),
+				buffer.thread,
+				slot.depth.load(std::memory_order_relaxed)});
+		}
+
+		/* Zones overwritten by the thread while they were copied
+		 * are dropped.
+		 */
+		std::atomic_thread_fence(std::memory_order_acquire);
+		auto after = buffer.head.load(std::memory_order_relaxed);
+		auto valid = after > bufferSize ? after - bufferSize : 0;
+		auto skip  = valid > from ? std::min<std::uint64_t>(valid - from, copied.size()) : 0;
+
+		dropped += (from - buffer.tail) + skip;
+		events.insert(events.end(), copied.begin() + static_cast<std::ptrdiff_t>(skip), copied.end());
+		buffer.tail = head;
+
+		/* The buffer of a finished thread is only referenced here */
+		if(it->use_count() == 1) {
+			it = buffers.erase(it);
+		}else{
+			++it;
+		}
+	}
+}
+
+std::vector<ecs::tools::Profiler::Event> ecs::tools::Profiler::getEvents() {
+	std::scoped_lock lock(mutex);
+	drain();
+	return events;
+}
+
+std::uint64_t ecs::tools::Profiler::getDropped() {
+	std::scoped_lock lock(mutex);
+	drain();
+	return dropped;
+}
+
+ecs::tools::ProfilerNode ecs::tools::Profiler::getCallTree() {
+	auto recorded = getEvents();
+
+	/* Parents start before their children */
+	std::sort(recorded.begin(), recorded.end(), [](const Event &a, const Event &b){
+		if(a.thread != b.thread) return a.thread < b.thread;
+		if(a.start != b.start) return a.start < b.start;
+		return a.depth < b.depth;
+	});
+
+	BuildNode                root{"", {}, {}};
+	std::vector<BuildNode*>  stack;
+	std::uint32_t            thread = 0;
+
+	for(auto &event : recorded) {
+		if(stack.empty() || event.thread != thread) {
+			stack.assign(1, &root);
+			thread = event.thread;
+		}
+
+		/* The parent of a lost zone is unknown so its children
+		 * are added to the closest known zone.
+		 */
+		while(stack.size() > event.depth + 1) {
+			stack.pop_back();
+		}
+
+		auto &node     = stack.back()->child(event.zone->name);
+		auto  duration = event.end - event.start;
+		node.statistics.calls++;
+		node.statistics.totalNanoseconds += duration;
+		node.statistics.maxNanoseconds    = std::max(node.statistics.maxNanoseconds, duration);
+		stack.push_back(&node);
+	}
+
+	auto result = root.finish();
+	for(auto &child : result.children) {
+		result.totalNanoseconds += child.totalNanoseconds;
+	}
+	return result;
+}
+
+void ecs::tools::Profiler::writeChromeTrace(std::ostream &stream) {
+	auto recorded = getEvents();
+
+	std::uint64_t origin = recorded.empty() ? 0 : recorded.front().start;
+	for(auto &event : recorded) {
+		origin = std::min(origin, event.start);
+	}
+
+	auto flags     = stream.flags();
+	auto precision = stream.precision();
+	stream.setf(std::ios::fixed, std::ios::floatfield);
+	stream.precision(3);
+
+	/* Complete events with microsecond timestamps */
+	stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+	for(std::size_t i = 0;i < recorded.size();i++) {
+		auto &event = recorded[i];
+		stream << (i == 0 ? "\n" : ",\n")
+				<< "{\"name\":\"" << escape(event.zone->name) << "\",\"cat\":\"ecs\",\"ph\":\"X\""
+				<< ",\"ts\":" << static_cast<double>(event.start - origin) / 1000.0
+				<< ",\"dur\":" << static_cast<double>(event.end - event.start) / 1000.0
+				<< ",\"pid\":1,\"tid\":" << event.thread
+				<< ",\"args\":{\"file\":\"" << escape(event.zone->file) << "\",\"line\":" << event.zone->line << "}}";
+	}
+	stream << "\n]}\n";
+
+	stream.flags(flags);
+	stream.precision(precision);
+}
+
+void ecs::tools::Profiler::clear() {
+	std::scoped_lock lock(mutex);
+	drain();
+	events.clear();
+	dropped = 0;
+}
+
+ecs::tools::ProfilerScope::ProfilerScope(const ProfilerZone &zone) :
+		zone(zone), start(Profiler::now()), depth(zoneDepth++) {
+
+}
+
+ecs::tools::ProfilerScope::~ProfilerScope() {
+	zoneDepth--;
+	Profiler::instance().record(zone, start, Profiler::now(), depth);
+}
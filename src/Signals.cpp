@@ -24,6 +24,8 @@
 #include <csignal>
 #include <functional>
 #include <set>
+#include <algorithm>
+#include <chrono>
 
 #if defined(__LINUX__)
 #include <sys/types.h>
@@ -77,9 +79,20 @@ public:
 			return true;
 		}
 
+		/* Notifications are sent without holding the mutex and
+		 * may be lost so the flag is checked in short intervals.
+		 */
+		auto deadline = std::chrono::steady_clock::now() + millis;
+
 		while(terminationRequested == false) {
+			auto now = std::chrono::steady_clock::now();
+			if(now >= deadline) {
+				return false;
+			}
+
 			std::unique_lock<std::mutex> lock(terminationRequestedMutex);
-			terminationRequestedCond.wait_for(lock, millis);
+			terminationRequestedCond.wait_for(lock, std::min<std::chrono::steady_clock::duration>(
+					deadline - now, std::chrono::milliseconds(500)));
 		}
 
 		return true;
@@ -183,6 +196,10 @@ bool ecs::tools::SignalHandler::waitForTerminationRequest(std::chrono::milliseco
 	return impl->waitForTerminationRequest(millis);
 }
 
+bool ecs::tools::SignalHandler::isTerminationRequested() const {
+	return SignalHandlerImpl::terminationRequested;
+}
+
 void ecs::tools::SignalHandler::terminate(){
 	impl->terminate();
 }
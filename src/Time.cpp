@@ -22,32 +22,169 @@
 #include <ecs/Time.hpp>
 #include <chrono>
 #include <ctime>
-#include <mutex>
+#include <cstdint>
+#include <cstring>
 
 std::tm ecs::time::localtime(const std::time_t *time){
-	static std::mutex mtx;
-	std::lock_guard<std::mutex> lock(mtx);
 	std::time_t t;
+	std::tm     tm;
 
 	if(time == nullptr) {
 		t = std::time(nullptr);
 	}else{
 		t = *time;
 	}
-	std::tm tm = *std::localtime(&t);
+#ifdef ECS_PLATFORM_WINDOWS
+	localtime_s(&tm, &t);
+#else
+	localtime_r(&t, &tm);
+#endif
 	return tm;
 }
 
 std::tm ecs::time::gmtime(const std::time_t *time){
-	static std::mutex mtx;
-	std::lock_guard<std::mutex> lock(mtx);
 	std::time_t t;
+	std::tm     tm;
 	
 	if(time == nullptr) {
 		t = std::time(nullptr);
 	}else{
 		t = *time;
 	}
-	std::tm tm = *std::gmtime(&t);
+#ifdef ECS_PLATFORM_WINDOWS
+	gmtime_s(&tm, &t);
+#else
+	gmtime_r(&t, &tm);
+#endif
 	return tm;
 }
+
+namespace {
+
+/** Formatted date and time of a single second. The prefix
+ * has the form YYYY-MM-DDTHH:MM:SS.
+ */
+struct SecondCache {
+	static constexpr std::size_t prefixLength = 19;
+
+	std::int64_t second = INT64_MIN;
+	char         prefix[prefixLength];
+	char         suffix[8];
+	std::size_t  suffixLength = 0;
+};
+
+inline void writeDigits(char *buffer, std::uint32_t value, int digits) {
+	for(int i = digits - 1;i >= 0;--i) {
+		buffer[i] = static_cast<char>('0' + value % 10);
+		value /= 10;
+	}
+}
+
+/** Date of the proleptic gregorian calendar from the days since
+ * 1970-01-01 (H. Hinnant, civil_from_days).
+ */
+inline void civilFromDays(std::int64_t days, std::int64_t &year, std::uint32_t &month, std::uint32_t &day) {
+	days += 719468;
+	const std::int64_t  era = (days >= 0 ? days : days - 146096) / 146097;
+	const std::uint32_t doe = static_cast<std::uint32_t>(days - era * 146097);
+	const std::uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+	const std::uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+	const std::uint32_t mp  = (5 * doy + 2) / 153;
+
+	day   = doy - (153 * mp + 2) / 5 + 1;
+	month = mp < 10 ? mp + 3 : mp - 9;
+	year  = static_cast<std::int64_t>(yoe) + era * 400 + (month <= 2);
+}
+
+void fillUTC(SecondCache &cache, std::int64_t second) {
+	std::int64_t days = second / 86400;
+	std::int64_t rest = second % 86400;
+
+	if(rest < 0) {
+		rest += 86400;
+		days -= 1;
+	}
+
+	std::int64_t  year;
+	std::uint32_t month, day;
+	civilFromDays(days, year, month, day);
+
+	/* Four digit years cover every timestamp we store */
+	writeDigits(cache.prefix, static_cast<std::uint32_t>(year < 0 ? 0 : (year > 9999 ? 9999 : year)), 4);
+	cache.prefix[4]  = '-';
+	writeDigits(cache.prefix + 5, month, 2);
+	cache.prefix[7]  = '-';
+	writeDigits(cache.prefix + 8, day, 2);
+	cache.prefix[10] = 'T';
+	writeDigits(cache.prefix + 11, static_cast<std::uint32_t>(rest / 3600), 2);
+	cache.prefix[13] = ':';
+	writeDigits(cache.prefix + 14, static_cast<std::uint32_t>(rest / 60 % 60), 2);
+	cache.prefix[16] = ':';
+	writeDigits(cache.prefix + 17, static_cast<std::uint32_t>(rest % 60), 2);
+
+	cache.suffix[0]    = 'Z';
+	cache.suffixLength = 1;
+}
+
+void fillLocal(SecondCache &cache, std::int64_t second) {
+	std::time_t t  = static_cast<std::time_t>(second);
+	std::tm     tm = ecs::time::localtime(&t);
+	char        prefix[SecondCache::prefixLength + 1];
+
+	std::strftime(prefix, sizeof(prefix), "%FT%T", &tm);
+	std::memcpy(cache.prefix, prefix, SecondCache::prefixLength);
+	cache.suffixLength = std::strftime(cache.suffix, sizeof(cache.suffix), "%z", &tm);
+}
+
+}
+
+std::size_t ecs::time::formatISO8601(std::chrono::system_clock::time_point time, char *buffer,
+		Precision precision, bool localtime) {
+	using namespace std::chrono;
+	thread_local SecondCache utcCache;
+	thread_local SecondCache localCache;
+
+	auto micros = duration_cast<microseconds>(time.time_since_epoch()).count();
+	auto second = micros / 1000000;
+	auto part   = micros % 1000000;
+
+	if(part < 0) {
+		part   += 1000000;
+		second -= 1;
+	}
+
+	SecondCache &cache = localtime ? localCache : utcCache;
+
+	/* Only a new second needs the calendar calculation */
+	if(cache.second != second) {
+		if(localtime) {
+			fillLocal(cache, second);
+		}else{
+			fillUTC(cache, second);
+		}
+		cache.second = second;
+	}
+
+	std::size_t length = SecondCache::prefixLength;
+	std::memcpy(buffer, cache.prefix, length);
+
+	switch(precision) {
+	case Precision::milliseconds:
+		buffer[length] = '.';
+		writeDigits(buffer + length + 1, static_cast<std::uint32_t>(part / 1000), 3);
+		length += 4;
+		break;
+	case Precision::microseconds:
+		buffer[length] = '.';
+		writeDigits(buffer + length + 1, static_cast<std::uint32_t>(part), 6);
+		length += 7;
+		break;
+	default:
+		break;
+	}
+
+	std::memcpy(buffer + length, cache.suffix, cache.suffixLength);
+	length += cache.suffixLength;
+	buffer[length] = '\0';
+	return length;
+}
@@ -22,20 +22,230 @@
 
 #include <ecs/Timestamp.hpp>
 #include <ecs/Time.hpp>
+#include <ecs/Exception.hpp>
 #include <chrono>
+#include <cstring>
 
-std::string ecs::time::ISO8601::now(std::chrono::seconds offset, bool localtime) {
-	using namespace std::chrono;
-	char timeString[64];
-	auto now = system_clock::now() + offset;
-	auto tt  = system_clock::to_time_t(now);
-	std::tm tm;
-	if (localtime == true){
-		tm = ecs::time::localtime(&tt);
-		std::strftime(timeString, sizeof(timeString), "%FT%T%z", &tm);
+namespace {
+
+/** Days since 1970-01-01 of a date in the proleptic gregorian
+ * calendar (H. Hinnant, days_from_civil).
+ */
+constexpr std::int64_t daysFromCivil(std::int64_t year, unsigned month, unsigned day) {
+	year -= month <= 2;
+	const std::int64_t era = (year >= 0 ? year : year - 399) / 400;
+	const unsigned     yoe = static_cast<unsigned>(year - era * 400);
+	const unsigned     doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+	const unsigned     doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+	return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+}
+
+constexpr unsigned daysInMonth(std::int64_t year, unsigned month) {
+	constexpr unsigned days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+	bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+	return month == 2 && leap ? 29 : days[month - 1];
+}
+
+inline bool isDigit(char c) {
+	return c >= '0' && c <= '9';
+}
+
+/** Parses a fixed amount of decimal digits */
+inline bool parseDigits(const char *text, int count, unsigned &result) {
+	result = 0;
+	for(int i = 0;i < count;++i) {
+		if(!isDigit(text[i])) {
+			return false;
+		}
+		result = result * 10 + static_cast<unsigned>(text[i] - '0');
+	}
+	return true;
+}
+
+/** Parses the fixed layout YYYY-MM-DDTHH:MM:SS of 19 characters.
+ * On little endian machines the 16 digits are checked and
+ * converted in two 64 bit words instead of character by character.
+ */
+inline bool parseDateTime(const char *text, unsigned *fields) {
+	if(text[4] != '-' || text[7] != '-' || text[13] != ':' || text[16] != ':') {
+		return false;
+	}
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	char digits[16];
+	std::memcpy(digits, text, 4);
+	std::memcpy(digits + 4, text + 5, 2);
+	std::memcpy(digits + 6, text + 8, 2);
+	std::memcpy(digits + 8, text + 11, 2);
+	std::memcpy(digits + 10, text + 14, 2);
+	std::memcpy(digits + 12, text + 17, 2);
+	std::memcpy(digits + 14, "00", 2);
+
+	std::uint64_t words[2];
+	std::memcpy(words, digits, sizeof(words));
+
+	for(auto &word : words) {
+		word -= 0x3030303030303030ULL;
+
+		/* Any byte outside of 0..9 sets a high nibble bit */
+		if(((word & 0xF0F0F0F0F0F0F0F0ULL) | ((word + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL)) != 0) {
+			return false;
+		}
+
+		/* Combine neighbouring digits into 2 digit values */
+		word = (word * 10 + (word >> 8)) & 0x00FF00FF00FF00FFULL;
+	}
+
+	auto pair = [&](int index) {
+		return static_cast<unsigned>((words[index / 4] >> (16 * (index % 4))) & 0xFF);
+	};
+
+	fields[0] = pair(0) * 100 + pair(1);
+	fields[1] = pair(2);
+	fields[2] = pair(3);
+	fields[3] = pair(4);
+	fields[4] = pair(5);
+	fields[5] = pair(6);
+	return true;
+#else
+	return parseDigits(text, 4, fields[0]) && parseDigits(text + 5, 2, fields[1]) &&
+			parseDigits(text + 8, 2, fields[2]) && parseDigits(text + 11, 2, fields[3]) &&
+			parseDigits(text + 14, 2, fields[4]) && parseDigits(text + 17, 2, fields[5]);
+#endif
+}
+
+}
+
+ecs::time::Timestamp ecs::time::Timestamp::now() noexcept {
+	return Timestamp(std::chrono::system_clock::now());
+}
+
+ecs::time::Timestamp ecs::time::Timestamp::fromCivil(std::int64_t year, unsigned month, unsigned day,
+		unsigned hour, unsigned minute, unsigned second, std::uint32_t microsecond) noexcept {
+	std::int64_t seconds = daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+	return fromMicroseconds(seconds * 1000000 + microsecond);
+}
+
+bool ecs::time::Timestamp::parse(std::string_view text, Timestamp &result) noexcept {
+	/* date, hour, minute, second */
+	unsigned     fields[6] = {0, 0, 0, 0, 0, 0};
+	std::size_t  position;
+
+	if(text.size() >= 19 && (text[10] == 'T' || text[10] == 't' || text[10] == ' ')) {
+		if(!parseDateTime(text.data(), fields)) {
+			return false;
+		}
+		position = 19;
+	}else if(text.size() >= 16 && (text[10] == 'T' || text[10] == 't' || text[10] == ' ') && text[13] == ':') {
+		/* Seconds are optional in ISO 8601 */
+		if(text[4] != '-' || text[7] != '-' || !parseDigits(text.data(), 4, fields[0]) ||
+				!parseDigits(text.data() + 5, 2, fields[1]) || !parseDigits(text.data() + 8, 2, fields[2]) ||
+				!parseDigits(text.data() + 11, 2, fields[3]) || !parseDigits(text.data() + 14, 2, fields[4])) {
+			return false;
+		}
+		position = 16;
+	}else if(text.size() == 10) {
+		if(text[4] != '-' || text[7] != '-' || !parseDigits(text.data(), 4, fields[0]) ||
+				!parseDigits(text.data() + 5, 2, fields[1]) || !parseDigits(text.data() + 8, 2, fields[2])) {
+			return false;
+		}
+		position = 10;
 	}else{
-		tm = ecs::time::gmtime(&tt);
-		std::strftime(timeString, sizeof(timeString), "%FT%TZ", &tm);
+		return false;
+	}
+
+	std::int64_t year = fields[0];
+
+	if(fields[1] < 1 || fields[1] > 12 || fields[2] < 1 || fields[2] > daysInMonth(year, fields[1]) ||
+			fields[3] > 23 || fields[4] > 59 || fields[5] > 60) {
+		return false;
 	}
-	return std::string(timeString);	
+
+	/* Fraction with any number of digits, only microseconds are kept */
+	std::int64_t fraction = 0;
+
+	if(position < text.size() && (text[position] == '.' || text[position] == ',') && position > 10) {
+		std::size_t start = ++position;
+		int         scale = 6;
+
+		while(position < text.size() && isDigit(text[position])) {
+			if(scale > 0) {
+				fraction = fraction * 10 + (text[position] - '0');
+				scale--;
+			}
+			position++;
+		}
+
+		if(position == start) {
+			return false;
+		}
+
+		while(scale-- > 0) {
+			fraction *= 10;
+		}
+	}
+
+	/* Offset of the local time to UTC */
+	std::int64_t offset = 0;
+
+	if(position < text.size()) {
+		char sign = text[position];
+
+		if((sign == 'Z' || sign == 'z') && position + 1 == text.size()) {
+			position++;
+		}else if(sign == '+' || sign == '-') {
+			unsigned hours, minutes = 0;
+			auto     rest = text.size() - position - 1;
+			auto     data = text.data() + position + 1;
+
+			if(rest == 2) {
+				if(!parseDigits(data, 2, hours)) return false;
+			}else if(rest == 4) {
+				if(!parseDigits(data, 2, hours) || !parseDigits(data + 2, 2, minutes)) return false;
+			}else if(rest == 5 && data[2] == ':') {
+				if(!parseDigits(data, 2, hours) || !parseDigits(data + 3, 2, minutes)) return false;
+			}else{
+				return false;
+			}
+
+			if(hours > 23 || minutes > 59) {
+				return false;
+			}
+
+			offset   = (static_cast<std::int64_t>(hours) * 60 + minutes) * 60;
+			offset   = sign == '+' ? offset : -offset;
+			position = text.size();
+		}else{
+			return false;
+		}
+	}
+
+	result = fromCivil(year, fields[1], fields[2], fields[3], fields[4], fields[5],
+			static_cast<std::uint32_t>(fraction)) - std::chrono::seconds(offset);
+	return true;
+}
+
+ecs::time::Timestamp ecs::time::Timestamp::fromISO8601(std::string_view text) {
+	Timestamp result;
+
+	if(!parse(text, result)) {
+		throw ecs::Exception("Invalid ISO 8601 timestamp: " + std::string(text));
+	}
+
+	return result;
+}
+
+std::size_t ecs::time::Timestamp::format(char *buffer, Precision precision) const {
+	return formatISO8601(std::chrono::system_clock::time_point(toTimePoint()), buffer, precision, false);
+}
+
+std::string ecs::time::Timestamp::toISO8601(Precision precision) const {
+	char buffer[ISO8601BufferSize];
+	return std::string(buffer, format(buffer, precision));
+}
+
+std::string ecs::time::ISO8601::now(std::chrono::seconds offset, bool localtime, Precision precision) {
+	char timeString[ISO8601BufferSize];
+	auto length = formatISO8601(std::chrono::system_clock::now() + offset, timeString, precision, localtime);
+	return std::string(timeString, length);
 }
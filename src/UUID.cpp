@@ -8,19 +8,146 @@
 
 
 #include <ecs/UUID.hpp>
+#include <ecs/Exception.hpp>
 
-#include <boost/lexical_cast.hpp>
-#include <boost/algorithm/string.hpp>
-#include <boost/uuid/uuid.hpp>
-#include <boost/uuid/uuid_generators.hpp>
-#include <boost/uuid/uuid_io.hpp>
 #ifdef ECS_HAVE_LIBUUID
 #include <uuid/uuid.h>
 #endif
-#include <mutex>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <string>
+#include <type_traits>
+#ifdef __linux__
+#include <sys/random.h>
+#endif
+#ifndef _WIN32
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+static_assert(std::is_trivially_copyable<ecs::tools::UUID>::value && sizeof(ecs::tools::UUID) == 16,
+		"UUID must be a plain 16 byte value");
+
+namespace {
+
+/** Random bytes of the operating system. Every thread keeps its own
+ * buffer so the system is only asked once for many UUIDs and
+ * generating never waits for a lock. The buffer is dropped in a
+ * forked child so parent and child never return the same bytes.
+ */
+class RandomBuffer {
+public:
+	~RandomBuffer() {
+		std::memset(buffer, 0, sizeof(buffer));
+	}
+
+	void fill(std::uint8_t *bytes, std::size_t n) {
+#ifndef _WIN32
+		auto pid = ::getpid();
+		if(pid != owner) {
+			owner    = pid;
+			position = sizeof(buffer);
+		}
+#endif
+
+		/* Large requests skip the buffer */
+		if(n >= sizeof(buffer)) {
+			systemRandom(bytes, n);
+			return;
+		}
+
+		while(n > 0) {
+			if(position == sizeof(buffer)) {
+				systemRandom(buffer, sizeof(buffer));
+				position = 0;
+			}
+
+			auto count = std::min(n, sizeof(buffer) - position);
+			std::memcpy(bytes, buffer + position, count);
+			/* Handed out bytes must not stay in memory */
+			std::memset(buffer + position, 0, count);
+			position += count;
+			bytes    += count;
+			n        -= count;
+		}
+	}
+
+private:
+	static void systemRandom(std::uint8_t *bytes, std::size_t n) {
+#ifdef __linux__
+		while(n > 0) {
+			auto result = ::getrandom(bytes, n, 0);
+			if(result < 0) {
+				if(errno == EINTR) {
+					continue;
+				}
+				throw ecs::Exception("Reading random bytes failed: " + std::string(std::strerror(errno)));
+			}
+			bytes += result;
+			n     -= static_cast<std::size_t>(result);
+		}
+#else
+		std::random_device device;
+
+		while(n > 0) {
+			auto value = device();
+			auto count = std::min(n, sizeof(value));
+			std::memcpy(bytes, &value, count);
+			bytes += count;
+			n     -= count;
+		}
+#endif
+	}
+
+	std::uint8_t  buffer[4096];
+	std::size_t   position = sizeof(buffer);
+#ifndef _WIN32
+	pid_t         owner    = 0;
+#endif
+};
 
-static boost::uuids::random_generator randomUUIDGenerator;
-static std::mutex                     randomUUIDGeneratorMutex;
+void fillRandom(std::uint8_t *bytes, std::size_t n) {
+	thread_local RandomBuffer random;
+	random.fill(bytes, n);
+}
+
+/** Millisecond and counter of the last version 7 UUID of this thread */
+struct Version7State {
+	std::uint64_t millis  = 0;
+	std::uint32_t counter = 0;
+};
+
+
+void setVersion(std::uint8_t *bytes, int version) {
+	bytes[6] = static_cast<std::uint8_t>((bytes[6] & 0x0f) | (version << 4));
+	/* Variant 10xx of RFC 4122 */
+	bytes[8] = static_cast<std::uint8_t>((bytes[8] & 0x3f) | 0x80);
+}
+
+/** Maps characters to their hex value or 0xff */
+struct HexTable {
+	std::uint8_t values[256];
+
+	constexpr HexTable() : values() {
+		for(int i = 0;i < 256;++i) {
+			values[i] = 0xff;
+		}
+		for(int i = 0;i < 10;++i) {
+			values['0' + i] = static_cast<std::uint8_t>(i);
+		}
+		for(int i = 0;i < 6;++i) {
+			values['a' + i] = static_cast<std::uint8_t>(10 + i);
+			values['A' + i] = static_cast<std::uint8_t>(10 + i);
+		}
+	}
+};
+
+constexpr HexTable hexTable;
+
+}
 
 ecs::tools::UUIDGenerator::~UUIDGenerator() {
 }
@@ -29,25 +156,147 @@ ecs::tools::UUIDGenerator::UUIDGenerator() {
 }
 
 void ecs::tools::UUIDGenerator::generate(UUID& target) const {
-	std::lock_guard<std::mutex> lock(randomUUIDGeneratorMutex);
-	auto uuid = randomUUIDGenerator();
-	target.data = boost::uuids::to_string(uuid);
+	fillRandom(target.bytes.data(), 16);
+	setVersion(target.bytes.data(), 4);
+}
+
+void ecs::tools::UUIDGenerator::generate(UUID *targets, std::size_t n) const {
+	fillRandom(reinterpret_cast<std::uint8_t*>(targets), n * sizeof(UUID));
+
+	for(std::size_t i = 0;i < n;++i) {
+		setVersion(targets[i].bytes.data(), 4);
+	}
+}
+
+ecs::tools::UUIDGenerator7::~UUIDGenerator7() {
+}
+
+ecs::tools::UUIDGenerator7::UUIDGenerator7() {
 }
 
-ecs::tools::UUID::UUID() {
-	
+void ecs::tools::UUIDGenerator7::generate(UUID& target) const {
+	thread_local Version7State last;
+
+	std::uint64_t millis = std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::system_clock::now().time_since_epoch()).count();
+
+	if(millis > last.millis) {
+		/* Start with a random counter but leave room for increments */
+		std::uint16_t random;
+		fillRandom(reinterpret_cast<std::uint8_t*>(&random), sizeof(random));
+		last.millis  = millis;
+		last.counter = random & 0x7ff;
+	}else if(++last.counter > 0xfff) {
+		/* Counter overflow or the clock went backwards. Borrow
+		 * from the next millisecond to stay monotonic.
+		 */
+		last.millis++;
+		last.counter = 0;
+	}
+
+	auto *bytes = target.bytes.data();
+
+	for(int i = 0;i < 6;++i) {
+		bytes[i] = static_cast<std::uint8_t>(last.millis >> (40 - 8 * i));
+	}
+	bytes[6] = static_cast<std::uint8_t>(last.counter >> 8);
+	bytes[7] = static_cast<std::uint8_t>(last.counter);
+	fillRandom(bytes + 8, 8);
+	setVersion(bytes, 7);
 }
 
-ecs::tools::UUID::~UUID() {
-	
+void ecs::tools::UUIDGenerator7::generate(UUID *targets, std::size_t n) const {
+	for(std::size_t i = 0;i < n;++i) {
+		generate(targets[i]);
+	}
 }
 
 ecs::tools::UUID::UUID(const UUIDGenerator& generator) {
 	generator.generate(*this);
 }
 
+bool ecs::tools::UUID::parse(std::string_view text, UUID &result) noexcept {
+	if(text.size() == StringSize + 2 && text.front() == '{' && text.back() == '}') {
+		text = text.substr(1, StringSize);
+	}
+
+	std::size_t position;
+
+	if(text.size() == StringSize) {
+		if(text[8] != '-' || text[13] != '-' || text[18] != '-' || text[23] != '-') {
+			return false;
+		}
+	}else if(text.size() != 32) {
+		return false;
+	}
+
+	UUID parsed;
+	position = 0;
+
+	for(std::size_t i = 0;i < 16;++i) {
+		if(text.size() == StringSize && (i == 4 || i == 6 || i == 8 || i == 10)) {
+			position++;
+		}
+
+		auto high = hexTable.values[static_cast<unsigned char>(text[position])];
+		auto low  = hexTable.values[static_cast<unsigned char>(text[position + 1])];
+
+		if(high > 15 || low > 15) {
+			return false;
+		}
+
+		parsed.bytes[i] = static_cast<std::uint8_t>((high << 4) | low);
+		position += 2;
+	}
+
+	result = parsed;
+	return true;
+}
+
+ecs::tools::UUID ecs::tools::UUID::fromString(std::string_view text) {
+	UUID result;
+
+	if(!parse(text, result)) {
+		throw ecs::Exception("Invalid UUID: " + std::string(text));
+	}
+
+	return result;
+}
+
+void ecs::tools::UUID::format(char *buffer) const noexcept {
+	static const char digits[] = "0123456789abcdef";
+
+	for(std::size_t i = 0;i < 16;++i) {
+		if(i == 4 || i == 6 || i == 8 || i == 10) {
+			*buffer++ = '-';
+		}
+		*buffer++ = digits[bytes[i] >> 4];
+		*buffer++ = digits[bytes[i] & 0x0f];
+	}
+}
+
 std::string ecs::tools::UUID::toString() const {
-	return data;
+	char buffer[StringSize];
+	format(buffer);
+	return std::string(buffer, StringSize);
+}
+
+bool ecs::tools::UUID::isNil() const noexcept {
+	return *this == UUID();
+}
+
+std::size_t ecs::tools::UUID::hash() const noexcept {
+	std::uint64_t high, low;
+
+	std::memcpy(&high, bytes.data(), 8);
+	std::memcpy(&low, bytes.data() + 8, 8);
+
+	/* The first half of time ordered UUIDs is mostly equal so
+	 * both halves are mixed.
+	 */
+	std::uint64_t value = (high * 0x9e3779b97f4a7c15ULL) ^ low;
+	value ^= value >> 32;
+	return static_cast<std::size_t>(value);
 }
 
 #ifdef ECS_HAVE_LIBUUID
@@ -67,8 +316,12 @@ void ecs::tools::UUIDGenerator2::generate(UUID& target) const {
 		uuid_generate_time(out);
 	}
 
-	char uuidStr[37];
-	uuid_unparse_lower(out, uuidStr);
-	target.data.assign((const char *)&uuidStr[0], 36);
+	std::memcpy(target.bytes.data(), out, 16);
+}
+
+void ecs::tools::UUIDGenerator2::generate(UUID *targets, std::size_t n) const {
+	for(std::size_t i = 0;i < n;++i) {
+		generate(targets[i]);
+	}
 }
 #endif
@@ -21,14 +21,13 @@
  */
 #include <ecs/Utils.hpp>
 #include <ecs/Time.hpp>
+#include <ecs/UUID.hpp>
 
 #include <boost/lexical_cast.hpp>
 #include <boost/algorithm/string.hpp>
-#include <boost/uuid/uuid.hpp>
-#include <boost/uuid/uuid_generators.hpp>
-#include <boost/uuid/uuid_io.hpp>
 
 #include <time.h>
+#include <cstring>
 #include <iostream>
 #include <stdio.h>
 #include <vector>
@@ -45,27 +44,22 @@
 
 using namespace std;
 
-static boost::uuids::random_generator randomUUIDGenerator;
-static std::mutex randomUUIDGeneratorMutex;
-
 std::string ecs::tools::uuid() {
 	return randomUUID();
 }
 
 std::string ecs::tools::randomUUID() {
-	std::lock_guard<std::mutex> lock(randomUUIDGeneratorMutex);
-	auto uuid = randomUUIDGenerator();
-	return boost::uuids::to_string(uuid);;
+	return ecs::tools::UUID(ecs::tools::UUIDGenerator()).toString();
 }
 
 std::string ecs::tools::timestamp(int lifetime) {
-	auto now       = std::chrono::system_clock::now() + std::chrono::seconds(lifetime);
-	auto in_time_t = std::chrono::system_clock::to_time_t(now);
-	auto gmt       = ecs::time::gmtime(&in_time_t);
-	char formattedTime[100];
-	
-	std::strftime((char*)&formattedTime, sizeof(formattedTime)/sizeof(char), "%FT%T%z", &gmt);
-	return std::string((char*)&formattedTime);
+	auto now = std::chrono::system_clock::now() + std::chrono::seconds(lifetime);
+	char formattedTime[ecs::time::ISO8601BufferSize + 4];
+	auto length = ecs::time::formatISO8601(now, formattedTime);
+
+	/* This always used the numeric offset of UTC instead of Z */
+	std::memcpy(formattedTime + length - 1, "+0000", 5);
+	return std::string(formattedTime, length + 4);
 }
 
 static void SetStdinEcho(bool enable = true)
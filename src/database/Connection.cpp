@@ -28,7 +28,9 @@
 #include <iostream>
 #include <algorithm>
 #include <exception>
+#include <ecs/database/Connector.hpp>
 #include <ecs/database/Exception.hpp>
+#include <ecs/Profiler.hpp>
 
 using namespace ecs::db3;
 
@@ -42,13 +44,17 @@ ecs::db3::DbConnection::~DbConnection() {
 
 Statement::ptr_T ecs::db3::DbConnection::preparePtr(
 		const std::string& query) {
+	ECS_PROFILE_ZONE("DbConnection::prepare");
+
 	/* Check if we are still connected */
 	if(!impl) {
 		throw exceptions::Exception("No implementation present");
 	}
 
 	/* Use the implementation provided function here to build the statement */
+	auto                       start = StatementMetrics::clock_T::now();
 	StatementImpl::sharedPtr_T statementImplementation(impl->module->prepare(query));
+	auto                       prepareTime = StatementMetrics::clock_T::now() - start;
 	Statement::uniquePtr_T     statement = std::make_unique<Statement>(this);
 	
 	/* We check that here because both, the statement class and 
@@ -57,6 +63,12 @@ Statement::ptr_T ecs::db3::DbConnection::preparePtr(
 	if(statementImplementation && statement){
 		statement->impl->stmt = std::move(statementImplementation);
 
+		if(auto metrics = impl->module->getStatementMetrics()) {
+			statement->impl->metricsId = metrics->getStatementId(query);
+			statement->impl->metrics   = std::move(metrics);
+			statement->impl->metrics->recordPrepare(statement->impl->metricsId, prepareTime);
+		}
+
 		/* Release the pointer ownership */
 		return statement.release();
 	}if(statementImplementation) {
@@ -71,7 +83,15 @@ Statement::ptr_T ecs::db3::DbConnection::preparePtr(
 }
 
 bool DbConnection::execute ( const std::string &query ) {
-	return impl->module->execute(query);
+	auto metrics = impl->module->getStatementMetrics();
+	if(!metrics) {
+		return impl->module->execute(query);
+	}
+
+	auto start = StatementMetrics::clock_T::now();
+	auto rc    = impl->module->execute(query);
+	metrics->recordExecute(metrics->getStatementId(query), StatementMetrics::clock_T::now() - start, rc, 0);
+	return rc;
 }
 
 
@@ -109,3 +129,101 @@ void ecs::db3::DbConnection::rollbackTransaction() {
 void ecs::db3::DbConnection::autocommit(bool value) {
 	impl->module->autocommit(value);
 }
+
+std::future<void> ecs::db3::DbConnection::backupTo(const ConnectionParameters &params,
+		int pagesPerStep, std::chrono::milliseconds sleep, backupProgress_T progress) {
+	PluginLoader              loader;
+	DbConnection::sharedPtr_T destination(loader.loadPtr(params));
+
+	return backupTo(*destination, pagesPerStep, sleep, progress);
+}
+
+std::future<void> ecs::db3::DbConnection::backupTo(DbConnection &destination,
+		int pagesPerStep, std::chrono::milliseconds sleep, backupProgress_T progress) {
+	/* Copies of the loaded modules keep both connections open while
+	 * the backup is running on the executor of this connection.
+	 */
+	auto source = impl->module;
+	auto target = destination.impl->module;
+
+	if(pagesPerStep <= 0) {
+		throw exceptions::Exception("Backup needs at least one page per step");
+	}
+
+	return source->getExecutor().submit([source, target, pagesPerStep, sleep, progress](){
+		if(!source->backup(target.get(), pagesPerStep, sleep, progress)) {
+			throw exceptions::Exception("Backup failed: " + source->getErrorMessage());
+		}
+	});
+}
+
+MaintenanceStatistics ecs::db3::DbConnection::getMaintenanceStatistics() {
+	MaintenanceStatistics result;
+	impl->module->getMaintenanceStatistics(result);
+	return result;
+}
+
+ResultCacheStatistics ecs::db3::DbConnection::getResultCacheStatistics() {
+	ResultCacheStatistics result;
+	impl->module->getResultCacheStatistics(result);
+	return result;
+}
+
+std::vector<StatementStatistics> ecs::db3::DbConnection::getStatementStatistics() {
+	auto metrics = impl->module->getStatementMetrics();
+	return metrics ? metrics->getStatistics() : std::vector<StatementStatistics>();
+}
+
+std::string ecs::db3::DbConnection::dumpMetrics() {
+	auto metrics = impl->module->getStatementMetrics();
+	return metrics ? metrics->dumpPrometheus() : std::string();
+}
+
+std::vector<StatementStatistics> ecs::db3::DbConnection::getBackendStatistics() {
+	auto metrics = impl->module->getBackendMetrics();
+	return metrics ? metrics->getStatistics() : std::vector<StatementStatistics>();
+}
+
+bool ecs::db3::DbConnection::locksDatabaseOnWrite() const {
+	return impl->module->locksDatabaseOnWrite();
+}
+
+std::vector<IndexAdvice> ecs::db3::DbConnection::adviseIndexes() {
+	std::vector<IndexAdvice> result;
+	if(!impl->module->adviseIndexes(result)) {
+		throw exceptions::Exception("Index advice failed: " + impl->module->getErrorMessage());
+	}
+	return result;
+}
+
+void ecs::db3::DbConnection::subscribeChanges(ecs::tools::Function<void(ChangeBatch&)> subscriber) {
+	if(!impl->module->subscribeChanges(std::move(subscriber))) {
+		throw exceptions::Exception("Change capture failed: " + impl->module->getErrorMessage());
+	}
+}
+
+void ecs::db3::DbConnection::listen(const std::string &channel, notificationListener_T listener) {
+	if(!listener) {
+		throw exceptions::Exception("Can not listen without a listener");
+	}
+
+	if(!impl->module->listen(channel, std::move(listener))) {
+		throw exceptions::Exception("Listening on " + channel + " failed: " + impl->module->getErrorMessage());
+	}
+}
+
+void ecs::db3::DbConnection::unlisten(const std::string &channel) {
+	if(!impl->module->unlisten(channel)) {
+		throw exceptions::Exception("Unlisten " + channel + " failed: " + impl->module->getErrorMessage());
+	}
+}
+
+void ecs::db3::DbConnection::registerTable(const std::string &name, MemoryTable::sharedPtr_T table) {
+	if(!table) {
+		throw exceptions::Exception("Can not register an empty memory table");
+	}
+
+	if(!impl->module->registerTable(name, std::move(table))) {
+		throw exceptions::Exception("Registering table " + name + " failed: " + impl->module->getErrorMessage());
+	}
+}
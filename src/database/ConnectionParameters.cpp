@@ -37,6 +37,15 @@ public:
 		pluginDirectory = ECS_DATABASE_PLUGINDIR;
 		pluginExtension = ECS_DATABASE_PLUGIN_EXTENSION;
 		useTLS          = true;
+		walCheckpointPages    = 0;
+		maintenanceIdleTime   = std::chrono::milliseconds(1000);
+		incrementalVacuumPages = 0;
+		resultCacheBytes       = 0;
+		statementMetrics       = false;
+		slowQueryThreshold     = std::chrono::microseconds(0);
+		workloadCapture        = false;
+		prefetchDepth          = 0;
+		nativeTimestamps       = false;
 	}
 
 	virtual ~ConnectionParametersImpl() {
@@ -53,6 +62,18 @@ public:
 	std::string pluginExtension;
 	int port;
 	bool useTLS;
+	int walCheckpointPages;
+	std::chrono::milliseconds maintenanceIdleTime;
+	int incrementalVacuumPages;
+	std::size_t resultCacheBytes;
+	bool statementMetrics;
+	std::chrono::microseconds slowQueryThreshold;
+	slowQuerySink_T slowQuerySink;
+	bool workloadCapture;
+	std::string wrappedBackend;
+	SyntheticResult syntheticResult;
+	std::size_t prefetchDepth;
+	bool nativeTimestamps;
 };
 
 }
@@ -192,3 +213,99 @@ bool ConnectionParameters::getUseTLS() const {
 void ConnectionParameters::setUseTLS(bool value) {
 	impl->useTLS = value;
 }
+
+void ConnectionParameters::setWalCheckpointPages(int pages) {
+	impl->walCheckpointPages = pages;
+}
+
+int ConnectionParameters::getWalCheckpointPages() const {
+	return impl->walCheckpointPages;
+}
+
+void ConnectionParameters::setMaintenanceIdleTime(std::chrono::milliseconds idleTime) {
+	impl->maintenanceIdleTime = idleTime;
+}
+
+std::chrono::milliseconds ConnectionParameters::getMaintenanceIdleTime() const {
+	return impl->maintenanceIdleTime;
+}
+
+void ConnectionParameters::setIncrementalVacuumPages(int pages) {
+	impl->incrementalVacuumPages = pages;
+}
+
+int ConnectionParameters::getIncrementalVacuumPages() const {
+	return impl->incrementalVacuumPages;
+}
+
+void ConnectionParameters::setResultCacheBytes(std::size_t bytes) {
+	impl->resultCacheBytes = bytes;
+}
+
+std::size_t ConnectionParameters::getResultCacheBytes() const {
+	return impl->resultCacheBytes;
+}
+
+void ConnectionParameters::setStatementMetrics(bool enabled) {
+	impl->statementMetrics = enabled;
+}
+
+bool ConnectionParameters::getStatementMetrics() const {
+	return impl->statementMetrics;
+}
+
+void ConnectionParameters::setSlowQueryThreshold(std::chrono::microseconds threshold) {
+	impl->slowQueryThreshold = threshold;
+}
+
+std::chrono::microseconds ConnectionParameters::getSlowQueryThreshold() const {
+	return impl->slowQueryThreshold;
+}
+
+void ConnectionParameters::setSlowQuerySink(slowQuerySink_T sink) {
+	impl->slowQuerySink = std::move(sink);
+}
+
+const slowQuerySink_T &ConnectionParameters::getSlowQuerySink() const {
+	return impl->slowQuerySink;
+}
+
+void ConnectionParameters::setWorkloadCapture(bool enabled) {
+	impl->workloadCapture = enabled;
+}
+
+bool ConnectionParameters::getWorkloadCapture() const {
+	return impl->workloadCapture;
+}
+
+void ConnectionParameters::setWrappedBackend(const std::string &backend) {
+	impl->wrappedBackend = backend;
+}
+
+const std::string &ConnectionParameters::getWrappedBackend() const {
+	return impl->wrappedBackend;
+}
+
+void ConnectionParameters::setSyntheticResult(const SyntheticResult &result) {
+	impl->syntheticResult = result;
+}
+
+const SyntheticResult &ConnectionParameters::getSyntheticResult() const {
+	return impl->syntheticResult;
+}
+
+void ConnectionParameters::setPrefetchDepth(std::size_t depth) {
+	impl->prefetchDepth = depth;
+}
+
+std::size_t ConnectionParameters::getPrefetchDepth() const {
+	return impl->prefetchDepth;
+}
+
+void ConnectionParameters::setNativeTimestamps(bool enabled) {
+	impl->nativeTimestamps = enabled;
+}
+
+bool ConnectionParameters::getNativeTimestamps() const {
+	return impl->nativeTimestamps;
+}
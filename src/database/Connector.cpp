@@ -29,6 +29,7 @@
 #include <map>
 #include <string>
 #include <ecs/database/Exception.hpp>
+#include <ecs/Profiler.hpp>
 
 #ifdef ECS_SQLITE3_DRIVER
 #include <ecs/database/sqlite3/sqlite3.hpp>
@@ -42,6 +43,9 @@
 #include <ecs/database/mariadb/MariaDB.hpp>
 #endif
 
+#include <ecs/database/instrumented/Instrumented.hpp>
+#include <ecs/database/null/Null.hpp>
+
 using namespace ecs::db3;
 
 static std::map<std::string, std::function<ecs::dynlib::Class<ConnectionImpl>()>> staticModuleLoader = {
@@ -49,6 +53,8 @@ static std::map<std::string, std::function<ecs::dynlib::Class<ConnectionImpl>()>
 		 * enabled.
 		 */
 		{"", [](){return ecs::dynlib::Class<ConnectionImpl>();}}
+		,{"instrumented", [](){return ecs::dynlib::Class<ConnectionImpl>(new ecs::db3::InstrumentedConnection());}}
+		,{"null", [](){return ecs::dynlib::Class<ConnectionImpl>(new ecs::db3::NullConnection());}}
 #ifdef ECS_SQLITE3_DRIVER
 		,{"sqlite3", [](){return ecs::dynlib::Class<ConnectionImpl>(new ecs::db3::Sqlite3Connection());}}
 #endif
@@ -70,33 +76,12 @@ ecs::db3::PluginLoader::~PluginLoader() {
 
 DbConnection::ptr_T ecs::db3::PluginLoader::loadPtr(
 		const ConnectionParameters &params) {
-	/* Library object which is loadable */
-	ecs::dynlib::Library::sharedPtr_T library;
-	
 	/* Create a shared pointer of a database connection interface.
 	 * This will contain the implementation which is the
 	 * loadable plugin.
 	 */
 	std::unique_ptr<DbConnection> result(new ecs::db3::DbConnection());
-	ecs::dynlib::Class<ConnectionImpl> module;
-
-	/* Look for builtin modules first */
-	module = staticModuleLoader.at(params.getBackend())();
-
-	if(module) {
-		result->impl->module = module;
-		result->impl->parameters = params;
-		return connect(std::move(result), params);
-	}
-
-	/* The default plugin loading scheme is to look inside
-	* the default plugin directory and open the backend file with
-	* the appropriate extension.
-	*/
-	library = ecs::dynlib::Library::load(params.getPluginDirectory() + "/" + params.getBackend() + params.getPluginExtension());
-
-	/* Create the implementation of the database connection */
-	module  = ecs::dynlib::Library::loadClass<ConnectionImpl>(library, "DatabaseConnection");
+	ecs::dynlib::Class<ConnectionImpl> module = loadModule(params, params.getBackend());
 
 	if(module && result){
 		/* Store implementation because every call needs the implementation */
@@ -110,9 +95,33 @@ DbConnection::ptr_T ecs::db3::PluginLoader::loadPtr(
 	return connect(std::move(result), params);
 }
 
+ecs::dynlib::Class<ConnectionImpl> ecs::db3::PluginLoader::loadModule(
+		const ConnectionParameters &params, const std::string &backend) {
+	/* Look for builtin modules first */
+	auto builtin = staticModuleLoader.find(backend);
+	if(builtin != staticModuleLoader.end() && !backend.empty()) {
+		return builtin->second();
+	}
+
+	/* The default plugin loading scheme is to look inside
+	* the default plugin directory and open the backend file with
+	* the appropriate extension.
+	*/
+	auto library = ecs::dynlib::Library::load(params.getPluginDirectory() + "/" + backend + params.getPluginExtension());
+
+	/* Create the implementation of the database connection */
+	return ecs::dynlib::Library::loadClass<ConnectionImpl>(library, "DatabaseConnection");
+}
+
 DbConnection::ptr_T ecs::db3::PluginLoader::connect(
 		std::unique_ptr<DbConnection> con,
 		const ConnectionParameters &params) {
+	ECS_PROFILE_ZONE("PluginLoader::connect");
+
+	if(params.getStatementMetrics()) {
+		con->impl->module->enableStatementMetrics();
+	}
+
 	/* Connect the database */
 	if(!con->impl->module->connect(params)) {
 		throw exceptions::Exception("Connecting to the database not possible: " + con->impl->module->getErrorMessage());
@@ -0,0 +1,193 @@
+/*
+ * GroupCommit.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <ecs/database/GroupCommit.hpp>
+#include <ecs/database/Exception.hpp>
+#include <exception>
+#include <string>
+#include <vector>
+
+ecs::db3::GroupCommit::GroupCommit(DbConnection::sharedPtr_T connection,
+		std::chrono::microseconds window, std::size_t maxBatch) :
+	connection(std::move(connection)), window(window), maxBatch(maxBatch), batchNumber(0), stop(false) {
+
+	if(!this->connection) {
+		throw exceptions::Exception("Group commit needs a connection");
+	}
+
+	if(this->maxBatch == 0) {
+		this->maxBatch = 1;
+	}
+
+	/* Take the write lock at the start so two writers of the same
+	 * sqlite database never deadlock when upgrading their locks.
+	 */
+	beginQuery = this->connection->locksDatabaseOnWrite() ? "BEGIN IMMEDIATE;" : "BEGIN;";
+	worker     = std::thread(&GroupCommit::run, this);
+}
+
+ecs::db3::GroupCommit::~GroupCommit() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stop = true;
+	}
+	condition.notify_one();
+	worker.join();
+}
+
+std::future<void> ecs::db3::GroupCommit::submit(work_T work) {
+	Submission submission;
+	submission.work = std::move(work);
+	auto result     = submission.promise.get_future();
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		if(stop) {
+			throw exceptions::Exception("Group commit has been stopped");
+		}
+
+		queue.push_back(std::move(submission));
+	}
+	condition.notify_one();
+
+	return result;
+}
+
+ecs::db3::GroupCommitStatistics ecs::db3::GroupCommit::getStatistics() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return statistics;
+}
+
+void ecs::db3::GroupCommit::run() {
+	std::unique_lock<std::mutex> lock(mutex);
+
+	for(;;) {
+		condition.wait(lock, [this](){
+			return stop || !queue.empty();
+		});
+
+		if(queue.empty()) {
+			return;
+		}
+
+		/* Give other writers the chance to join the batch */
+		auto deadline = std::chrono::steady_clock::now() + window;
+		condition.wait_until(lock, deadline, [this](){
+			return stop || queue.size() >= maxBatch;
+		});
+
+		std::deque<Submission> batch;
+		while(!queue.empty() && batch.size() < maxBatch) {
+			batch.push_back(std::move(queue.front()));
+			queue.pop_front();
+		}
+
+		lock.unlock();
+		commitBatch(batch);
+		lock.lock();
+	}
+}
+
+void ecs::db3::GroupCommit::commitBatch(std::deque<Submission> &batch) {
+	std::vector<std::exception_ptr> errors(batch.size());
+	std::uint64_t                   failures = 0;
+
+	auto execute = [this](const std::string &query) {
+		if(!connection->execute(query)) {
+			throw exceptions::Exception("Group commit query failed: " + query);
+		}
+	};
+
+	try {
+		execute(beginQuery);
+	}catch(...) {
+		auto error = std::current_exception();
+		for(auto &submission : batch) {
+			submission.promise.set_exception(error);
+		}
+		return;
+	}
+
+	/* A unique name so a savepoint of the submissions never
+	 * shadows the one of the batch.
+	 */
+	const std::string savepoint = "group_commit_" + std::to_string(++batchNumber);
+	std::exception_ptr groupError;
+
+	for(std::size_t i = 0;i < batch.size() && !groupError;++i) {
+		try {
+			execute("SAVEPOINT " + savepoint + ";");
+			batch[i].work(*connection);
+			execute("RELEASE " + savepoint + ";");
+		}catch(...) {
+			errors[i] = std::current_exception();
+			failures++;
+
+			/* Without the rollback the changes of the failed
+			 * submission would be committed with the others.
+			 */
+			try {
+				execute("ROLLBACK TO " + savepoint + ";");
+				execute("RELEASE " + savepoint + ";");
+			}catch(...) {
+				groupError = std::current_exception();
+			}
+		}
+	}
+
+	if(!groupError) {
+		try {
+			execute("COMMIT;");
+		}catch(...) {
+			groupError = std::current_exception();
+		}
+	}
+
+	if(groupError) {
+		try {
+			connection->execute("ROLLBACK;");
+		}catch(...) {
+			/* Keep the reason the batch failed */
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		statistics.transactions++;
+		statistics.submissions += batch.size();
+		statistics.failures    += groupError ? batch.size() : failures;
+		if(batch.size() > statistics.largestBatch) {
+			statistics.largestBatch = batch.size();
+		}
+	}
+
+	for(std::size_t i = 0;i < batch.size();++i) {
+		if(errors[i]) {
+			batch[i].promise.set_exception(errors[i]);
+		}else if(groupError) {
+			batch[i].promise.set_exception(groupError);
+		}else{
+			batch[i].promise.set_value();
+		}
+	}
+}
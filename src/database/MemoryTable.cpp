@@ -0,0 +1,98 @@
+/*
+ * MemoryTable.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <ecs/database/MemoryTable.hpp>
+#include <ecs/database/Exception.hpp>
+
+using namespace ecs::db3;
+
+ecs::db3::MemoryTable::~MemoryTable() {
+
+}
+
+std::int64_t ecs::db3::MemoryTable::getInt64(std::size_t row, std::size_t column) const {
+	return 0;
+}
+
+double ecs::db3::MemoryTable::getDouble(std::size_t row, std::size_t column) const {
+	return 0.0;
+}
+
+std::string_view ecs::db3::MemoryTable::getText(std::size_t row, std::size_t column) const {
+	return std::string_view();
+}
+
+ColumnBatch &ecs::db3::ColumnBatch::column(const std::string &name,
+		const std::vector<std::int64_t> &values, bool sorted) {
+	Values columnValues;
+	columnValues.int64s = &values;
+	addColumn(name, types::typeId::int64_T, sorted, values.size(), columnValues);
+	return *this;
+}
+
+ColumnBatch &ecs::db3::ColumnBatch::column(const std::string &name,
+		const std::vector<double> &values, bool sorted) {
+	Values columnValues;
+	columnValues.doubles = &values;
+	addColumn(name, types::typeId::double_T, sorted, values.size(), columnValues);
+	return *this;
+}
+
+ColumnBatch &ecs::db3::ColumnBatch::column(const std::string &name,
+		const std::vector<std::string> &values, bool sorted) {
+	Values columnValues;
+	columnValues.texts = &values;
+	addColumn(name, types::typeId::string, sorted, values.size(), columnValues);
+	return *this;
+}
+
+void ecs::db3::ColumnBatch::addColumn(const std::string &name, types::typeId type,
+		bool sorted, std::size_t columnSize, Values columnValues) {
+	if(!columns.empty() && columnSize != rows) {
+		throw exceptions::Exception("Column " + name + " has " + std::to_string(columnSize) +
+				" values but the batch has " + std::to_string(rows) + " rows");
+	}
+
+	rows = columnSize;
+	columns.push_back(MemoryColumn{name, type, sorted});
+	values.push_back(columnValues);
+}
+
+const std::vector<MemoryColumn> &ecs::db3::ColumnBatch::getColumns() const {
+	return columns;
+}
+
+std::size_t ecs::db3::ColumnBatch::size() const {
+	return rows;
+}
+
+std::int64_t ecs::db3::ColumnBatch::getInt64(std::size_t row, std::size_t column) const {
+	return (*values[column].int64s)[row];
+}
+
+double ecs::db3::ColumnBatch::getDouble(std::size_t row, std::size_t column) const {
+	return (*values[column].doubles)[row];
+}
+
+std::string_view ecs::db3::ColumnBatch::getText(std::size_t row, std::size_t column) const {
+	return (*values[column].texts)[row];
+}
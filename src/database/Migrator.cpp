@@ -68,6 +68,10 @@ int Migrator::startMigration() {
 	Migration::ptr_T          migration;
 	auto migrator = connection->getMigrator();
 	int migrationCounter = 0;
+
+	if(!migrator) {
+		throw exceptions::Exception("Migrator not implemented");
+	}
 	
 	/* Do migrations until there is no migration left */
 	while((migration = getMigration(migrator->getSchemaVersion())) != nullptr) {
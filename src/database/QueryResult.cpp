@@ -23,6 +23,7 @@
 #include <ecs/database/QueryResult.hpp>
 #include <ecs/database/Connection.hpp>
 #include <ecs/database/Exception.hpp>
+#include <ecs/Profiler.hpp>
 #include "impl/ResultImpl.cpp"
 #include <ecs/database/impl/StatementInternals.hpp>
 #include <utility>
@@ -48,10 +49,16 @@ std::string ecs::db3::Result::getErrorMessage() const {
 }
 
 ecs::db3::RowResult ecs::db3::Result::fetch() {
+	ECS_PROFILE_ZONE("Result::fetch");
+
 	return RowResult(impl->stmt->fetch());
 }
 
 TableResult ecs::db3::Result::fetchAll() {
+	if(impl->stmt->fetchAll(*impl->resultTable)) {
+		return TableResult(std::move(impl->resultTable));
+	}
+
 	RowResult row;
 
 	while(row = this->fetch()) {
@@ -61,6 +68,40 @@ TableResult ecs::db3::Result::fetchAll() {
 	return TableResult(std::move(impl->resultTable));
 }
 
+TableResult ecs::db3::Result::fetchAll(const std::vector<std::string> &encodedColumns) {
+	auto table = dynamic_cast<Table*>(impl->resultTable.get());
+
+	if(table == nullptr) {
+		throw exceptions::Exception("Fetching from an invalid result");
+	}
+
+	for(auto &name : encodedColumns) {
+		auto column = std::find(table->columnNames.begin(), table->columnNames.end(), name);
+		if(column == table->columnNames.end()) {
+			throw exceptions::Exception("Unknown column " + name);
+		}
+		table->encodeColumn(static_cast<int>(column - table->columnNames.begin()));
+	}
+
+	return fetchAll();
+}
+
+std::future<TableResult> ecs::db3::Result::fetchAllAsync() {
+	if(!impl) {
+		throw exceptions::Exception("Fetching from an invalid result");
+	}
+
+	auto  stmt     = impl->stmt;
+	auto &executor = stmt->impl->connection->module->getExecutor();
+	auto  result   = std::make_shared<Result>(std::move(*this));
+
+	stmt->impl->pendingTasks++;
+	return executor.submit([stmt, result](){
+		PendingTask pending(stmt->impl->pendingTasks);
+		return result->fetchAll();
+	});
+}
+
 void ecs::db3::Result::clear() {
 	if(impl) impl->resultTable.reset();
 }
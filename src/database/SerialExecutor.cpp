@@ -0,0 +1,110 @@
+/*
+ * SerialExecutor.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <ecs/database/SerialExecutor.hpp>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+/** Shared between the executor and the worker so the worker can
+ * finish safely when the executor is destroyed by one of its own
+ * tasks.
+ */
+struct ecs::db3::SerialExecutor::State {
+	std::mutex               mutex;
+	std::condition_variable  condition;
+	std::deque<task_T>       tasks;
+	bool                     stop = false;
+	std::thread::id          workerId;
+};
+
+ecs::db3::SerialExecutor::SerialExecutor() : state(std::make_shared<State>()) {
+	std::lock_guard<std::mutex> lock(state->mutex);
+	worker          = std::thread(&SerialExecutor::run, state);
+	state->workerId = worker.get_id();
+}
+
+ecs::db3::SerialExecutor::~SerialExecutor() {
+	{
+		std::lock_guard<std::mutex> lock(state->mutex);
+		state->stop = true;
+	}
+	state->condition.notify_one();
+
+	/* The last task may hold the last reference to the owner */
+	if(isWorkerThread()) {
+		worker.detach();
+	}else{
+		worker.join();
+	}
+}
+
+void ecs::db3::SerialExecutor::post(task_T task) {
+	if(isWorkerThread()) {
+		try {
+			task();
+		}catch(...) {
+
+		}
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(state->mutex);
+		state->tasks.push_back(std::move(task));
+	}
+	state->condition.notify_one();
+}
+
+bool ecs::db3::SerialExecutor::isWorkerThread() const {
+	return std::this_thread::get_id() == state->workerId;
+}
+
+void ecs::db3::SerialExecutor::run(std::shared_ptr<State> state) {
+	std::unique_lock<std::mutex> lock(state->mutex);
+
+	for(;;) {
+		state->condition.wait(lock, [&](){
+			return state->stop || !state->tasks.empty();
+		});
+
+		if(state->tasks.empty()) {
+			return;
+		}
+
+		auto task = std::move(state->tasks.front());
+		state->tasks.pop_front();
+		lock.unlock();
+
+		try {
+			task();
+		}catch(...) {
+
+		}
+
+		/* Destroy the task before locking again because it may
+		 * destroy the executor.
+		 */
+		task = nullptr;
+		lock.lock();
+	}
+}
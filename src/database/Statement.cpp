@@ -28,7 +28,7 @@
 #include <functional>
 #include <exception>
 #include <ecs/database/Exception.hpp>
-
+#include <ecs/Profiler.hpp>
 
 ecs::db3::Statement::Statement(DbConnection *connection) {
 	impl = new StatementInternals(connection);
@@ -39,6 +39,7 @@ ecs::db3::Statement::~Statement() {
 }
 
 void ecs::db3::Statement::reset() {
+	checkOwner();
 	impl->stmt->reset();
 	impl->bindings.clear();
 }
@@ -49,6 +50,10 @@ std::string ecs::db3::Statement::getErrorMessage() const {
 
 
 ecs::db3::Result ecs::db3::Statement::execute() {
+	ECS_PROFILE_ZONE("Statement::execute");
+
+	checkOwner();
+
 	/* Create the new table which is then passed to
 	 * the module.
 	 */
@@ -58,7 +63,13 @@ ecs::db3::Result ecs::db3::Statement::execute() {
 	Result result(shared_from_this());
 
 	/* Execute SQL statement */
-	auto rc = impl->stmt->execute(resultTable.get());
+	auto start = StatementMetrics::clock_T::now();
+	auto rc    = impl->stmt->execute(resultTable.get());
+
+	if(impl->metrics) {
+		impl->metrics->recordExecute(impl->metricsId, StatementMetrics::clock_T::now() - start,
+				rc == 0, impl->stmt->takeBusyRetries());
+	}
 	
 	/* Get the result table. This may be empty. */
 	result.impl->resultTable = std::move(resultTable);
@@ -77,18 +88,41 @@ std::unique_ptr<ecs::db3::Result> ecs::db3::Statement::executePtr() {
 	return std::make_unique<ecs::db3::Result>(std::move(execute()));
 }
 
+std::future<ecs::db3::Result> ecs::db3::Statement::executeAsync() {
+	checkOwner();
+
+	/* The task keeps the statement and with it the connection alive */
+	auto  self     = shared_from_this();
+	auto &executor = impl->connection->module->getExecutor();
+
+	impl->pendingTasks++;
+	return executor.submit([self](){
+		PendingTask pending(self->impl->pendingTasks);
+		return self->execute();
+	});
+}
+
+void ecs::db3::Statement::checkOwner() const {
+	if(impl->pendingTasks.load() > 0 && !impl->connection->module->getExecutor().isWorkerThread()) {
+		throw exceptions::Exception("The statement is in use by an asynchronous execution");
+	}
+}
+
 void ecs::db3::Statement::clearBindings() {
+	checkOwner();
 	impl->bindings.clear();
 }
 
 bool ecs::db3::Statement::bind(ecs::db3::types::cell_T::ptr_T ptr) {
 	auto binding = ecs::db3::types::cell_T::uniquePtr_T(ptr);
+	checkOwner();
 	bool rc = impl->stmt->bind(ptr, nullptr, impl->bindings.size());
 	impl->bindings.push_back(std::move(binding));
 	return rc;
 }
 
 bool ecs::db3::Statement::bind(ecs::db3::types::cell_T::uniquePtr_T &&ptr) {
+	checkOwner();
 	bool rc = impl->stmt->bind(ptr.get(), nullptr, impl->bindings.size());
 	impl->bindings.push_back(std::move(ptr));
 	return rc;
@@ -129,6 +163,16 @@ bool ecs::db3::Statement::bind(float value) {
 	return bind(ecs::tools::any::make<types::Float>(value));
 }
 
+bool ecs::db3::Statement::bind(const ecs::time::Timestamp &value) {
+	using namespace ecs::db3::types;
+	return bind(ecs::tools::any::make<types::Timestamp>(value));
+}
+
+bool ecs::db3::Statement::bind(const ecs::tools::UUID &value) {
+	using namespace ecs::db3::types;
+	return bind(ecs::tools::any::make<types::Uuid>(value));
+}
+
 bool ecs::db3::Statement::bind(
 		std::unique_ptr<std::basic_istream<char> > stream) {
 
@@ -158,5 +202,37 @@ std::int64_t ecs::db3::Statement::lastInsertId() {
 }
 
 ecs::db3::Row::uniquePtr_T ecs::db3::Statement::fetch() {
-	return impl->stmt->fetch();
+	ECS_PROFILE_ZONE("Statement::fetch");
+
+	if(!impl->metrics) {
+		return impl->stmt->fetch();
+	}
+
+	auto start = StatementMetrics::clock_T::now();
+	auto row   = impl->stmt->fetch();
+	impl->metrics->recordFetch(impl->metricsId, StatementMetrics::clock_T::now() - start,
+			row ? 1 : 0, row ? StatementMetrics::estimateBytes(*row) : 0, impl->stmt->takeBusyRetries());
+	return row;
+}
+
+bool ecs::db3::Statement::fetchAll(TableBase &table) {
+	ECS_PROFILE_ZONE("Statement::fetchAll");
+
+	if(!impl->metrics) {
+		return impl->stmt->fetchAll(table);
+	}
+
+	auto start = StatementMetrics::clock_T::now();
+	auto first = table.size();
+	if(!impl->stmt->fetchAll(table)) {
+		return false;
+	}
+
+	auto elapsed = StatementMetrics::clock_T::now() - start;
+	std::uint64_t bytes = 0;
+	for(auto i = first;i < table.size();i++) {
+		bytes += StatementMetrics::estimateBytes(table[static_cast<int>(i)]);
+	}
+	impl->metrics->recordFetch(impl->metricsId, elapsed, table.size() - first, bytes, impl->stmt->takeBusyRetries());
+	return true;
 }
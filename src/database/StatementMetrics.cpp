@@ -0,0 +1,542 @@
+/*
+ * StatementMetrics.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <ecs/database/StatementMetrics.hpp>
+#include <ecs/database/Row.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <iterator>
+#include <map>
+#include <sstream>
+
+namespace {
+
+/** Only the owning thread writes so a load and a store are
+ * enough and no locked instruction is needed.
+ */
+inline void add(std::atomic<std::uint64_t> &counter, std::uint64_t value) {
+	counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+inline std::size_t highestBit(std::uint64_t value) {
+	std::size_t result = 0;
+	while(value >>= 1) {
+		result++;
+	}
+	return result;
+}
+
+std::atomic<std::uint64_t> nextInstance{1};
+
+/** Incremented by every destroyed instance so the threads know
+ * when to prune their shard maps.
+ */
+std::atomic<std::uint64_t> destroyedInstances{0};
+
+/** Bounds of the exported Prometheus histograms in seconds */
+const double exportBounds[] = {
+	0.00001, 0.000025, 0.00005, 0.0001, 0.00025, 0.0005, 0.001, 0.0025,
+	0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0
+};
+
+std::string escapeLabel(const std::string &value) {
+	std::string result;
+	result.reserve(value.size());
+	for(auto c : value) {
+		if(c == '\\') {
+			result += "\\\\";
+		}else if(c == '"') {
+			result += "\\\"";
+		}else if(c == '\n') {
+			result += "\\n";
+		}else{
+			result += c;
+		}
+	}
+	return result;
+}
+
+std::string seconds(std::uint64_t nanoseconds) {
+	std::ostringstream stream;
+	stream.imbue(std::locale::classic());
+	stream << static_cast<double>(nanoseconds) / 1e9;
+	return stream.str();
+}
+
+void writeHeader(std::ostringstream &stream, const char *name, const char *type, const char *help) {
+	stream << "# HELP " << name << ' ' << help << '\n';
+	stream << "# TYPE " << name << ' ' << type << '\n';
+}
+
+}
+
+void ecs::db3::LatencyHistogram::record(std::uint64_t nanoseconds) {
+	buckets[bucketIndex(nanoseconds)]++;
+	count++;
+	sum += nanoseconds;
+	max  = std::max(max, nanoseconds);
+}
+
+void ecs::db3::LatencyHistogram::merge(const LatencyHistogram &other) {
+	for(std::size_t i = 0;i < bucketCount;i++) {
+		buckets[i] += other.buckets[i];
+	}
+	count += other.count;
+	sum   += other.sum;
+	max    = std::max(max, other.max);
+}
+
+std::uint64_t ecs::db3::LatencyHistogram::getCount() const {
+	return count;
+}
+
+std::uint64_t ecs::db3::LatencyHistogram::getSum() const {
+	return sum;
+}
+
+std::uint64_t ecs::db3::LatencyHistogram::getMax() const {
+	return max;
+}
+
+std::uint64_t ecs::db3::LatencyHistogram::percentile(double fraction) const {
+	if(count == 0) {
+		return 0;
+	}
+
+	fraction = std::min(std::max(fraction, 0.0), 1.0);
+	auto rank = static_cast<std::uint64_t>(std::ceil(fraction * static_cast<double>(count)));
+	rank      = std::max<std::uint64_t>(rank, 1);
+
+	std::uint64_t seen = 0;
+	for(std::size_t i = 0;i < bucketCount;i++) {
+		seen += buckets[i];
+		if(seen >= rank) {
+			return std::min(bucketUpperBound(i), max);
+		}
+	}
+	return max;
+}
+
+std::uint64_t ecs::db3::LatencyHistogram::countAtMost(std::uint64_t nanoseconds) const {
+	std::uint64_t result = 0;
+	for(std::size_t i = 0;i < bucketCount && bucketUpperBound(i) <= nanoseconds;i++) {
+		result += buckets[i];
+	}
+	return result;
+}
+
+const ecs::db3::LatencyHistogram::buckets_T &ecs::db3::LatencyHistogram::getBuckets() const {
+	return buckets;
+}
+
+std::size_t ecs::db3::LatencyHistogram::bucketIndex(std::uint64_t nanoseconds) {
+	/* The first two powers of two are stored exactly */
+	if(nanoseconds < 2 * subBuckets) {
+		return static_cast<std::size_t>(nanoseconds);
+	}
+
+	auto exponent = highestBit(nanoseconds);
+	if(exponent > maxExponent) {
+		return bucketCount - 1;
+	}
+
+	auto subBucket = (nanoseconds >> (exponent - subBucketBits)) & (subBuckets - 1);
+	return 2 * subBuckets + (exponent - subBucketBits - 1) * subBuckets + static_cast<std::size_t>(subBucket);
+}
+
+std::uint64_t ecs::db3::LatencyHistogram::bucketUpperBound(std::size_t index) {
+	if(index < 2 * subBuckets) {
+		return index;
+	}
+
+	auto offset    = index - 2 * subBuckets;
+	auto exponent  = offset / subBuckets + subBucketBits + 1;
+	auto subBucket = static_cast<std::uint64_t>(offset % subBuckets);
+	auto width     = std::uint64_t(1) << (exponent - subBucketBits);
+	return (std::uint64_t(1) << exponent) + subBucket * width + width - 1;
+}
+
+/** Counters of one statement in one shard. Only the thread owning
+ * the shard writes them.
+ */
+struct ecs::db3::StatementMetrics::Counters {
+	explicit Counters(std::size_t statement) : statement(statement) {
+
+	}
+
+	struct Histogram {
+		std::array<std::atomic<std::uint64_t>, LatencyHistogram::bucketCount> buckets{};
+		std::atomic<std::uint64_t> sum{0};
+		std::atomic<std::uint64_t> max{0};
+
+		void record(std::chrono::nanoseconds duration) {
+			auto value = static_cast<std::uint64_t>(std::max<std::int64_t>(duration.count(), 0));
+			add(buckets[LatencyHistogram::bucketIndex(value)], 1);
+			add(sum, value);
+			if(value > max.load(std::memory_order_relaxed)) {
+				max.store(value, std::memory_order_relaxed);
+			}
+		}
+
+		void mergeInto(LatencyHistogram &histogram) const {
+			LatencyHistogram copy;
+			for(std::size_t i = 0;i < LatencyHistogram::bucketCount;i++) {
+				copy.buckets[i] = buckets[i].load(std::memory_order_relaxed);
+				copy.count     += copy.buckets[i];
+			}
+			copy.sum = sum.load(std::memory_order_relaxed);
+			copy.max = max.load(std::memory_order_relaxed);
+			histogram.merge(copy);
+		}
+	};
+
+	const std::size_t           statement;
+	Counters                   *next = nullptr;
+	std::atomic<std::uint64_t>  prepares{0};
+	std::atomic<std::uint64_t>  prepareNanoseconds{0};
+	std::atomic<std::uint64_t>  binds{0};
+	std::atomic<std::uint64_t>  bindNanoseconds{0};
+	std::atomic<std::uint64_t>  executions{0};
+	std::atomic<std::uint64_t>  errors{0};
+	std::atomic<std::uint64_t>  rows{0};
+	std::atomic<std::uint64_t>  bytes{0};
+	std::atomic<std::uint64_t>  busyRetries{0};
+	Histogram                   execute;
+	Histogram                   fetch;
+};
+
+/** Counters recorded by one thread. New counters are pushed to the
+ * front of the list so readers can walk it without a lock.
+ */
+struct ecs::db3::StatementMetrics::Shard {
+	~Shard() {
+		auto current = counters.load();
+		while(current) {
+			auto next = current->next;
+			delete current;
+			current = next;
+		}
+	}
+
+	Shard                                       *next = nullptr;
+	std::atomic<Counters*>                       counters{nullptr};
+	/** Only used by the owning thread */
+	std::unordered_map<std::size_t, Counters*>   lookup;
+};
+
+ecs::db3::StatementMetrics::StatementMetrics() : instance(nextInstance++),
+		lifetime(std::make_shared<bool>(true)), shards(nullptr) {
+
+}
+
+ecs::db3::StatementMetrics::~StatementMetrics() {
+	/* Expire before counting so a pruning thread sees the instance gone */
+	lifetime.reset();
+	destroyedInstances.fetch_add(1, std::memory_order_release);
+
+	auto current = shards.load();
+	while(current) {
+		auto next = current->next;
+		delete current;
+		current = next;
+	}
+}
+
+std::string ecs::db3::StatementMetrics::normalize(const std::string &query) {
+	std::string result;
+	result.reserve(query.size());
+
+	auto isWord = [](char c) {
+		return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$';
+	};
+
+	bool        space = false;
+	std::size_t i     = 0;
+	while(i < query.size()) {
+		auto c = query[i];
+
+		if(std::isspace(static_cast<unsigned char>(c))) {
+			space = true;
+			i++;
+			continue;
+		}
+
+		if(space && !result.empty()) {
+			result += ' ';
+		}
+		space = false;
+
+		if(c == '\'') {
+			/* String literal with '' as escaped quote */
+			i++;
+			while(i < query.size()) {
+				if(query[i] == '\'' && (i + 1 >= query.size() || query[i + 1] != '\'')) {
+					break;
+				}
+				i += query[i] == '\'' ? 2 : 1;
+			}
+			result += '?';
+			i++;
+		}else if(c == '"' || c == '`') {
+			/* Quoted identifiers are kept */
+			auto end = query.find(c, i + 1);
+			end      = end == std::string::npos ? query.size() : end + 1;
+			result.append(query, i, end - i);
+			i = end;
+		}else if(std::isdigit(static_cast<unsigned char>(c)) && (result.empty() || !isWord(result.back()))) {
+			/* Number literal which is not part of a name */
+			while(i < query.size() && (isWord(query[i]) || query[i] == '.')) {
+				i++;
+			}
+			result += '?';
+		}else{
+			result += c;
+			i++;
+		}
+	}
+
+	return result;
+}
+
+std::size_t ecs::db3::StatementMetrics::getStatementId(const std::string &query) {
+	auto normalized = normalize(query);
+
+	std::scoped_lock lock(statementsMutex);
+	auto it = statementIds.find(normalized);
+	if(it != statementIds.end()) {
+		return it->second;
+	}
+
+	statements.push_back(normalized);
+	statementIds.emplace(std::move(normalized), statements.size() - 1);
+	return statements.size() - 1;
+}
+
+ecs::db3::StatementMetrics::Counters &ecs::db3::StatementMetrics::getCounters(std::size_t statement) {
+	/* The shard of a thread is found by the instance id because the
+	 * address of a destroyed instance may be reused. The shards of
+	 * destroyed instances are deleted with them so their entries are
+	 * dropped once another instance was destroyed.
+	 */
+	struct ThreadShard {
+		std::weak_ptr<const bool> lifetime;
+		Shard                    *shard = nullptr;
+	};
+	thread_local std::unordered_map<std::uint64_t, ThreadShard> threadShards;
+	thread_local std::uint64_t seenDestroyed = 0;
+	thread_local std::uint64_t lastInstance  = 0;
+	thread_local Shard        *lastShard     = nullptr;
+
+	Shard *shard = lastShard;
+	if(lastInstance != instance) {
+		auto destroyed = destroyedInstances.load(std::memory_order_acquire);
+		if(destroyed != seenDestroyed) {
+			seenDestroyed = destroyed;
+			for(auto it = threadShards.begin();it != threadShards.end();) {
+				it = it->second.lifetime.expired() ? threadShards.erase(it) : std::next(it);
+			}
+		}
+
+		auto &entry = threadShards[instance];
+		if(!entry.shard) {
+			entry.lifetime    = lifetime;
+			entry.shard       = new Shard;
+			entry.shard->next = shards.load(std::memory_order_relaxed);
+			while(!shards.compare_exchange_weak(entry.shard->next, entry.shard, std::memory_order_release, std::memory_order_relaxed));
+		}
+		lastInstance = instance;
+		lastShard    = entry.shard;
+		shard        = entry.shard;
+	}
+
+	auto it = shard->lookup.find(statement);
+	if(it != shard->lookup.end()) {
+		return *it->second;
+	}
+
+	auto counters  = new Counters(statement);
+	counters->next = shard->counters.load(std::memory_order_relaxed);
+	shard->counters.store(counters, std::memory_order_release);
+	shard->lookup.emplace(statement, counters);
+	return *counters;
+}
+
+void ecs::db3::StatementMetrics::recordPrepare(std::size_t statement, std::chrono::nanoseconds duration) {
+	auto &counters = getCounters(statement);
+	add(counters.prepares, 1);
+	add(counters.prepareNanoseconds, static_cast<std::uint64_t>(std::max<std::int64_t>(duration.count(), 0)));
+}
+
+void ecs::db3::StatementMetrics::recordBind(std::size_t statement, std::chrono::nanoseconds duration, bool succeeded) {
+	auto &counters = getCounters(statement);
+	add(counters.binds, 1);
+	add(counters.bindNanoseconds, static_cast<std::uint64_t>(std::max<std::int64_t>(duration.count(), 0)));
+	if(!succeeded) {
+		add(counters.errors, 1);
+	}
+}
+
+void ecs::db3::StatementMetrics::recordExecute(std::size_t statement, std::chrono::nanoseconds duration,
+		bool succeeded, std::uint64_t busyRetries) {
+	auto &counters = getCounters(statement);
+	add(counters.executions, 1);
+	if(!succeeded) {
+		add(counters.errors, 1);
+	}
+	if(busyRetries) {
+		add(counters.busyRetries, busyRetries);
+	}
+	counters.execute.record(duration);
+}
+
+void ecs::db3::StatementMetrics::recordFetch(std::size_t statement, std::chrono::nanoseconds duration,
+		std::uint64_t rows, std::uint64_t bytes, std::uint64_t busyRetries) {
+	auto &counters = getCounters(statement);
+	add(counters.rows, rows);
+	add(counters.bytes, bytes);
+	if(busyRetries) {
+		add(counters.busyRetries, busyRetries);
+	}
+	counters.fetch.record(duration);
+}
+
+std::uint64_t ecs::db3::StatementMetrics::estimateBytes(RowBase &row) {
+	using namespace ecs::db3::types;
+
+	std::uint64_t result = 0;
+	for(decltype(row.size()) i = 0;i < row.size();++i) {
+		auto &cell = row[i];
+		if(!cell.has_value()) {
+			continue;
+		}
+
+		switch(cell.getTypeId()) {
+		case typeId::string:
+			result += cell.cast_reference<String::type>().size();
+			break;
+		case typeId::int64_T:
+		case typeId::uint64_T:
+		case typeId::double_T:
+		case typeId::timestamp:
+			result += 8;
+			break;
+		case typeId::float_T:
+			result += 4;
+			break;
+		case typeId::boolean_T:
+			result += 1;
+			break;
+		case typeId::uuid:
+			result += 16;
+			break;
+		default:
+			break;
+		}
+	}
+	return result;
+}
+
+std::vector<ecs::db3::StatementStatistics> ecs::db3::StatementMetrics::getStatistics() const {
+	std::map<std::size_t, StatementStatistics> merged;
+
+	for(auto shard = shards.load(std::memory_order_acquire);shard;shard = shard->next) {
+		for(auto counters = shard->counters.load(std::memory_order_acquire);counters;counters = counters->next) {
+			auto &statistics = merged[counters->statement];
+			statistics.prepares           += counters->prepares.load(std::memory_order_relaxed);
+			statistics.prepareNanoseconds += counters->prepareNanoseconds.load(std::memory_order_relaxed);
+			statistics.binds              += counters->binds.load(std::memory_order_relaxed);
+			statistics.bindNanoseconds    += counters->bindNanoseconds.load(std::memory_order_relaxed);
+			statistics.executions         += counters->executions.load(std::memory_order_relaxed);
+			statistics.errors             += counters->errors.load(std::memory_order_relaxed);
+			statistics.rows               += counters->rows.load(std::memory_order_relaxed);
+			statistics.bytes              += counters->bytes.load(std::memory_order_relaxed);
+			statistics.busyRetries        += counters->busyRetries.load(std::memory_order_relaxed);
+			counters->execute.mergeInto(statistics.execute);
+			counters->fetch.mergeInto(statistics.fetch);
+		}
+	}
+
+	std::vector<StatementStatistics> result;
+	result.reserve(merged.size());
+	{
+		std::scoped_lock lock(statementsMutex);
+		for(auto &entry : merged) {
+			entry.second.statement = statements.at(entry.first);
+			result.push_back(std::move(entry.second));
+		}
+	}
+
+	std::sort(result.begin(), result.end(), [](const StatementStatistics &a, const StatementStatistics &b){
+		return a.statement < b.statement;
+	});
+	return result;
+}
+
+std::string ecs::db3::StatementMetrics::dumpPrometheus() const {
+	auto statistics = getStatistics();
+
+	std::ostringstream stream;
+	stream.imbue(std::locale::classic());
+
+	auto counter = [&](const char *name, const char *help, std::uint64_t StatementStatistics::*member) {
+		writeHeader(stream, name, "counter", help);
+		for(auto &entry : statistics) {
+			stream << name << "{statement=\"" << escapeLabel(entry.statement) << "\"} " << entry.*member << '\n';
+		}
+	};
+
+	auto histogram = [&](const char *name, const char *help, LatencyHistogram StatementStatistics::*member) {
+		writeHeader(stream, name, "histogram", help);
+		for(auto &entry : statistics) {
+			auto &values = entry.*member;
+			auto  label  = escapeLabel(entry.statement);
+			for(auto bound : exportBounds) {
+				stream << name << "_bucket{statement=\"" << label << "\",le=\"" << bound << "\"} "
+						<< values.countAtMost(static_cast<std::uint64_t>(bound * 1e9)) << '\n';
+			}
+			stream << name << "_bucket{statement=\"" << label << "\",le=\"+Inf\"} " << values.getCount() << '\n';
+			stream << name << "_sum{statement=\"" << label << "\"} " << seconds(values.getSum()) << '\n';
+			stream << name << "_count{statement=\"" << label << "\"} " << values.getCount() << '\n';
+		}
+	};
+
+	counter("ecs_db_statement_prepares_total", "Number of prepared statements.", &StatementStatistics::prepares);
+
+	writeHeader(stream, "ecs_db_statement_prepare_seconds_total", "counter", "Time spent preparing statements.");
+	for(auto &entry : statistics) {
+		stream << "ecs_db_statement_prepare_seconds_total{statement=\"" << escapeLabel(entry.statement) << "\"} "
+				<< seconds(entry.prepareNanoseconds) << '\n';
+	}
+
+	counter("ecs_db_statement_binds_total", "Number of bound parameters.", &StatementStatistics::binds);
+	counter("ecs_db_statement_executions_total", "Number of statement executions.", &StatementStatistics::executions);
+	counter("ecs_db_statement_errors_total", "Number of failed statement executions and bindings.", &StatementStatistics::errors);
+	counter("ecs_db_statement_rows_total", "Number of fetched rows.", &StatementStatistics::rows);
+	counter("ecs_db_statement_fetched_bytes_total", "Estimated size of the fetched values.", &StatementStatistics::bytes);
+	counter("ecs_db_statement_busy_retries_total", "Retries because the database was locked.", &StatementStatistics::busyRetries);
+	histogram("ecs_db_statement_execute_seconds", "Latency of statement executions.", &StatementStatistics::execute);
+	histogram("ecs_db_statement_fetch_seconds", "Latency of single row fetches.", &StatementStatistics::fetch);
+
+	return stream.str();
+}
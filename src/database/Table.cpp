@@ -33,15 +33,20 @@ ecs::db3::Table::~Table() {
 
 void ecs::db3::Table::clear() {
 	data.clear();
+	for(auto &encoded : encodedColumns) {
+		encoded.codes.clear();
+	}
 }
 
 RowBase& ecs::db3::Table::operator <<(RowBase::ptr_T row) {
 	data.push_back(RowBase::uniquePtr_T(row));
+	encodeRow(*row);
 	return *row;
 }
 
 RowBase &Table::operator<< ( RowBase::uniquePtr_T row ) {
 	data.push_back(std::move(row));
+	encodeRow(*data.back());
 	return *data.back();
 }
 
@@ -71,6 +76,96 @@ RowBase& ecs::db3::Table::at(int n) const {
 	return (*this)[n];
 }
 
+std::string_view ecs::db3::TableBase::getText(int row, int column) const {
+	return at(row).at(column).cast_reference<std::string>();
+}
+
+bool ecs::db3::TableBase::isEncoded(int /*column*/) const {
+	return false;
+}
+
+void ecs::db3::Table::encodeColumn(int column) {
+	if(findEncoded(column) != nullptr) {
+		return;
+	}
+
+	EncodedColumn encoded;
+	encoded.column = column;
+	encoded.codes.reserve(data.size());
+	for(auto &row : data) {
+		encoded.codes.push_back(column < static_cast<int>(row->size()) ? encodeCell(row->at(column)) : noCode);
+	}
+
+	encodedColumns.push_back(std::move(encoded));
+}
+
+bool ecs::db3::Table::isEncoded(int column) const {
+	return findEncoded(column) != nullptr;
+}
+
+std::string_view ecs::db3::Table::getText(int row, int column) const {
+	auto encoded = findEncoded(column);
+
+	if(encoded != nullptr && encoded->codes.at(row) != noCode) {
+		return dictionary[encoded->codes[row]];
+	}
+
+	return TableBase::getText(row, column);
+}
+
+std::uint32_t ecs::db3::Table::getCode(int row, int column) const {
+	auto encoded = findEncoded(column);
+	return encoded != nullptr ? encoded->codes.at(row) : noCode;
+}
+
+std::string_view ecs::db3::Table::getDictionaryValue(std::uint32_t code) const {
+	return dictionary.at(code);
+}
+
+std::size_t ecs::db3::Table::getDictionarySize() const {
+	return dictionary.size();
+}
+
+std::uint32_t ecs::db3::Table::encodeCell(types::cell_T &cell) {
+	if(cell.getTypeId() != types::typeId::string || !cell.has_value()) {
+		return noCode;
+	}
+
+	auto &text     = cell.cast_reference<std::string>();
+	auto  existing = dictionaryCodes.find(text);
+	std::uint32_t code;
+
+	if(existing != dictionaryCodes.end()) {
+		code = existing->second;
+	}else if(dictionary.size() < noCode) {
+		code = static_cast<std::uint32_t>(dictionary.size());
+		dictionary.push_back(std::move(text));
+		dictionaryCodes.emplace(dictionary.back(), code);
+	}else{
+		/* The dictionary is full so the text stays in the cell */
+		return noCode;
+	}
+
+	cell = types::cell_T(nullptr, types::typeId::dictionary);
+	return code;
+}
+
+void ecs::db3::Table::encodeRow(RowBase &row) {
+	for(auto &encoded : encodedColumns) {
+		encoded.codes.push_back(encoded.column < static_cast<int>(row.size()) ? encodeCell(row.at(encoded.column)) : noCode);
+	}
+}
+
+const ecs::db3::Table::EncodedColumn *ecs::db3::Table::findEncoded(int column) const {
+	for(auto &encoded : encodedColumns) {
+		if(encoded.column == column) {
+			return &encoded;
+		}
+	}
+
+	return nullptr;
+}
+
 ecs::db3::TableResult::TableResult(TableBase::uniquePtr_T impl) : impl(std::move(impl)) {
 
 }
@@ -91,6 +186,14 @@ const std::string& ecs::db3::TableResult::getColumnName(int n) const {
 	return impl->getColumnName(n);
 }
 
+std::string_view ecs::db3::TableResult::getText(int row, int column) const {
+	return impl->getText(row, column);
+}
+
+bool ecs::db3::TableResult::isEncoded(int column) const {
+	return impl->isEncoded(column);
+}
+
 ecs::db3::TableResult::operator bool() const {
 	return impl.get() != nullptr;
 }
@@ -0,0 +1,244 @@
+/*
+ * WriteBehindTable.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <ecs/database/WriteBehindTable.hpp>
+#include <ecs/database/Exception.hpp>
+
+ecs::db3::WriteBehindTable::WriteBehindTable(DbConnection::sharedPtr_T connection,
+		const std::string &insertQuery, std::size_t capacity, std::size_t batchSize,
+		std::chrono::milliseconds maxAge, bool drainOnTermination) :
+	connection(std::move(connection)), buffer(capacity), batchSize(batchSize > 0 ? batchSize : 1), maxAge(maxAge),
+	closed(false), appended(0), processed(0), rowsWritten(0), rowsFailed(0), rowsRejected(0), flushes(0),
+	flushRequested(false), stop(false) {
+
+	if(!this->connection) {
+		throw exceptions::Exception("Write behind table needs a connection");
+	}
+
+	statement = this->connection->prepare(insertQuery);
+
+	if(drainOnTermination) {
+		signals = std::make_unique<ecs::tools::SignalHandler>();
+	}
+
+	worker = std::thread(&WriteBehindTable::run, this);
+}
+
+ecs::db3::WriteBehindTable::~WriteBehindTable() {
+	close();
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stop = true;
+	}
+	wakeup.notify_one();
+	worker.join();
+}
+
+void ecs::db3::WriteBehindTable::appendRow(row_T row) {
+	for(;;) {
+		if(closed) {
+			throw exceptions::Exception("Write behind table has been closed");
+		}
+
+		if(buffer.tryPush(std::move(row))) {
+			break;
+		}
+
+		/* Backpressure: the buffer is full so let the writer catch up */
+		wakeup.notify_one();
+		std::this_thread::sleep_for(std::chrono::microseconds(100));
+	}
+
+	appended++;
+
+	if(buffer.sizeApprox() >= batchSize) {
+		wakeup.notify_one();
+	}
+}
+
+bool ecs::db3::WriteBehindTable::tryAppendRow(row_T row) {
+	if(closed || !buffer.tryPush(std::move(row))) {
+		rowsRejected++;
+		return false;
+	}
+
+	appended++;
+
+	if(buffer.sizeApprox() >= batchSize) {
+		wakeup.notify_one();
+	}
+
+	return true;
+}
+
+void ecs::db3::WriteBehindTable::flush() {
+	auto target = appended.load();
+
+	std::unique_lock<std::mutex> lock(mutex);
+	flushRequested = true;
+	wakeup.notify_one();
+
+	flushed.wait(lock, [&](){
+		return processed.load() >= target || stop;
+	});
+}
+
+void ecs::db3::WriteBehindTable::close() {
+	closed = true;
+	flush();
+}
+
+bool ecs::db3::WriteBehindTable::isClosed() const {
+	return closed;
+}
+
+ecs::db3::WriteBehindStatistics ecs::db3::WriteBehindTable::getStatistics() const {
+	WriteBehindStatistics result;
+	result.rowsWritten  = rowsWritten;
+	result.rowsFailed   = rowsFailed;
+	result.rowsRejected = rowsRejected;
+	result.flushes      = flushes;
+
+	std::lock_guard<std::mutex> lock(errorMutex);
+	result.lastError    = lastError;
+	return result;
+}
+
+void ecs::db3::WriteBehindTable::setLastError(const std::exception &e) {
+	std::lock_guard<std::mutex> lock(errorMutex);
+	lastError = e.what();
+}
+
+void ecs::db3::WriteBehindTable::run() {
+	std::unique_lock<std::mutex> lock(mutex);
+
+	for(;;) {
+		wakeup.wait_for(lock, maxAge, [this](){
+			return stop || flushRequested || buffer.sizeApprox() >= batchSize;
+		});
+
+		if(signals && signals->isTerminationRequested()) {
+			closed = true;
+		}
+
+		bool finished  = stop;
+		flushRequested = false;
+
+		lock.unlock();
+		writeRows();
+		lock.lock();
+
+		flushed.notify_all();
+
+		if(finished && buffer.sizeApprox() == 0) {
+			return;
+		}
+	}
+}
+
+void ecs::db3::WriteBehindTable::writeRows() {
+	row_T row;
+
+	auto execute = [this](const std::string &query) {
+		if(!connection->execute(query)) {
+			throw exceptions::Exception("Write behind query failed: " + query);
+		}
+	};
+
+	while(buffer.tryPop(row)) {
+		std::uint64_t rows        = 0;
+		std::uint64_t written     = 0;
+		bool          transaction = true;
+		bool          aborted     = false;
+
+		try {
+			connection->startTransation();
+		}catch(std::exception &e) {
+			/* Without a transaction every row is committed on its own */
+			setLastError(e);
+			transaction = false;
+		}
+
+		do {
+			/* Every row gets a savepoint because some backends like
+			 * postgres abort the whole transaction with a failed insert.
+			 */
+			bool saved = false;
+
+			try {
+				if(transaction) {
+					execute("SAVEPOINT write_behind_row;");
+					saved = true;
+				}
+				statement->reset();
+				row(*statement);
+				statement->execute();
+				if(saved) {
+					execute("RELEASE write_behind_row;");
+				}
+				written++;
+			}catch(std::exception &e) {
+				setLastError(e);
+
+				try {
+					if(!saved) {
+						aborted = transaction;
+					}else{
+						execute("ROLLBACK TO write_behind_row;");
+						execute("RELEASE write_behind_row;");
+					}
+				}catch(std::exception &) {
+					/* Keep the reason of the failed row */
+					aborted = true;
+				}
+			}
+			row = nullptr;
+			rows++;
+		}while(!aborted && rows < batchSize && buffer.tryPop(row));
+
+		try {
+			if(aborted) {
+				/* The rows written before the failure are lost as well */
+				connection->rollbackTransaction();
+				written = 0;
+			}else{
+				if(transaction) {
+					connection->commitTransaction();
+				}
+				flushes++;
+			}
+		}catch(std::exception &e) {
+			setLastError(e);
+			try {
+				connection->rollbackTransaction();
+			}catch(std::exception &) {
+				/* Keep the reason of the failed commit */
+			}
+			written = 0;
+		}
+
+		rowsWritten += written;
+		rowsFailed  += rows - written;
+		processed   += rows;
+	}
+}
@@ -23,6 +23,16 @@
 #include <ecs/database/impl/ConnectionImpl.hpp>
 #include <ecs/database/impl/MigratorImpl.hpp>
 #include <ecs/database/Migrator.hpp>
+#include <ecs/Observable.hpp>
+
+/** Publishes the captured changes to the subscribers. The dispatcher
+ * is destroyed first so all queued batches are delivered before the
+ * observable is gone.
+ */
+struct ecs::db3::ConnectionImpl::ChangeFeed {
+	ecs::tools::Observable<ChangeBatch> observable;
+	SerialExecutor                      dispatcher;
+};
 
 ecs::db3::ConnectionImpl::ConnectionImpl() {
 
@@ -64,6 +74,54 @@ void ecs::db3::ConnectionImpl::rollbackTransaction() {
 void ecs::db3::ConnectionImpl::autocommit(bool) {
 }
 
+bool ecs::db3::ConnectionImpl::backup(ConnectionImpl *destination, int pagesPerStep,
+		std::chrono::milliseconds sleep,
+		const std::function<void(int, int)> &progress) {
+	setErrorMessage("Backup is not supported by this database backend");
+	return false;
+}
+
+void ecs::db3::ConnectionImpl::getMaintenanceStatistics(MaintenanceStatistics &statistics) {
+
+}
+
+void ecs::db3::ConnectionImpl::getResultCacheStatistics(ResultCacheStatistics &statistics) {
+
+}
+
+bool ecs::db3::ConnectionImpl::registerTable(const std::string &name, MemoryTable::sharedPtr_T table) {
+	setErrorMessage("Memory tables are not supported by this database backend");
+	return false;
+}
+
+bool ecs::db3::ConnectionImpl::captureChanges(std::function<void(ChangeBatch&&)> publish) {
+	setErrorMessage("Change capture is not supported by this database backend");
+	return false;
+}
+
+bool ecs::db3::ConnectionImpl::listen(const std::string &channel, notificationListener_T listener) {
+	setErrorMessage("Notifications are not supported by this database backend");
+	return false;
+}
+
+bool ecs::db3::ConnectionImpl::unlisten(const std::string &channel) {
+	setErrorMessage("Notifications are not supported by this database backend");
+	return false;
+}
+
+bool ecs::db3::ConnectionImpl::adviseIndexes(std::vector<IndexAdvice> &advice) {
+	setErrorMessage("The index advisor is not supported by this database backend");
+	return false;
+}
+
+ecs::db3::StatementMetrics::sharedPtr_T ecs::db3::ConnectionImpl::getBackendMetrics() const {
+	return StatementMetrics::sharedPtr_T();
+}
+
+bool ecs::db3::ConnectionImpl::locksDatabaseOnWrite() const {
+	return false;
+}
+
 std::string ecs::db3::ConnectionImpl::getErrorMessage() {
 	std::scoped_lock lock(errorMessageMutex);
 	return errorMessage;
@@ -78,3 +136,58 @@ void ecs::db3::ConnectionImpl::setErrorMessage ( const std::string &message ) {
 ecs::db3::ConnectionImpl::~ConnectionImpl() {
 
 }
+
+ecs::db3::SerialExecutor &ecs::db3::ConnectionImpl::getExecutor() {
+	std::call_once(executorCreated, [this](){
+		executor = std::make_unique<SerialExecutor>();
+	});
+	return *executor;
+}
+
+bool ecs::db3::ConnectionImpl::subscribeChanges(ecs::tools::Function<void(ChangeBatch&)> subscriber) {
+	std::scoped_lock lock(changeFeedMutex);
+
+	if(!changeFeed) {
+		auto feed = std::make_shared<ChangeFeed>();
+
+		/* The connection owns the feed and stops the capture before
+		 * the feed is destroyed.
+		 */
+		auto *target = feed.get();
+		if(!captureChanges([target](ChangeBatch &&batch){
+			target->dispatcher.post([target, batch = std::move(batch)]() mutable {
+				target->observable(batch);
+			});
+		})) {
+			return false;
+		}
+
+		changeFeed = std::move(feed);
+	}
+
+	/* Subscriptions are changed on the dispatcher so they never
+	 * race with a running notification.
+	 */
+	auto *feed = changeFeed.get();
+	auto  add  = [feed, subscriber](){
+		feed->observable.subscribe(subscriber);
+	};
+
+	if(feed->dispatcher.isWorkerThread()) {
+		add();
+	}else{
+		feed->dispatcher.submit(add).get();
+	}
+
+	return true;
+}
+
+void ecs::db3::ConnectionImpl::enableStatementMetrics() {
+	if(!statementMetrics) {
+		statementMetrics = std::make_shared<StatementMetrics>();
+	}
+}
+
+ecs::db3::StatementMetrics::sharedPtr_T ecs::db3::ConnectionImpl::getStatementMetrics() const {
+	return statementMetrics;
+}
@@ -43,3 +43,13 @@ void ecs::db3::StatementImpl::setErrorString(
 std::int64_t ecs::db3::StatementImpl::lastInsertId() {
 	throw exceptions::Exception("Not Implemented");
 }
+
+bool ecs::db3::StatementImpl::fetchAll(TableBase &table) {
+	return false;
+}
+
+std::uint64_t ecs::db3::StatementImpl::takeBusyRetries() {
+	auto result = busyRetries;
+	busyRetries = 0;
+	return result;
+}
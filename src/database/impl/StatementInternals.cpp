@@ -23,5 +23,7 @@ ecs::db3::StatementInternals::~StatementInternals() {
 ecs::db3::StatementInternals* ecs::db3::StatementInternals::clone() {
 	std::unique_ptr<StatementInternals> result(new StatementInternals(connection));
 	result->stmt       = this->stmt;
+	result->metrics    = this->metrics;
+	result->metricsId  = this->metricsId;
 	return result.release();
 }
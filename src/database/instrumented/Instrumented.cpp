@@ -0,0 +1,295 @@
+/*
+ * Instrumented.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <ecs/database/instrumented/Instrumented.hpp>
+#include <ecs/database/Connector.hpp>
+#include <exception>
+
+/** @addtogroup ecsdb
+ * @{
+ */
+
+using namespace ecs::db3;
+
+namespace {
+
+inline std::chrono::nanoseconds since(StatementMetrics::clock_T::time_point start) {
+	return StatementMetrics::clock_T::now() - start;
+}
+
+}
+
+InstrumentedStatement::InstrumentedStatement(StatementImpl::sharedPtr_T statement,
+		StatementMetrics::sharedPtr_T metrics, std::size_t metricsId) :
+				statement(std::move(statement)), metrics(std::move(metrics)), metricsId(metricsId) {
+
+}
+
+InstrumentedStatement::~InstrumentedStatement() {
+
+}
+
+void InstrumentedStatement::update() {
+	setErrorString(statement->getErrorString());
+}
+
+int InstrumentedStatement::execute(Table *table) {
+	auto start   = StatementMetrics::clock_T::now();
+	auto rc      = statement->execute(table);
+	auto retries = statement->takeBusyRetries();
+	metrics->recordExecute(metricsId, since(start), rc == 0, retries);
+
+	busyRetries += retries;
+	update();
+	return rc;
+}
+
+bool InstrumentedStatement::bind(ecs::db3::types::cell_T *parameter, const std::string *parameterName, int n) {
+	auto start = StatementMetrics::clock_T::now();
+	auto rc    = statement->bind(parameter, parameterName, n);
+	metrics->recordBind(metricsId, since(start), rc);
+
+	update();
+	return rc;
+}
+
+std::int64_t InstrumentedStatement::lastInsertId() {
+	return statement->lastInsertId();
+}
+
+void InstrumentedStatement::reset() {
+	statement->reset();
+	update();
+}
+
+void InstrumentedStatement::clearBindings() {
+	statement->clearBindings();
+	update();
+}
+
+int InstrumentedStatement::getStatus() const {
+	return statement->getStatus();
+}
+
+Row::uniquePtr_T InstrumentedStatement::fetch() {
+	auto start   = StatementMetrics::clock_T::now();
+	auto row     = statement->fetch();
+	auto elapsed = since(start);
+	auto retries = statement->takeBusyRetries();
+	metrics->recordFetch(metricsId, elapsed, row ? 1 : 0, row ? StatementMetrics::estimateBytes(*row) : 0, retries);
+
+	busyRetries += retries;
+	update();
+	return row;
+}
+
+bool InstrumentedStatement::fetchAll(TableBase &table) {
+	auto start = StatementMetrics::clock_T::now();
+	auto first = table.size();
+	if(!statement->fetchAll(table)) {
+		update();
+		return false;
+	}
+
+	auto elapsed = since(start);
+	std::uint64_t bytes = 0;
+	for(auto i = first;i < table.size();i++) {
+		bytes += StatementMetrics::estimateBytes(table[static_cast<int>(i)]);
+	}
+	auto retries = statement->takeBusyRetries();
+	metrics->recordFetch(metricsId, elapsed, table.size() - first, bytes, retries);
+
+	busyRetries += retries;
+	update();
+	return true;
+}
+
+InstrumentedConnection::InstrumentedConnection() : metrics(std::make_shared<StatementMetrics>()) {
+
+}
+
+InstrumentedConnection::~InstrumentedConnection() {
+	disconnect();
+}
+
+std::string InstrumentedConnection::getPluginVersion() {
+	return "0.0.0";
+}
+
+std::string InstrumentedConnection::getPluginDescription() {
+	return "Records the calls into another database plugin";
+}
+
+std::string InstrumentedConnection::getPluginAuthor() {
+	return "Geoffrey Mellar <mellar@gamma-kappa.com>";
+}
+
+std::string InstrumentedConnection::getPluginName() {
+	return "database.instrumented";
+}
+
+bool InstrumentedConnection::connect(const ConnectionParameters &parameters) {
+	if(backend) {
+		setErrorMessage("The instrumented backend is already connected");
+		return false;
+	}
+
+	if(parameters.getWrappedBackend().empty() || parameters.getWrappedBackend() == parameters.getBackend()) {
+		setErrorMessage("The instrumented backend needs another backend to wrap");
+		return false;
+	}
+
+	/* Nothing may be thrown out of a plugin */
+	try {
+		backend = PluginLoader::loadModule(parameters, parameters.getWrappedBackend());
+	}catch(const std::exception &e) {
+		setErrorMessage("Loading the backend " + parameters.getWrappedBackend() + " failed: " + e.what());
+		return false;
+	}
+
+	if(!backend) {
+		setErrorMessage("The backend " + parameters.getWrappedBackend() + " does not exist");
+		return false;
+	}
+
+	connectionParameters = parameters;
+	if(!forward(backend->connect(parameters))) {
+		backend = ecs::dynlib::Class<ConnectionImpl>();
+		return false;
+	}
+	return true;
+}
+
+bool InstrumentedConnection::disconnect() {
+	if(!backend) {
+		return false;
+	}
+
+	auto rc = backend->disconnect();
+	backend = ecs::dynlib::Class<ConnectionImpl>();
+	return rc;
+}
+
+bool InstrumentedConnection::execute(const std::string &query) {
+	auto start = StatementMetrics::clock_T::now();
+	auto rc    = backend->execute(query);
+	metrics->recordExecute(metrics->getStatementId(query), since(start), rc, 0);
+	return forward(rc);
+}
+
+StatementImpl::ptr_T InstrumentedConnection::prepare(const std::string &query) {
+	auto                       start = StatementMetrics::clock_T::now();
+	StatementImpl::sharedPtr_T statement(backend->prepare(query));
+	auto                       elapsed = since(start);
+
+	if(!statement) {
+		forward(false);
+		return nullptr;
+	}
+
+	auto id = metrics->getStatementId(query);
+	metrics->recordPrepare(id, elapsed);
+
+	auto result = new InstrumentedStatement(statement, metrics, id);
+	result->setErrorString(statement->getErrorString());
+	return result;
+}
+
+void InstrumentedConnection::startTransation() {
+	backend->startTransation();
+}
+
+void InstrumentedConnection::commitTransaction() {
+	backend->commitTransaction();
+}
+
+void InstrumentedConnection::rollbackTransaction() {
+	backend->rollbackTransaction();
+}
+
+void InstrumentedConnection::autocommit(bool enabled) {
+	backend->autocommit(enabled);
+}
+
+bool InstrumentedConnection::backup(ConnectionImpl *destination, int pagesPerStep,
+		std::chrono::milliseconds sleep,
+		const std::function<void(int, int)> &progress) {
+	if(auto instrumented = dynamic_cast<InstrumentedConnection*>(destination)) {
+		if(!instrumented->backend) {
+			setErrorMessage("The destination is not connected");
+			return false;
+		}
+		destination = instrumented->backend.get();
+	}
+
+	return forward(backend->backup(destination, pagesPerStep, sleep, progress));
+}
+
+void InstrumentedConnection::getMaintenanceStatistics(MaintenanceStatistics &statistics) {
+	backend->getMaintenanceStatistics(statistics);
+}
+
+void InstrumentedConnection::getResultCacheStatistics(ResultCacheStatistics &statistics) {
+	backend->getResultCacheStatistics(statistics);
+}
+
+bool InstrumentedConnection::registerTable(const std::string &name, MemoryTable::sharedPtr_T table) {
+	return forward(backend->registerTable(name, std::move(table)));
+}
+
+bool InstrumentedConnection::captureChanges(std::function<void(ChangeBatch&&)> publish) {
+	return forward(backend->captureChanges(std::move(publish)));
+}
+
+bool InstrumentedConnection::listen(const std::string &channel, notificationListener_T listener) {
+	return forward(backend->listen(channel, std::move(listener)));
+}
+
+bool InstrumentedConnection::unlisten(const std::string &channel) {
+	return forward(backend->unlisten(channel));
+}
+
+bool InstrumentedConnection::adviseIndexes(std::vector<IndexAdvice> &advice) {
+	return forward(backend->adviseIndexes(advice));
+}
+
+StatementMetrics::sharedPtr_T InstrumentedConnection::getBackendMetrics() const {
+	return metrics;
+}
+
+bool InstrumentedConnection::locksDatabaseOnWrite() const {
+	return backend && backend->locksDatabaseOnWrite();
+}
+
+ecs::db3::MigratorImpl* InstrumentedConnection::getMigrator(DbConnection *connection) {
+	return backend->getMigrator(connection);
+}
+
+bool InstrumentedConnection::forward(bool succeeded) {
+	if(!succeeded) {
+		setErrorMessage(backend->getErrorMessage());
+	}
+	return succeeded;
+}
+
+/** @} */
@@ -22,6 +22,7 @@
 
 #include <ecs/database/mariadb/MariaDB.hpp>
 #include <ecs/database/impl/MigratorImpl.hpp>
+#include <ecs/Time.hpp>
 
 std::mutex ecs::db3::MariaDBConnection::libraryInitMutex;
 bool ecs::db3::MariaDBConnection::libraryInit = false;
@@ -123,7 +124,8 @@ public:
 };
 
 ecs::db3::MariaDBConnection::ConnectionWrapper::ConnectionWrapper(
-		const ConnectionParameters &parameters) : connectionTimout(5) {
+		const ConnectionParameters &parameters) : connectionTimout(5),
+		nativeTimestamps(parameters.getNativeTimestamps()) {
 	std::scoped_lock lock(connectionMutex);
 	ThreadEndHelper::instance().initialize();
 
@@ -281,7 +283,53 @@ int ecs::db3::MariaDBStatement::execute(Table *table) {
 						return ecs::tools::any::make_unique<ecs::db3::types::Float>(std::get<float>(bind->values));
 					};
 					break;
+				case MYSQL_TYPE_TIMESTAMP:
+				case MYSQL_TYPE_DATETIME:
+				case MYSQL_TYPE_DATE:
+					if(!connection->nativeTimestamps) {
+						/* Let the server format the value as a string */
+						value->values                   = std::vector<char>();
+						resultBindings[i].buffer_type   = MYSQL_TYPE_STRING;
+						value->cellFactory = [](BindHolder *bind){
+							std::vector<char> &container = std::get<std::vector<char>>(bind->values);
+							auto result = ecs::tools::any::make_unique<ecs::db3::types::String>();
+							result->cast<std::string>()->assign(container.cbegin(), container.cend());
+							return result;
+						};
+						break;
+					}
+					value->values                   = MYSQL_TIME();
+					resultBindings[i].buffer_type   = field->type;
+					resultBindings[i].buffer        = (void*)&std::get<MYSQL_TIME>(value->values);
+					resultBindings[i].buffer_length = sizeof(MYSQL_TIME);
+					value->cellFactory = [](BindHolder *bind){
+						const MYSQL_TIME &time = std::get<MYSQL_TIME>(bind->values);
+
+						/* Zero dates like 0000-00-00 have no point in time */
+						if(time.year == 0 || time.month == 0 || time.day == 0) {
+							return ecs::tools::any::make_unique<ecs::db3::types::Null>();
+						}
+
+						return ecs::tools::any::make_unique<ecs::db3::types::Timestamp>(ecs::time::Timestamp::fromCivil(
+								time.year, time.month, time.day, time.hour, time.minute, time.second, time.second_part));
+					};
+					break;
 				case MYSQL_TYPE_STRING:
+					/* BINARY(16) is the usual column type for uuids */
+					if(connection->nativeTimestamps && (field->flags & BINARY_FLAG) &&
+							field->charsetnr == 63 && field->length == 16) {
+						value->values                   = std::vector<char>();
+						resultBindings[i].buffer_type   = field->type;
+						value->cellFactory = [](BindHolder *bind){
+							std::vector<char> &container = std::get<std::vector<char>>(bind->values);
+							auto result = ecs::tools::any::make_unique<ecs::db3::types::Uuid>();
+							std::memcpy(result->cast<ecs::db3::types::Uuid::type>()->data(), container.data(),
+									std::min<std::size_t>(container.size(), 16));
+							return result;
+						};
+						break;
+					}
+					/* Fall through */
 				case MYSQL_TYPE_VAR_STRING:
 				case MYSQL_TYPE_VARCHAR:
 					value->values                   = std::vector<char>();
@@ -408,6 +456,35 @@ bool ecs::db3::MariaDBStatement::bind(ecs::db3::types::cell_T *parameter,
 		case types::typeId::blobInput:
 			bindBlob(parameter->cast_reference<ecs::db3::types::BlobInput::type>(), value);
 			break;
+		case types::typeId::timestamp: {
+			/* Timestamps are always transferred in UTC */
+			auto        micros  = parameter->cast_reference<ecs::time::Timestamp>().getMicroseconds();
+			auto        seconds = micros >= 0 ? micros / 1000000 : (micros - 999999) / 1000000;
+			std::time_t time    = static_cast<std::time_t>(seconds);
+			std::tm     utc     = ecs::time::gmtime(&time);
+			MYSQL_TIME  mysqlTime;
+
+			std::memset(&mysqlTime, '\0', sizeof(MYSQL_TIME));
+			mysqlTime.year        = utc.tm_year + 1900;
+			mysqlTime.month       = utc.tm_mon + 1;
+			mysqlTime.day         = utc.tm_mday;
+			mysqlTime.hour        = utc.tm_hour;
+			mysqlTime.minute      = utc.tm_min;
+			mysqlTime.second      = utc.tm_sec;
+			mysqlTime.second_part = static_cast<unsigned long>(micros - seconds * 1000000);
+			mysqlTime.time_type   = MYSQL_TIMESTAMP_DATETIME;
+
+			value.second = std::make_unique<ecs::db3::types::cell_T>(mysqlTime);
+			value.first.buffer_type   = MYSQL_TYPE_DATETIME;
+			value.first.buffer        = reinterpret_cast<char*>(value.second->cast<MYSQL_TIME>());
+			value.first.buffer_length = sizeof(MYSQL_TIME);
+			break;
+		}
+		case types::typeId::uuid:
+			value.first.buffer_type   = MYSQL_TYPE_BLOB;
+			value.first.buffer        = reinterpret_cast<char*>(parameter->cast<ecs::db3::types::Uuid::type>()->data());
+			value.first.buffer_length = 16;
+			break;
 		case types::typeId::boolean_T:
 			value.second = std::make_unique<ecs::db3::types::cell_T>(std::int8_t(parameter->cast_reference<bool>() == true ? 1 : 0));
 			value.first.buffer_type   = MYSQL_TYPE_TINY;
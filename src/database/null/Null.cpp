@@ -0,0 +1,202 @@
+/*
+ * Null.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <ecs/database/null/Null.hpp>
+#include <ecs/Timestamp.hpp>
+#include <ecs/UUID.hpp>
+
+/** @addtogroup ecsdb
+ * @{
+ */
+
+using namespace ecs::db3;
+
+NullStatement::NullStatement(std::shared_ptr<NullResultSource> source) :
+		source(std::move(source)), position(0), insertId(0) {
+
+}
+
+NullStatement::~NullStatement() {
+
+}
+
+int NullStatement::execute(Table *table) {
+	/* Same work as the name lookup of the other backends */
+	for(auto &name : source->columnNames) {
+		table->columnNames.push_back(name);
+	}
+
+	position = 0;
+	insertId = ++source->executions;
+	return 0;
+}
+
+bool NullStatement::bind(ecs::db3::types::cell_T *parameter, const std::string *parameterName, int n) {
+	return true;
+}
+
+std::int64_t NullStatement::lastInsertId() {
+	return insertId;
+}
+
+void NullStatement::reset() {
+	position = 0;
+}
+
+void NullStatement::clearBindings() {
+
+}
+
+Row::uniquePtr_T NullStatement::fetch() {
+	using namespace ecs::tools;
+	using namespace types;
+
+	auto &result = source->result;
+	if(position >= result.rows) {
+		return Row::uniquePtr_T();
+	}
+
+	auto row   = std::make_unique<Row>();
+	auto value = static_cast<std::int64_t>(position);
+	row->data.reserve(result.columns.size());
+
+	for(auto column : result.columns) {
+		switch(column) {
+			case typeId::int64_T:
+				*row << any::make<Int64>(value);
+				break;
+			case typeId::uint64_T:
+				*row << any::make<Uint64>(static_cast<std::uint64_t>(value));
+				break;
+			case typeId::double_T:
+				*row << any::make<Double>(static_cast<double>(value) + 0.5);
+				break;
+			case typeId::float_T:
+				*row << any::make<Float>(static_cast<float>(value) + 0.5f);
+				break;
+			case typeId::boolean_T:
+				*row << any::make<Boolean>(value % 2 == 1);
+				break;
+			case typeId::string:
+				*row << any::make<String>(source->text);
+				break;
+			case typeId::timestamp:
+				*row << any::make<types::Timestamp>(ecs::time::Timestamp::fromMicroseconds(value));
+				break;
+			case typeId::uuid:
+				*row << any::make<Uuid>();
+				break;
+			default:
+				*row << std::make_unique<cell_T>(nullptr, Null());
+				break;
+		}
+	}
+
+	position++;
+	return row;
+}
+
+NullConnection::NullConnection() {
+
+}
+
+NullConnection::~NullConnection() {
+
+}
+
+std::string NullConnection::getPluginVersion() {
+	return "0.0.0";
+}
+
+std::string NullConnection::getPluginDescription() {
+	return "Database plugin returning synthetic results without I/O";
+}
+
+std::string NullConnection::getPluginAuthor() {
+	return "Geoffrey Mellar <mellar@gamma-kappa.com>";
+}
+
+std::string NullConnection::getPluginName() {
+	return "database.null";
+}
+
+bool NullConnection::connect(const ConnectionParameters &parameters) {
+	using types::typeId;
+
+	for(auto column : parameters.getSyntheticResult().columns) {
+		switch(column) {
+			case typeId::int64_T:
+			case typeId::uint64_T:
+			case typeId::double_T:
+			case typeId::float_T:
+			case typeId::boolean_T:
+			case typeId::string:
+			case typeId::timestamp:
+			case typeId::uuid:
+			case typeId::null:
+				break;
+			default:
+				setErrorMessage("The null backend can only generate scalar columns");
+				return false;
+		}
+	}
+
+	connectionParameters = parameters;
+	source         = std::make_shared<NullResultSource>();
+	source->result = parameters.getSyntheticResult();
+	source->text.assign(source->result.textBytes, 'x');
+	for(std::size_t i = 0;i < source->result.columns.size();++i) {
+		source->columnNames.push_back("column" + std::to_string(i));
+	}
+	return true;
+}
+
+bool NullConnection::disconnect() {
+	source.reset();
+	return true;
+}
+
+bool NullConnection::execute(const std::string &query) {
+	if(!source) {
+		setErrorMessage("Not connected");
+		return false;
+	}
+
+	source->executions++;
+	return true;
+}
+
+StatementImpl::ptr_T NullConnection::prepare(const std::string &query) {
+	if(!source) {
+		setErrorMessage("Not connected");
+		return nullptr;
+	}
+
+	return new NullStatement(source);
+}
+
+ecs::db3::MigratorImpl* NullConnection::getMigrator(DbConnection *connection) {
+	return nullptr;
+}
+
+/** @} */
@@ -0,0 +1,380 @@
+/*
+ * Listener.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <ecs/database/postgresql/Listener.hpp>
+#include <stdexcept>
+#include <chrono>
+#include <cerrno>
+#include <cstdint>
+#include <utility>
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+using namespace ecs::db3;
+
+PostgresqlListener::PostgresqlListener(const std::string &connectionString, std::size_t queueSize) :
+		connection(nullptr), epollFd(-1), wakeupFd(-1), socket(-1), queue(queueSize), producerWaiting(false), stop(false) {
+#if defined(__linux__)
+	connection = PQconnectdb(connectionString.c_str());
+
+	if(connection == nullptr || PQstatus(connection) == CONNECTION_BAD) {
+		std::string message = connection != nullptr ? PQerrorMessage(connection) : "Out of memory";
+		PQfinish(connection);
+		throw std::runtime_error("Opening the listener connection failed: " + message);
+	}
+
+	epollFd  = epoll_create1(EPOLL_CLOEXEC);
+	wakeupFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+	if(epollFd < 0 || wakeupFd < 0) {
+		if(epollFd >= 0) {
+			close(epollFd);
+		}
+		if(wakeupFd >= 0) {
+			close(wakeupFd);
+		}
+		PQfinish(connection);
+		throw std::runtime_error("Creating the listener events failed");
+	}
+
+	epoll_event event{};
+	event.events  = EPOLLIN;
+	event.data.fd = wakeupFd;
+	epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeupFd, &event);
+	watchSocket();
+
+	listenerThread   = std::thread(&PostgresqlListener::run, this);
+	dispatcherThread = std::thread(&PostgresqlListener::dispatch, this);
+#else
+	throw std::runtime_error("Notifications are only supported on linux");
+#endif
+}
+
+PostgresqlListener::~PostgresqlListener() {
+#if defined(__linux__)
+	stop = true;
+	wakeup();
+
+	{
+		std::scoped_lock lock(dispatchMutex);
+	}
+	dispatchWakeup.notify_one();
+	spaceAvailable.notify_one();
+
+	if(listenerThread.joinable()) {
+		listenerThread.join();
+	}
+
+	if(dispatcherThread.joinable()) {
+		dispatcherThread.join();
+	}
+
+	/* Commands queued while stopping are never run */
+	for(auto &command : commands) {
+		command.done.set_exception(std::make_exception_ptr(std::runtime_error("Listener stopped")));
+	}
+
+	close(epollFd);
+	close(wakeupFd);
+	PQfinish(connection);
+#endif
+}
+
+void PostgresqlListener::listen(const std::string &channel, notificationListener_T listener) {
+	bool first;
+
+	{
+		std::scoped_lock lock(mutex);
+		auto &channelListeners = listeners[channel];
+		first = channelListeners.empty();
+		channelListeners.push_back(std::move(listener));
+	}
+
+	if(!first) {
+		return;
+	}
+
+	try {
+		execute(true, channel);
+	}catch(...){
+		std::scoped_lock lock(mutex);
+		listeners.erase(channel);
+		throw;
+	}
+}
+
+void PostgresqlListener::unlisten(const std::string &channel) {
+	{
+		std::scoped_lock lock(mutex);
+		if(listeners.erase(channel) == 0) {
+			return;
+		}
+	}
+
+	execute(false, channel);
+}
+
+void PostgresqlListener::execute(bool listen, const std::string &channel) {
+	std::future<void> result;
+
+	{
+		std::scoped_lock lock(mutex);
+		if(stop) {
+			throw std::runtime_error("Listener stopped");
+		}
+
+		commands.push_back(Command{listen, channel, std::promise<void>()});
+		result = commands.back().done.get_future();
+	}
+
+	wakeup();
+	result.get();
+}
+
+void PostgresqlListener::run() {
+#if defined(__linux__)
+	bool        connected = true;
+	epoll_event events[2];
+
+	while(!stop) {
+		/* A broken connection is retried every second */
+		auto count = epoll_wait(epollFd, events, 2, connected ? -1 : 1000);
+
+		if(count < 0 && errno != EINTR) {
+			break;
+		}
+
+		for(int i = 0;i < count;++i) {
+			if(events[i].data.fd == wakeupFd) {
+				std::uint64_t value;
+				while(read(wakeupFd, &value, sizeof(value)) > 0);
+			}
+		}
+
+		if(stop) {
+			break;
+		}
+
+		if(!connected) {
+			connected = reconnect();
+			if(!connected) {
+				failCommands();
+				continue;
+			}
+		}
+
+		runCommands();
+		connected = receive();
+	}
+#endif
+}
+
+void PostgresqlListener::runCommands() {
+	std::deque<Command> pending;
+
+	{
+		std::scoped_lock lock(mutex);
+		pending.swap(commands);
+	}
+
+	for(auto &command : pending) {
+		try {
+			runCommand(command.listen, command.channel);
+			command.done.set_value();
+		}catch(...){
+			command.done.set_exception(std::current_exception());
+		}
+	}
+}
+
+void PostgresqlListener::failCommands() {
+	std::deque<Command> pending;
+
+	{
+		std::scoped_lock lock(mutex);
+		pending.swap(commands);
+	}
+
+	for(auto &command : pending) {
+		command.done.set_exception(std::make_exception_ptr(
+				std::runtime_error("The listener lost the connection to the server")));
+	}
+}
+
+void PostgresqlListener::runCommand(bool listen, const std::string &channel) {
+	/* Channel names are identifiers and case sensitive when quoted */
+	char *identifier = PQescapeIdentifier(connection, channel.c_str(), channel.size());
+	if(identifier == nullptr) {
+		throw std::runtime_error(PQerrorMessage(connection));
+	}
+
+	std::string query = std::string(listen ? "LISTEN " : "UNLISTEN ") + identifier + ";";
+	PQfreemem(identifier);
+
+	auto *result = PQexec(connection, query.c_str());
+	auto  status = PQresultStatus(result);
+	PQclear(result);
+
+	if(status != PGRES_COMMAND_OK) {
+		throw std::runtime_error(PQerrorMessage(connection));
+	}
+}
+
+bool PostgresqlListener::receive() {
+	if(PQconsumeInput(connection) == 0) {
+		return false;
+	}
+
+	PGnotify *notify;
+	while((notify = PQnotifies(connection)) != nullptr) {
+		Notification notification;
+		notification.channel   = notify->relname;
+		notification.payload   = notify->extra != nullptr ? notify->extra : "";
+		notification.processId = notify->be_pid;
+		PQfreemem(notify);
+
+		/* The dispatcher is behind so wait for a free slot. The
+		 * remaining data stays in the socket meanwhile. The timeout
+		 * covers a pop which missed the waiting flag.
+		 */
+		if(!queue.tryPush(std::move(notification))) {
+			std::unique_lock lock(dispatchMutex);
+			producerWaiting = true;
+			while(!queue.tryPush(std::move(notification))) {
+				if(stop) {
+					producerWaiting = false;
+					return true;
+				}
+				spaceAvailable.wait_for(lock, std::chrono::milliseconds(10));
+			}
+			producerWaiting = false;
+		}
+
+		{
+			std::scoped_lock lock(dispatchMutex);
+		}
+		dispatchWakeup.notify_one();
+	}
+
+	return PQstatus(connection) == CONNECTION_OK;
+}
+
+bool PostgresqlListener::reconnect() {
+	PQreset(connection);
+	if(PQstatus(connection) != CONNECTION_OK) {
+		return false;
+	}
+
+	watchSocket();
+
+	std::vector<std::string> channels;
+	{
+		std::scoped_lock lock(mutex);
+		for(auto &channel : listeners) {
+			channels.push_back(channel.first);
+		}
+	}
+
+	try {
+		for(auto &channel : channels) {
+			runCommand(true, channel);
+		}
+	}catch(...){
+		return false;
+	}
+
+	return true;
+}
+
+void PostgresqlListener::watchSocket() {
+#if defined(__linux__)
+	/* The socket changes when the connection is reset */
+	if(socket >= 0) {
+		epoll_ctl(epollFd, EPOLL_CTL_DEL, socket, nullptr);
+	}
+
+	socket = PQsocket(connection);
+	if(socket >= 0) {
+		epoll_event event{};
+		event.events  = EPOLLIN;
+		event.data.fd = socket;
+		epoll_ctl(epollFd, EPOLL_CTL_ADD, socket, &event);
+	}
+#endif
+}
+
+void PostgresqlListener::wakeup() {
+#if defined(__linux__)
+	std::uint64_t value = 1;
+	auto written = write(wakeupFd, &value, sizeof(value));
+	(void)written;
+#endif
+}
+
+void PostgresqlListener::dispatch() {
+	Notification notification;
+
+	while(true) {
+		{
+			std::unique_lock lock(dispatchMutex);
+			dispatchWakeup.wait(lock, [this](){
+				return stop || queue.sizeApprox() > 0;
+			});
+
+			if(stop && queue.sizeApprox() == 0) {
+				return;
+			}
+		}
+
+		while(queue.tryPop(notification)) {
+			if(producerWaiting) {
+				{
+					std::scoped_lock lock(dispatchMutex);
+				}
+				spaceAvailable.notify_one();
+			}
+
+			std::vector<notificationListener_T> channelListeners;
+
+			{
+				std::scoped_lock lock(mutex);
+				auto channel = listeners.find(notification.channel);
+				if(channel != listeners.end()) {
+					channelListeners = channel->second;
+				}
+			}
+
+			for(auto &listener : channelListeners) {
+				try {
+					listener(notification);
+				}catch(...){
+					/* A failing listener must not stop the others */
+				}
+			}
+		}
+	}
+}
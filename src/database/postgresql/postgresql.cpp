@@ -23,12 +23,17 @@
  
 #include <ecs/database/postgresql/postgresql.hpp>
 #include <ecs/database/impl/MigratorImpl.hpp>
+#include <ecs/Profiler.hpp>
 #include <algorithm>
 #include <string>
 #include <iostream>
 #include <boost/algorithm/string.hpp>
 #include <boost/endian/conversion.hpp>
 #include <boost/lexical_cast.hpp>
+#include <exception>
+#include <ecs/database/SerialExecutor.hpp>
+#include <future>
+#include <thread>
 
 /** @addtogroup ecsdb 
  * @{
@@ -36,6 +41,26 @@
 
 using namespace ecs::db3;
 
+namespace {
+
+/** Threads decoding large results. The calling thread decodes a
+ * part of the rows as well so one thread less than the hardware
+ * threads is started.
+ */
+std::vector<std::unique_ptr<SerialExecutor>> &decodeWorkers() {
+	static std::vector<std::unique_ptr<SerialExecutor>> workers = [](){
+		std::vector<std::unique_ptr<SerialExecutor>> result;
+		auto threads = std::max(2u, std::thread::hardware_concurrency());
+		for(unsigned i = 1;i < threads;i++) {
+			result.push_back(std::make_unique<SerialExecutor>());
+		}
+		return result;
+	}();
+	return workers;
+}
+
+}
+
 namespace ecs {
 namespace db3 {
 
@@ -117,8 +142,9 @@ void ecs::db3::PostgresqlStatement::PGresultDeleter(PGresult *obj) {
 	PQclear(obj);
 }
 
-PostgresqlStatement::PostgresqlStatement(PGconn *connection, const std::string &query)
-	: result(nullptr, &PGresultDeleter), connection(connection), query(query), iRow(0) {
+PostgresqlStatement::PostgresqlStatement(PGconn *connection, const std::string &query, bool nativeTimestamps)
+	: result(nullptr, &PGresultDeleter), connection(connection), query(query),
+	  nativeTimestamps(nativeTimestamps), iRow(0) {
 	if(connection == nullptr) {
 		throw std::runtime_error("Connection is invalid");
 	}
@@ -128,58 +154,195 @@ PostgresqlStatement::~PostgresqlStatement() {
 
 }
 	
-Row::uniquePtr_T PostgresqlStatement::fetch() {
-	if(iRow == PQntuples(result.get())) return Row::uniquePtr_T();
-	Row::uniquePtr_T row(new Row);
+void PostgresqlStatement::fetchTimestamp(Row &row, std::string_view text) {
+	ecs::time::Timestamp value;
+
+	/* Infinite and BC timestamps can not be represented and
+	 * are returned as text instead.
+	 */
+	if(ecs::time::Timestamp::parse(text, value)) {
+		row << ecs::tools::any::make<types::Timestamp>(value);
+	}else{
+		row << ecs::tools::any::make<types::String>(text.data(), text.size());
+	}
+}
+
+void PostgresqlStatement::fetchUuid(Row &row, std::string_view text) {
+	ecs::tools::UUID value;
+
+	if(ecs::tools::UUID::parse(text, value)) {
+		row << ecs::tools::any::make<types::Uuid>(value);
+	}else{
+		row << ecs::tools::any::make<types::String>(text.data(), text.size());
+	}
+}
 
-	for(std::int64_t iCol = 0;iCol < PQnfields(result.get());++iCol) {
+PostgresqlStatement::Column PostgresqlStatement::getColumn(Oid type, bool nativeTimestamps) {
+	switch(type) {
+		// We don't care about the size here because we keep everything in 64bit integer
+		case INT2OID:
+		case INT4OID:
+		case INT8OID:
+			return Column::integer;
+		// We use double for everything
+		case NUMERICOID:
+		case FLOAT4OID:
+		case FLOAT8OID:
+			return Column::floating;
+		case TIMESTAMPOID:
+		case TIMESTAMPTZOID:
+		case DATEOID:
+			return nativeTimestamps ? Column::timestamp : Column::text;
+		case UUIDOID:
+			return nativeTimestamps ? Column::uuid : Column::text;
+		case TIMEOID:
+		case TEXTOID:
+		case VARCHAROID:
+		case BYTEAOID:
+			return Column::text;
+		case BOOLOID:
+			return Column::boolean;
+		default:
+			return Column::unsupported;
+	}
+}
+
+bool PostgresqlStatement::decodeRow(int rowNumber, Row &row) const {
+	auto *values = result.get();
+	row.data.reserve(plan.size());
+
+	for(int iCol = 0;iCol < static_cast<int>(plan.size());++iCol) {
 		/* Check if the content is null because there is no oid type for
 		 * that case.
 		 */
-		if(PQgetisnull(result.get(), iRow, iCol)) {
-			*row << new ecs::db3::types::cell_T(nullptr, types::Null());
+		if(PQgetisnull(values, rowNumber, iCol)) {
+			row << new ecs::db3::types::cell_T(nullptr, types::Null());
 			/* There is nothing to do when the value is null */
 			continue;
 		}
 
-		switch(PQftype(result.get(), iCol)) {
-			// We don't care about the size here because we keep everything in 64bit integer
-			case INT2OID:
-			case INT4OID:
-			case INT8OID:
-				*row << ecs::tools::any::make<types::Int64>(std::strtoll(PQgetvalue(result.get(), iRow, iCol), nullptr, 10));
+		const char *value = PQgetvalue(values, rowNumber, iCol);
+
+		switch(plan[iCol]) {
+			case Column::integer:
+				row << ecs::tools::any::make<types::Int64>(std::strtoll(value, nullptr, 10));
 				break;
-			// We use double for everything
-			case NUMERICOID:
-			case FLOAT4OID:
-			case FLOAT8OID:
-				*row << ecs::tools::any::make<types::Double>(std::strtod(PQgetvalue(result.get(), iRow, iCol), nullptr));
+			case Column::floating:
+				row << ecs::tools::any::make<types::Double>(std::strtod(value, nullptr));
 				break;
-			case TIMESTAMPOID:
-			case TIMESTAMPTZOID:
-			case TIMEOID:
-			case DATEOID:
-			case TEXTOID:
-			case VARCHAROID:
-				*row << ecs::tools::any::make<types::String>(PQgetvalue(result.get(), iRow, iCol), PQgetlength(result.get(), iRow, iCol));
+			case Column::timestamp:
+				fetchTimestamp(row, std::string_view(value, PQgetlength(values, rowNumber, iCol)));
 				break;
-			case BYTEAOID:
-				*row << ecs::tools::any::make<types::String>(PQgetvalue(result.get(), iRow, iCol), PQgetlength(result.get(), iRow, iCol));
+			case Column::uuid:
+				fetchUuid(row, std::string_view(value, PQgetlength(values, rowNumber, iCol)));
 				break;
-			case BOOLOID:
-				*row << ecs::tools::any::make<types::Boolean>(boost::lexical_cast<bool>(std::string(PQgetvalue(result.get(), iRow, iCol), PQgetlength(result.get(), iRow, iCol))));
+			case Column::text:
+				row << ecs::tools::any::make<types::String>(value, PQgetlength(values, rowNumber, iCol));
 				break;
-			default:
-				row.reset();
+			case Column::boolean:
+				/* The text format of booleans is t or f */
+				row << ecs::tools::any::make<types::Boolean>(value[0] == 't');
 				break;
+			default:
+				return false;
 		}
 	}
 
+	return true;
+}
+
+Row::uniquePtr_T PostgresqlStatement::fetch() {
+	ECS_PROFILE_ZONE("PostgresqlStatement::fetch");
+
+	if(iRow == PQntuples(result.get())) return Row::uniquePtr_T();
+	Row::uniquePtr_T row(new Row);
+
+	if(!decodeRow(iRow, *row)) {
+		row.reset();
+	}
+
 	iRow++;
-	return std::move(row);
+	return row;
+}
+
+bool PostgresqlStatement::fetchAll(TableBase &table) {
+	ECS_PROFILE_ZONE("PostgresqlStatement::fetchAll");
+
+	/* Unsupported columns end the result like fetch() does */
+	if(!result || std::find(plan.begin(), plan.end(), Column::unsupported) != plan.end()) {
+		return false;
+	}
+
+	const int rows = PQntuples(result.get()) - iRow;
+	if(rows <= 0) {
+		return true;
+	}
+
+	std::vector<Row::uniquePtr_T> decoded(rows);
+	const int first = iRow;
+	auto decodeRange = [&](int begin, int end) {
+		for(int i = begin;i < end;i++) {
+			decoded[i] = std::make_unique<Row>();
+			decodeRow(first + i, *decoded[i]);
+		}
+	};
+
+	auto &workers   = decodeWorkers();
+	auto  cells     = static_cast<std::size_t>(rows) * std::max<std::size_t>(plan.size(), 1);
+	auto  chunks    = std::min(workers.size() + 1, cells / parallelCells + 1);
+	int   chunkRows = static_cast<int>((static_cast<std::size_t>(rows) + chunks - 1) / chunks);
+
+	std::vector<std::future<void>> pending;
+	std::exception_ptr             failure;
+	try {
+		for(std::size_t chunk = 1;chunk < chunks;chunk++) {
+			int begin = static_cast<int>(chunk) * chunkRows;
+			int end   = std::min(rows, begin + chunkRows);
+			if(begin >= end) {
+				break;
+			}
+			pending.push_back(workers[chunk - 1]->submit([&decodeRange, begin, end](){
+				decodeRange(begin, end);
+			}));
+		}
+		decodeRange(0, std::min(rows, chunkRows));
+	}catch(...) {
+		failure = std::current_exception();
+	}
+
+	/* The rows are referenced by all workers until they are done
+	 * so the stack must not be unwound before.
+	 */
+	for(auto &task : pending) {
+		task.wait();
+	}
+	for(auto &task : pending) {
+		try {
+			task.get();
+		}catch(...) {
+			if(!failure) {
+				failure = std::current_exception();
+			}
+		}
+	}
+	if(failure) {
+		std::rethrow_exception(failure);
+	}
+
+	if(auto materialized = dynamic_cast<Table*>(&table)) {
+		materialized->data.reserve(materialized->data.size() + decoded.size());
+	}
+	for(auto &row : decoded) {
+		table << std::move(row);
+	}
+
+	iRow += rows;
+	return true;
 }
 
 int PostgresqlStatement::execute(Table *resultTable) {
+	ECS_PROFILE_ZONE("PostgresqlStatement::execute");
+
 	bool rc = true;
 	iRow = 0;
 
@@ -226,6 +389,27 @@ int PostgresqlStatement::execute(Table *resultTable) {
 			break;
 		case types::typeId::blob:
 			break;
+		case types::typeId::timestamp: {
+			/* Sent in the binary format which is the number of microseconds
+			 * since 2000-01-01 in network byte order. The type is left to
+			 * the server so timestamp columns get the value as UTC instead
+			 * of it being shifted from timestamptz by the session time zone.
+			 */
+			std::int64_t value = boost::endian::native_to_big(
+					cell->cast_reference<ecs::time::Timestamp>().getMicroseconds() - postgresEpochOffset);
+			stringValues[i].assign(reinterpret_cast<const char*>(&value), sizeof(value));
+			paramValues[i]  = stringValues[i].data();
+			paramLengths[i] = sizeof(value);
+			paramFormats[i] = 1;
+			break;
+		}
+		case types::typeId::uuid:
+			stringValues[i].assign(reinterpret_cast<const char*>(cell->cast_reference<types::Uuid::type>().data()), 16);
+			paramValues[i]  = stringValues[i].data();
+			paramLengths[i] = 16;
+			paramFormats[i] = 1;
+			paramTypes[i]   = UUIDOID;
+			break;
 		default:
 			rc = false;
 			setErrorString("None of the bind types match");
@@ -244,7 +428,7 @@ int PostgresqlStatement::execute(Table *resultTable) {
 	result.reset(PQexecParams(connection,
 						command,
 						nParams,
-						nullptr,
+						paramTypes.size() ? paramTypes.data() : nullptr,
 						paramValues.size() ? paramValues.data() : nullptr,
 						paramLengths.size() ? paramLengths.data() : nullptr,
 						paramFormats.size() ? paramFormats.data() : nullptr,
@@ -264,9 +448,13 @@ int PostgresqlStatement::execute(Table *resultTable) {
 		return -3;
 	}
 
-	/* Put all column names in the result table */
+	/* Put all column names in the result table and choose the
+	 * decoding of every column once.
+	 */
+	plan.clear();
 	for(std::int64_t i = 0;i < PQnfields(result.get());++i) {
 		resultTable->columnNames.push_back(PQfname(result.get(), i));
+		plan.push_back(getColumn(PQftype(result.get(), i), nativeTimestamps));
 	}
 
 	/* Return successful result */
@@ -290,7 +478,7 @@ void PostgresqlStatement::clearBindings() {
 }
 
 
-PostresqlConnection::PostresqlConnection() : connection(nullptr) {
+PostresqlConnection::PostresqlConnection() : connection(nullptr), nativeTimestamps(false) {
 		
 }
 	
@@ -316,7 +504,7 @@ std::string PostresqlConnection::getPluginName() {
 
 StatementImpl::ptr_T PostresqlConnection::prepare(const std::string &query) {
 	try {
-		return StatementImpl::uniquePtr_T(new PostgresqlStatement(connection, query)).release();
+		return StatementImpl::uniquePtr_T(new PostgresqlStatement(connection, query, nativeTimestamps)).release();
 	}catch(...) {
 		return nullptr;
 	}
@@ -329,6 +517,10 @@ ecs::db3::MigratorImpl* ecs::db3::PostresqlConnection::getMigrator(
 }
 
 bool PostresqlConnection::connect(const ConnectionParameters &parameters) {
+	ECS_PROFILE_ZONE("PostgresqlConnection::connect");
+
+	nativeTimestamps = parameters.getNativeTimestamps();
+
 	/* Connection options */
 	std::vector<std::pair<std::string, std::string>> options;
 	std::string                                      optionsString;
@@ -377,11 +569,79 @@ bool PostresqlConnection::connect(const ConnectionParameters &parameters) {
 		connection = nullptr;
 		return false;
 	}
-	
+
+	connectionString = optionsString;
+	return true;
+}
+
+void PostresqlConnection::startTransation() {
+	executeTransactionQuery("BEGIN;");
+}
+
+void PostresqlConnection::commitTransaction() {
+	executeTransactionQuery("COMMIT;");
+}
+
+void PostresqlConnection::rollbackTransaction() {
+	executeTransactionQuery("ROLLBACK;");
+}
+
+void PostresqlConnection::executeTransactionQuery(const char *query) {
+	std::unique_ptr<PGresult, decltype(&PostgresqlStatement::PGresultDeleter)> result(
+			PQexec(connection, query), &PostgresqlStatement::PGresultDeleter);
+
+	if(PQresultStatus(result.get()) != PGRES_COMMAND_OK) {
+		std::string error(PQerrorMessage(connection));
+		setErrorMessage(error);
+		throw std::runtime_error("Transaction control failed: " + error);
+	}
+}
+
+bool PostresqlConnection::listen(const std::string &channel, notificationListener_T listener) {
+	std::scoped_lock lock(listenerMutex);
+
+	if(connection == nullptr) {
+		setErrorMessage("Not connected");
+		return false;
+	}
+
+	try {
+		if(!this->listener) {
+			this->listener = std::make_unique<PostgresqlListener>(connectionString);
+		}
+
+		this->listener->listen(channel, std::move(listener));
+	}catch(const std::exception &e){
+		setErrorMessage(e.what());
+		return false;
+	}
+
+	return true;
+}
+
+bool PostresqlConnection::unlisten(const std::string &channel) {
+	std::scoped_lock lock(listenerMutex);
+
+	if(!listener) {
+		return true;
+	}
+
+	try {
+		listener->unlisten(channel);
+	}catch(const std::exception &e){
+		setErrorMessage(e.what());
+		return false;
+	}
+
 	return true;
 }
 
 bool PostresqlConnection::disconnect() {
+	{
+		std::scoped_lock lock(listenerMutex);
+		listener.reset();
+	}
+
 	if(connection == nullptr){
 		return false;
 	}
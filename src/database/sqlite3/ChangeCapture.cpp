@@ -0,0 +1,151 @@
+/*
+ * ChangeCapture.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <ecs/database/sqlite3/ChangeCapture.hpp>
+#include <ecs/database/sqlite3/sqlite3.hpp>
+#include <algorithm>
+#include <memory>
+
+using namespace ecs::db3;
+
+namespace {
+
+/** Savepoint names are case insensitive and the innermost one wins */
+std::vector<std::pair<std::string, std::size_t>>::iterator findSavepoint(
+		std::vector<std::pair<std::string, std::size_t>> &savepoints, const std::string &name) {
+	for(auto it = savepoints.rbegin();it != savepoints.rend();++it) {
+		if(sqlite3_stricmp(it->first.c_str(), name.c_str()) == 0) {
+			return std::prev(it.base());
+		}
+	}
+
+	return savepoints.end();
+}
+
+}
+
+Sqlite3ChangeCapture::Sqlite3ChangeCapture(publish_T publish) : publish(std::move(publish)), sequence(0) {
+
+}
+
+void Sqlite3ChangeCapture::record(sqlite3 *connection, int operation, const char *database, const char *table,
+		sqlite3_int64 oldRowid, sqlite3_int64 newRowid) {
+	ChangeEvent event;
+	event.database = database;
+	event.table    = table;
+
+	switch(operation) {
+		case SQLITE_INSERT:
+			event.operation = ChangeOperation::insert;
+			event.newRowid  = newRowid;
+			break;
+		case SQLITE_UPDATE:
+			event.operation = ChangeOperation::update;
+			event.oldRowid  = oldRowid;
+			event.newRowid  = newRowid;
+			break;
+		default:
+			event.operation = ChangeOperation::remove;
+			event.oldRowid  = oldRowid;
+			break;
+	}
+
+#ifdef SQLITE_ENABLE_PREUPDATE_HOOK
+	if(connection != nullptr) {
+		auto          columns = sqlite3_preupdate_count(connection);
+		sqlite3_value *cell   = nullptr;
+
+		for(int i = 0;i < columns;++i) {
+			if(operation != SQLITE_INSERT && sqlite3_preupdate_old(connection, i, &cell) == SQLITE_OK) {
+				event.oldValues.push_back(value(cell));
+			}
+
+			if(operation != SQLITE_DELETE && sqlite3_preupdate_new(connection, i, &cell) == SQLITE_OK) {
+				event.newValues.push_back(value(cell));
+			}
+		}
+	}
+#endif
+
+	events.push_back(std::move(event));
+}
+
+void Sqlite3ChangeCapture::savepoint(Sqlite3Savepoint operation, const std::string &name) {
+	if(operation == Sqlite3Savepoint::begin) {
+		savepoints.emplace_back(name, events.size());
+		return;
+	}
+
+	auto position = findSavepoint(savepoints, name);
+	if(position == savepoints.end()) {
+		return;
+	}
+
+	if(operation == Sqlite3Savepoint::rollback) {
+		/* The savepoint itself stays open after a rollback */
+		events.erase(events.begin() + position->second, events.end());
+		savepoints.erase(position + 1, savepoints.end());
+	}else if(operation == Sqlite3Savepoint::release) {
+		savepoints.erase(position, savepoints.end());
+	}
+}
+
+void Sqlite3ChangeCapture::commit() {
+	savepoints.clear();
+
+	/* Read only transactions have nothing to publish */
+	if(events.empty()) {
+		return;
+	}
+
+	ChangeBatch batch;
+	batch.sequence = ++sequence;
+	batch.events.swap(events);
+	publish(std::move(batch));
+}
+
+void Sqlite3ChangeCapture::rollback() {
+	savepoints.clear();
+	events.clear();
+}
+
+ecs::db3::types::cell_T Sqlite3ChangeCapture::value(sqlite3_value *value) {
+	switch(sqlite3_value_type(value)) {
+		case SQLITE_INTEGER:
+			return types::cell_T(static_cast<std::int64_t>(sqlite3_value_int64(value)), types::typeId::int64_T);
+		case SQLITE_FLOAT:
+			return types::cell_T(sqlite3_value_double(value), types::typeId::double_T);
+		case SQLITE_TEXT:
+			return types::cell_T(std::string(reinterpret_cast<const char*>(sqlite3_value_text(value)),
+					sqlite3_value_bytes(value)), types::typeId::string);
+		case SQLITE_BLOB:
+			{
+				/* The value is only valid inside the hook so it is copied */
+				std::shared_ptr<std::basic_streambuf<char>> blob = std::make_shared<Sqlite3Blob>(
+						const_cast<void*>(sqlite3_value_blob(value)), sqlite3_value_bytes(value));
+				return types::cell_T(std::move(blob), types::typeId::blob);
+			}
+		default:
+			return types::cell_T(nullptr, types::typeId::null);
+	}
+}
@@ -0,0 +1,298 @@
+/*
+ * Hooks.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <ecs/database/sqlite3/Hooks.hpp>
+#include <algorithm>
+
+using namespace ecs::db3;
+
+namespace {
+
+/** Functions which return a different value on every call */
+const char *const volatileFunctions[] = {
+	"random", "randomblob", "changes", "total_changes", "last_insert_rowid",
+	"date", "time", "datetime", "julianday", "strftime", "unixepoch", "timediff",
+	"current_date", "current_time", "current_timestamp",
+	"utctime", "utclocaltime", "utc_timestamp", "utc_timestamp_local",
+	"utc_timestamp_ms", "utc_timestamp_us", "utc_timestamp_local_ms", "utc_timestamp_local_us",
+	"uuid4", "uuid_generate_v4", "uuid_generate_v7", "uuid_blob", "uuid_blob_v7"
+};
+
+void addTable(std::vector<std::string> &tables, const char *database, const char *table) {
+	std::string name = std::string(database != nullptr ? database : "main") + "." + table;
+	if(std::find(tables.begin(), tables.end(), name) == tables.end()) {
+		tables.push_back(std::move(name));
+	}
+}
+
+/** Holds the database mutex of a serialized connection */
+class DatabaseLock {
+public:
+	explicit DatabaseLock(sqlite3 *connection) : mutex(sqlite3_db_mutex(connection)) {
+		sqlite3_mutex_enter(mutex);
+	}
+
+	~DatabaseLock() {
+		sqlite3_mutex_leave(mutex);
+	}
+
+private:
+	sqlite3_mutex *mutex;
+};
+
+}
+
+Sqlite3Hooks::Sqlite3Hooks(sqlite3 *connection, std::shared_ptr<Sqlite3ResultCache> resultCache) :
+		connection(connection), resultCache(std::move(resultCache)), capturing(false) {
+	/* Without a cache the hooks are installed by the change capture */
+	if(this->resultCache) {
+		sqlite3_update_hook(connection, &Sqlite3Hooks::updateHook, this);
+		sqlite3_rollback_hook(connection, &Sqlite3Hooks::rollbackHook, this);
+	}
+}
+
+void Sqlite3Hooks::detach() {
+	if(connection == nullptr) {
+		return;
+	}
+
+	DatabaseLock lock(connection);
+	sqlite3_update_hook(connection, nullptr, nullptr);
+	sqlite3_rollback_hook(connection, nullptr, nullptr);
+	sqlite3_commit_hook(connection, nullptr, nullptr);
+#ifdef SQLITE_ENABLE_PREUPDATE_HOOK
+	sqlite3_preupdate_hook(connection, nullptr, nullptr);
+#endif
+	capture.reset();
+	capturing  = false;
+	connection = nullptr;
+
+	if(resultCache) {
+		resultCache->clear();
+	}
+}
+
+const std::shared_ptr<Sqlite3ResultCache> &Sqlite3Hooks::getResultCache() const {
+	return resultCache;
+}
+
+void Sqlite3Hooks::captureChanges(Sqlite3ChangeCapture::publish_T publish) {
+	if(connection == nullptr) {
+		return;
+	}
+
+	DatabaseLock lock(connection);
+	capture = std::make_unique<Sqlite3ChangeCapture>(std::move(publish));
+	sqlite3_update_hook(connection, &Sqlite3Hooks::updateHook, this);
+	sqlite3_rollback_hook(connection, &Sqlite3Hooks::rollbackHook, this);
+	sqlite3_commit_hook(connection, &Sqlite3Hooks::commitHook, this);
+#ifdef SQLITE_ENABLE_PREUPDATE_HOOK
+	sqlite3_preupdate_hook(connection, &Sqlite3Hooks::preupdateHook, this);
+#endif
+	capturing = true;
+}
+
+bool Sqlite3Hooks::isCapturing() const {
+	return capturing;
+}
+
+bool Sqlite3Hooks::isActive() const {
+	return resultCache || capturing;
+}
+
+int Sqlite3Hooks::prepare(const std::string &query, sqlite3_stmt **stmt, const char **tail,
+		Sqlite3QueryAccess &access) {
+	/* The authorizer belongs to the connection so no other thread
+	 * may prepare a statement until it is removed again.
+	 */
+	DatabaseLock lock(connection);
+
+	AuthorizerContext context{this, &access};
+	sqlite3_set_authorizer(connection, &Sqlite3Hooks::authorizer, &context);
+	auto status = sqlite3_prepare_v2(connection, query.c_str(), -1, stmt, tail);
+	sqlite3_set_authorizer(connection, nullptr, nullptr);
+
+	return status;
+}
+
+void Sqlite3Hooks::classify(sqlite3_stmt *stmt, Sqlite3QueryAccess &access) {
+	sqlite3_stmt *copy = nullptr;
+	const char   *tail = nullptr;
+
+	if(connection == nullptr) {
+		return;
+	}
+
+	prepare(sqlite3_sql(stmt), &copy, &tail, access);
+	sqlite3_finalize(copy);
+}
+
+void Sqlite3Hooks::executed(const Sqlite3QueryAccess &access, bool succeeded) {
+	if(connection == nullptr) {
+		return;
+	}
+
+	DatabaseLock lock(connection);
+
+	/* The update hook is not called for WITHOUT ROWID tables and
+	 * the truncate optimization of DELETE.
+	 */
+	if(resultCache) {
+		for(auto &table : access.writes) {
+			resultCache->invalidate(table);
+		}
+
+		if(access.invalidatesAll) {
+			resultCache->clear();
+		}
+	}
+
+	if(capture && succeeded && access.savepoint != Sqlite3Savepoint::none) {
+		capture->savepoint(access.savepoint, access.savepointName);
+	}
+}
+
+int Sqlite3Hooks::authorizer(void *data, int action, const char *argument1, const char *argument2,
+		const char *database, const char *trigger) {
+	auto *context = static_cast<AuthorizerContext*>(data);
+	auto *access  = context->access;
+
+	switch(action) {
+		case SQLITE_READ:
+			addTable(access->reads, database, argument1);
+			if(context->hooks->resultCache && context->hooks->resultCache->isVolatileTable(argument1)) {
+				access->deterministic = false;
+			}
+			break;
+		case SQLITE_INSERT:
+		case SQLITE_UPDATE:
+		case SQLITE_DELETE:
+			addTable(access->writes, database, argument1);
+			break;
+		case SQLITE_FUNCTION:
+			for(auto name : volatileFunctions) {
+				if(sqlite3_stricmp(argument2, name) == 0) {
+					access->deterministic = false;
+					break;
+				}
+			}
+			break;
+		case SQLITE_SAVEPOINT:
+			access->savepointName = argument2 != nullptr ? argument2 : "";
+			if(sqlite3_stricmp(argument1, "BEGIN") == 0) {
+				access->savepoint = Sqlite3Savepoint::begin;
+			}else if(sqlite3_stricmp(argument1, "RELEASE") == 0) {
+				access->savepoint = Sqlite3Savepoint::release;
+			}else{
+				/* Rolling back to a savepoint does not call the rollback hook */
+				access->savepoint      = Sqlite3Savepoint::rollback;
+				access->invalidatesAll = true;
+			}
+			access->deterministic = false;
+			break;
+		case SQLITE_PRAGMA:
+		case SQLITE_TRANSACTION:
+		case SQLITE_ATTACH:
+		case SQLITE_DETACH:
+			access->deterministic = false;
+			break;
+		case SQLITE_CREATE_INDEX:
+		case SQLITE_CREATE_TABLE:
+		case SQLITE_CREATE_TEMP_INDEX:
+		case SQLITE_CREATE_TEMP_TABLE:
+		case SQLITE_CREATE_TEMP_TRIGGER:
+		case SQLITE_CREATE_TEMP_VIEW:
+		case SQLITE_CREATE_TRIGGER:
+		case SQLITE_CREATE_VIEW:
+		case SQLITE_CREATE_VTABLE:
+		case SQLITE_DROP_INDEX:
+		case SQLITE_DROP_TABLE:
+		case SQLITE_DROP_TEMP_INDEX:
+		case SQLITE_DROP_TEMP_TABLE:
+		case SQLITE_DROP_TEMP_TRIGGER:
+		case SQLITE_DROP_TEMP_VIEW:
+		case SQLITE_DROP_TRIGGER:
+		case SQLITE_DROP_VIEW:
+		case SQLITE_DROP_VTABLE:
+		case SQLITE_ALTER_TABLE:
+		case SQLITE_REINDEX:
+		case SQLITE_ANALYZE:
+			access->invalidatesAll = true;
+			break;
+		default:
+			break;
+	}
+
+	return SQLITE_OK;
+}
+
+void Sqlite3Hooks::updateHook(void *data, int operation, const char *database, const char *table,
+		sqlite3_int64 rowid) {
+	auto *hooks = static_cast<Sqlite3Hooks*>(data);
+
+	if(hooks->resultCache) {
+		hooks->resultCache->invalidate(std::string(database) + "." + table);
+	}
+
+#ifndef SQLITE_ENABLE_PREUPDATE_HOOK
+	/* Without the preupdate hook only the row ids are known */
+	if(hooks->capture) {
+		hooks->capture->record(nullptr, operation, database, table, rowid, rowid);
+	}
+#endif
+}
+
+void Sqlite3Hooks::preupdateHook(void *data, sqlite3 *connection, int operation, const char *database,
+		const char *table, sqlite3_int64 oldRowid, sqlite3_int64 newRowid) {
+	auto *hooks = static_cast<Sqlite3Hooks*>(data);
+
+	if(hooks->capture) {
+		hooks->capture->record(connection, operation, database, table, oldRowid, newRowid);
+	}
+}
+
+int Sqlite3Hooks::commitHook(void *data) {
+	auto *hooks = static_cast<Sqlite3Hooks*>(data);
+
+	if(hooks->capture) {
+		hooks->capture->commit();
+	}
+
+	/* Returning non zero would turn the commit into a rollback */
+	return 0;
+}
+
+void Sqlite3Hooks::rollbackHook(void *data) {
+	auto *hooks = static_cast<Sqlite3Hooks*>(data);
+
+	/* Results read inside the transaction saw the changes which
+	 * are undone now.
+	 */
+	if(hooks->resultCache) {
+		hooks->resultCache->clear();
+	}
+
+	if(hooks->capture) {
+		hooks->capture->rollback();
+	}
+}
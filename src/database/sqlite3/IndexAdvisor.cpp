@@ -0,0 +1,275 @@
+/*
+ * IndexAdvisor.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <ecs/database/sqlite3/IndexAdvisor.hpp>
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+#include <stdexcept>
+
+extern "C" ECS_EXPORT int SQLITE3_UUID_EXT(sqlite3 *,char **,const sqlite3_api_routines *);
+extern "C" ECS_EXPORT int SQLITE3_UTC_EXT(sqlite3 *,char **,const sqlite3_api_routines *);
+
+using namespace ecs::db3;
+
+namespace {
+
+const char *const candidateName = "ecs_advice_candidate";
+
+std::string quote(const std::string &identifier) {
+	std::string result = "\"";
+	for(auto c : identifier) {
+		if(c == '"') {
+			result += '"';
+		}
+		result += c;
+	}
+	return result + "\"";
+}
+
+std::string columnList(const std::vector<std::string> &columns) {
+	std::string result;
+	for(auto &column : columns) {
+		if(!result.empty()) {
+			result += ", ";
+		}
+		result += quote(column);
+	}
+	return result;
+}
+
+std::vector<std::string> planLines(const std::string &plan) {
+	std::vector<std::string> result;
+	std::istringstream       stream(plan);
+	std::string              line;
+	while(std::getline(stream, line)) {
+		auto start = line.find_first_not_of(' ');
+		if(start != std::string::npos) {
+			result.push_back(line.substr(start));
+		}
+	}
+	return result;
+}
+
+/** True when the plan scans a table or builds an automatic index */
+bool scans(const std::string &plan) {
+	for(auto &line : planLines(plan)) {
+		if((line.compare(0, 5, "SCAN ") == 0 && line != "SCAN CONSTANT ROW") ||
+				line.find("AUTOMATIC") != std::string::npos) {
+			return true;
+		}
+	}
+	return false;
+}
+
+}
+
+Sqlite3IndexAdvisor::Sqlite3IndexAdvisor(sqlite3 *connection) : whatIf(nullptr) {
+	if(sqlite3_open_v2(":memory:", &whatIf, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL) != SQLITE_OK) {
+		std::string message = sqlite3_errmsg(whatIf);
+		sqlite3_close_v2(whatIf);
+		throw std::runtime_error("Opening the index advisor database failed: " + message);
+	}
+
+	/* Statements may use the functions of the connection */
+	SQLITE3_UTC_EXT(whatIf, NULL, NULL);
+	SQLITE3_UUID_EXT(whatIf, NULL, NULL);
+
+	Sqlite3QueryLog::Untraced untraced;
+	sqlite3_stmt             *stmt = nullptr;
+
+	if(sqlite3_prepare_v2(connection,
+			"SELECT sql FROM main.sqlite_master WHERE sql IS NOT NULL AND type IN ('table', 'index', 'view') "
+			"AND name NOT LIKE 'sqlite_%' ORDER BY rowid;", -1, &stmt, nullptr) != SQLITE_OK) {
+		std::string message = sqlite3_errmsg(connection);
+		sqlite3_finalize(stmt);
+		sqlite3_close_v2(whatIf);
+		throw std::runtime_error("Reading the schema failed: " + message);
+	}
+
+	/* Virtual tables of unknown modules are left out and
+	 * statements using them are ignored later.
+	 */
+	while(sqlite3_step(stmt) == SQLITE_ROW) {
+		auto sql = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+		sqlite3_exec(whatIf, sql, nullptr, nullptr, nullptr);
+	}
+
+	sqlite3_finalize(stmt);
+}
+
+Sqlite3IndexAdvisor::~Sqlite3IndexAdvisor() {
+	sqlite3_close_v2(whatIf);
+}
+
+void Sqlite3IndexAdvisor::add(const Sqlite3WorkloadEntry &entry) {
+	if(!scans(Sqlite3QueryLog::explain(whatIf, entry.query))) {
+		return;
+	}
+
+	columns_T columns;
+	if(!readColumns(entry.query, columns)) {
+		return;
+	}
+
+	std::vector<std::pair<std::string, std::vector<std::string>>> proposals;
+
+	for(auto &table : columns) {
+		/* Columns the planner searches for alone */
+		std::vector<std::string> equalities;
+		std::vector<std::string> ranges;
+		for(auto &column : table.second) {
+			auto usage = evaluate(entry.query, table.first, {column});
+			if(usage.columns > 0) {
+				(usage.equality ? equalities : ranges).push_back(column);
+			}
+		}
+
+		/* A range can only follow the equality columns */
+		std::vector<std::string> candidate(equalities);
+		if(!ranges.empty()) {
+			candidate.push_back(ranges.front());
+		}
+
+		if(candidate.empty()) {
+			continue;
+		}
+
+		if(candidate.size() > 1) {
+			auto usage = evaluate(entry.query, table.first, candidate);
+			candidate.resize(std::max<std::size_t>(usage.columns, 1));
+		}
+
+		proposals.emplace_back(table.first, std::move(candidate));
+	}
+
+	/* The savings are split between the tables of the statement */
+	for(auto &proposal : proposals) {
+		propose(proposal.first, proposal.second,
+				(entry.fullscanSteps + entry.autoindexes) / proposals.size(), entry.query);
+	}
+}
+
+std::vector<IndexAdvice> Sqlite3IndexAdvisor::getAdvice() const {
+	std::vector<IndexAdvice> result;
+	result.reserve(advice.size());
+	for(auto &entry : advice) {
+		result.push_back(entry.second);
+	}
+
+	std::stable_sort(result.begin(), result.end(), [](const IndexAdvice &a, const IndexAdvice &b){
+		return a.savedSteps > b.savedSteps;
+	});
+	return result;
+}
+
+int Sqlite3IndexAdvisor::readAuthorizer(void *data, int action, const char *argument1, const char *argument2,
+		const char *database, const char *trigger) {
+	if(action == SQLITE_READ && argument1 != nullptr && argument2 != nullptr && argument2[0] != '\0' &&
+			(database == nullptr || std::string(database) == "main")) {
+		auto &columns = (*static_cast<columns_T*>(data))[argument1];
+		if(std::find(columns.begin(), columns.end(), argument2) == columns.end()) {
+			columns.push_back(argument2);
+		}
+	}
+	return SQLITE_OK;
+}
+
+bool Sqlite3IndexAdvisor::readColumns(const std::string &query, columns_T &columns) {
+	sqlite3_stmt *stmt = nullptr;
+
+	sqlite3_set_authorizer(whatIf, &Sqlite3IndexAdvisor::readAuthorizer, &columns);
+	auto status = sqlite3_prepare_v2(whatIf, query.c_str(), -1, &stmt, nullptr);
+	sqlite3_set_authorizer(whatIf, nullptr, nullptr);
+	sqlite3_finalize(stmt);
+
+	/* The schema tables are read by the statement as well */
+	for(auto it = columns.begin();it != columns.end();) {
+		it = it->first.compare(0, 7, "sqlite_") == 0 ? columns.erase(it) : std::next(it);
+	}
+
+	return status == SQLITE_OK;
+}
+
+Sqlite3IndexAdvisor::Usage Sqlite3IndexAdvisor::evaluate(const std::string &query, const std::string &table,
+		const std::vector<std::string> &columns) {
+	Usage result;
+
+	auto create = std::string("CREATE INDEX ") + candidateName + " ON " + quote(table) + "(" + columnList(columns) + ");";
+	if(sqlite3_exec(whatIf, create.c_str(), nullptr, nullptr, nullptr) != SQLITE_OK) {
+		return result;
+	}
+
+	auto plan = Sqlite3QueryLog::explain(whatIf, query);
+	sqlite3_exec(whatIf, (std::string("DROP INDEX ") + candidateName + ";").c_str(), nullptr, nullptr, nullptr);
+
+	/* Like SEARCH items USING INDEX ecs_advice_candidate (name=? AND price>?) */
+	for(auto &line : planLines(plan)) {
+		auto index = line.find(std::string("INDEX ") + candidateName);
+		if(line.compare(0, 7, "SEARCH ") != 0 || index == std::string::npos) {
+			continue;
+		}
+
+		auto open  = line.find('(', index);
+		auto close = line.find(')', open);
+		if(open == std::string::npos || close == std::string::npos) {
+			continue;
+		}
+
+		auto terms = line.substr(open + 1, close - open - 1);
+		auto first = terms.substr(0, terms.find(" AND "));
+
+		result.columns  = 1;
+		for(auto position = terms.find(" AND ");position != std::string::npos;position = terms.find(" AND ", position + 1)) {
+			result.columns++;
+		}
+		result.equality = first.find("=?") != std::string::npos &&
+				first.find(">=?") == std::string::npos && first.find("<=?") == std::string::npos;
+		break;
+	}
+
+	return result;
+}
+
+void Sqlite3IndexAdvisor::propose(const std::string &table, const std::vector<std::string> &columns,
+		std::uint64_t savedSteps, const std::string &query) {
+	auto &entry = advice[std::make_pair(table, columns)];
+
+	if(entry.table.empty()) {
+		std::string name = "idx_" + table;
+		for(auto &column : columns) {
+			name += "_" + column;
+		}
+		std::replace_if(name.begin(), name.end(), [](char c){
+			return !std::isalnum(static_cast<unsigned char>(c)) && c != '_';
+		}, '_');
+
+		entry.table           = table;
+		entry.columns         = columns;
+		entry.createStatement = "CREATE INDEX IF NOT EXISTS " + quote(name) + " ON " + quote(table) +
+				"(" + columnList(columns) + ");";
+	}
+
+	entry.savedSteps += savedSteps;
+	entry.statements.push_back(query);
+}
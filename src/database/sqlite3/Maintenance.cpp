@@ -0,0 +1,241 @@
+/*
+ * Maintenance.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <ecs/database/sqlite3/Maintenance.hpp>
+#include <algorithm>
+#include <stdexcept>
+
+#ifndef SQLITE_DEFAULT_WAL_AUTOCHECKPOINT
+#define SQLITE_DEFAULT_WAL_AUTOCHECKPOINT 1000
+#endif
+
+using namespace ecs::db3;
+
+Sqlite3Maintenance::Sqlite3Maintenance(sqlite3 *connection, int checkpointPages,
+		std::chrono::milliseconds idleTime, int vacuumPages) :
+		connection(connection), maintenanceConnection(nullptr),
+		checkpointPages(checkpointPages), idleTime(idleTime), vacuumPages(vacuumPages),
+		stop(false), walPages(0), maxWalPages(0), walPagesWritten(0), lastCommit(now()),
+		checkpointRequested(false), checkpointedWritten(0), idleHandledCommit(0),
+		checkpoints(0), sizeCheckpoints(0), idleCheckpoints(0), checkpointedFrames(0),
+		lastCheckpointDuration(0), maxCheckpointDuration(0), totalCheckpointDuration(0),
+		vacuums(0), vacuumedPages(0) {
+	const char *filename = sqlite3_db_filename(connection, "main");
+
+	/* In-memory and temporary databases have no WAL */
+	if(filename == nullptr || filename[0] == '\0') {
+		throw std::runtime_error("Background maintenance needs a database file");
+	}
+
+	if(sqlite3_open_v2(filename, &maintenanceConnection,
+			SQLITE_OPEN_READWRITE | SQLITE_OPEN_FULLMUTEX, NULL) != SQLITE_OK) {
+		std::string message = sqlite3_errmsg(maintenanceConnection);
+		sqlite3_close_v2(maintenanceConnection);
+		throw std::runtime_error("Opening the maintenance connection failed: " + message);
+	}
+
+	/* The maintenance connection must never checkpoint on its own
+	 * and only waits shortly for the write lock of the vacuum.
+	 */
+	sqlite3_wal_autocheckpoint(maintenanceConnection, 0);
+	sqlite3_busy_timeout(maintenanceConnection, 10);
+
+	/* Replaces the automatic checkpoint of the connection */
+	sqlite3_wal_hook(connection, &Sqlite3Maintenance::walHook, this);
+
+	thread = std::thread(&Sqlite3Maintenance::run, this);
+}
+
+Sqlite3Maintenance::~Sqlite3Maintenance() {
+	sqlite3_wal_autocheckpoint(connection, SQLITE_DEFAULT_WAL_AUTOCHECKPOINT);
+
+	{
+		std::scoped_lock lock(mutex);
+		stop = true;
+	}
+
+	wakeup.notify_one();
+
+	if(thread.joinable()) {
+		thread.join();
+	}
+
+	sqlite3_close_v2(maintenanceConnection);
+}
+
+void Sqlite3Maintenance::getStatistics(MaintenanceStatistics &statistics) const {
+	statistics.active                  = true;
+	statistics.checkpoints             = checkpoints;
+	statistics.sizeCheckpoints         = sizeCheckpoints;
+	statistics.idleCheckpoints         = idleCheckpoints;
+	statistics.checkpointedFrames      = checkpointedFrames;
+	statistics.lastCheckpointDuration  = std::chrono::microseconds(lastCheckpointDuration);
+	statistics.maxCheckpointDuration   = std::chrono::microseconds(maxCheckpointDuration);
+	statistics.totalCheckpointDuration = std::chrono::microseconds(totalCheckpointDuration);
+	statistics.walPages                = walPages;
+	statistics.maxWalPages             = maxWalPages;
+	statistics.walPagesWritten         = walPagesWritten;
+	statistics.vacuums                 = vacuums;
+	statistics.vacuumedPages           = vacuumedPages;
+}
+
+int Sqlite3Maintenance::walHook(void *data, sqlite3 *connection, const char *dbName, int pages) {
+	auto self    = reinterpret_cast<Sqlite3Maintenance*>(data);
+	auto current = static_cast<std::uint64_t>(pages);
+	auto last    = self->walPages.exchange(current, std::memory_order_relaxed);
+
+	/* A smaller WAL means it was restarted from the beginning */
+	auto growth  = current > last ? current - last : current;
+	auto written = self->walPagesWritten.fetch_add(growth, std::memory_order_relaxed) + growth;
+
+	if(current > self->maxWalPages.load(std::memory_order_relaxed)) {
+		self->maxWalPages.store(current, std::memory_order_relaxed);
+	}
+
+	self->lastCommit.store(self->now(), std::memory_order_relaxed);
+
+	/* Only the commit crossing the limit wakes up the thread. The
+	 * others just record the size.
+	 */
+	if(written - self->checkpointedWritten.load(std::memory_order_relaxed) >= static_cast<std::uint64_t>(self->checkpointPages) &&
+			!self->checkpointRequested.exchange(true)) {
+		std::scoped_lock lock(self->mutex);
+		self->wakeup.notify_one();
+	}
+
+	return SQLITE_OK;
+}
+
+void Sqlite3Maintenance::run() {
+	std::unique_lock lock(mutex);
+
+	while(!stop) {
+		auto idleSince = lastCommit.load(std::memory_order_relaxed);
+		auto wait      = std::chrono::microseconds(idleTime);
+
+		if(idleSince != idleHandledCommit) {
+			wait = std::max(std::chrono::microseconds(idleSince + wait.count() - now()),
+					std::chrono::microseconds(0));
+		}
+
+		wakeup.wait_for(lock, wait, [this](){
+			return stop || checkpointRequested.load();
+		});
+
+		if(stop) {
+			break;
+		}
+
+		lock.unlock();
+
+		if(checkpointRequested.exchange(false)) {
+			checkpoint(false);
+		}
+
+		idleSince = lastCommit.load(std::memory_order_relaxed);
+
+		if(idleSince != idleHandledCommit &&
+				now() - idleSince >= std::chrono::microseconds(idleTime).count()) {
+			incrementalVacuum();
+
+			if(walPagesWritten.load(std::memory_order_relaxed) != checkpointedWritten) {
+				checkpoint(true);
+			}
+
+			idleHandledCommit = idleSince;
+		}
+
+		lock.lock();
+	}
+}
+
+void Sqlite3Maintenance::checkpoint(bool idle) {
+	int  logFrames          = 0;
+	int  checkpointedFrames = 0;
+	auto written            = walPagesWritten.load(std::memory_order_relaxed);
+	auto start              = now();
+
+	/* PASSIVE never waits for readers or writers. Frames which can not
+	 * be copied now are copied by one of the next checkpoints.
+	 */
+	auto status = sqlite3_wal_checkpoint_v2(maintenanceConnection, "main",
+			SQLITE_CHECKPOINT_PASSIVE, &logFrames, &checkpointedFrames);
+	auto duration = now() - start;
+
+	if(status != SQLITE_OK) {
+		return;
+	}
+
+	checkpointedWritten = written;
+	checkpoints++;
+	(idle ? idleCheckpoints : sizeCheckpoints)++;
+	this->checkpointedFrames += static_cast<std::uint64_t>(std::max(checkpointedFrames, 0));
+	lastCheckpointDuration  = duration;
+	totalCheckpointDuration += duration;
+
+	if(duration > maxCheckpointDuration) {
+		maxCheckpointDuration = duration;
+	}
+}
+
+void Sqlite3Maintenance::incrementalVacuum() {
+	if(vacuumPages <= 0) {
+		return;
+	}
+
+	auto freePages = [this]() -> std::int64_t {
+		sqlite3_stmt *stmt   = nullptr;
+		std::int64_t  result = -1;
+
+		if(sqlite3_prepare_v2(maintenanceConnection, "PRAGMA freelist_count;", -1, &stmt, nullptr) == SQLITE_OK &&
+				sqlite3_step(stmt) == SQLITE_ROW) {
+			result = sqlite3_column_int64(stmt, 0);
+		}
+
+		sqlite3_finalize(stmt);
+		return result;
+	};
+
+	auto before = freePages();
+
+	if(before <= 0) {
+		return;
+	}
+
+	std::string query = "PRAGMA incremental_vacuum(" + std::to_string(vacuumPages) + ");";
+
+	if(sqlite3_exec(maintenanceConnection, query.c_str(), NULL, NULL, NULL) != SQLITE_OK) {
+		return;
+	}
+
+	auto after = freePages();
+
+	if(after >= 0 && after < before) {
+		vacuums++;
+		vacuumedPages += static_cast<std::uint64_t>(before - after);
+	}
+}
+
+std::int64_t Sqlite3Maintenance::now() const {
+	return std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,415 @@
+/*
+ * MemoryTableModule.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <ecs/database/sqlite3/MemoryTableModule.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+using namespace ecs::db3;
+
+const sqlite3_module ecs::db3::Sqlite3MemoryTableModule::module = {
+	0,                                      /* iVersion */
+	nullptr,                                /* xCreate: eponymous-only */
+	&Sqlite3MemoryTableModule::xConnect,
+	&Sqlite3MemoryTableModule::xBestIndex,
+	&Sqlite3MemoryTableModule::xDisconnect,
+	&Sqlite3MemoryTableModule::xDisconnect, /* xDestroy */
+	&Sqlite3MemoryTableModule::xOpen,
+	&Sqlite3MemoryTableModule::xClose,
+	&Sqlite3MemoryTableModule::xFilter,
+	&Sqlite3MemoryTableModule::xNext,
+	&Sqlite3MemoryTableModule::xEof,
+	&Sqlite3MemoryTableModule::xColumn,
+	&Sqlite3MemoryTableModule::xRowid,
+	nullptr,                                /* xUpdate: read only */
+	nullptr,                                /* xBegin */
+	nullptr,                                /* xSync */
+	nullptr,                                /* xCommit */
+	nullptr,                                /* xRollback */
+	nullptr,                                /* xFindFunction */
+	nullptr,                                /* xRename */
+	nullptr,                                /* xSavepoint */
+	nullptr,                                /* xRelease */
+	nullptr,                                /* xRollbackTo */
+	nullptr                                 /* xShadowName */
+};
+
+int ecs::db3::Sqlite3MemoryTableModule::registerTable(sqlite3 *connection,
+		const std::string &name, MemoryTable::sharedPtr_T table) {
+	/* Owned by sqlite and released with destroyModule */
+	auto data = new MemoryTable::sharedPtr_T(std::move(table));
+	return sqlite3_create_module_v2(connection, name.c_str(), &module, data, &destroyModule);
+}
+
+void ecs::db3::Sqlite3MemoryTableModule::destroyModule(void *data) {
+	delete reinterpret_cast<MemoryTable::sharedPtr_T*>(data);
+}
+
+int ecs::db3::Sqlite3MemoryTableModule::xConnect(sqlite3 *connection, void *data,
+		int argc, const char *const *argv, sqlite3_vtab **vtab, char **error) {
+	auto table = *reinterpret_cast<MemoryTable::sharedPtr_T*>(data);
+	std::string schema = "CREATE TABLE x(";
+
+	for(auto &column : table->getColumns()) {
+		/* Quote the column name so every name is allowed */
+		schema += "\"";
+		for(auto c : column.name) {
+			schema += c;
+			if(c == '"') {
+				schema += c;
+			}
+		}
+		schema += "\" ";
+
+		switch(column.type) {
+		case types::typeId::int64_T:
+			schema += "INTEGER";
+			break;
+		case types::typeId::double_T:
+			schema += "REAL";
+			break;
+		default:
+			schema += "TEXT";
+			break;
+		}
+
+		schema += ",";
+	}
+
+	if(table->getColumns().empty()) {
+		*error = sqlite3_mprintf("Memory table %s has no columns", argv[0]);
+		return SQLITE_ERROR;
+	}
+
+	schema.back() = ')';
+
+	auto status = sqlite3_declare_vtab(connection, schema.c_str());
+
+	if(status != SQLITE_OK) {
+		return status;
+	}
+
+	auto result   = new VirtualTable();
+	result->table = std::move(table);
+	*vtab         = result;
+	return SQLITE_OK;
+}
+
+int ecs::db3::Sqlite3MemoryTableModule::xDisconnect(sqlite3_vtab *vtab) {
+	delete static_cast<VirtualTable*>(vtab);
+	return SQLITE_OK;
+}
+
+int ecs::db3::Sqlite3MemoryTableModule::xBestIndex(sqlite3_vtab *vtab, sqlite3_index_info *info) {
+	auto       &columns  = static_cast<VirtualTable*>(vtab)->table->getColumns();
+	double      rows     = std::max<double>(static_cast<VirtualTable*>(vtab)->table->size(), 1.0);
+	double      cost     = rows;
+	int         argument = 0;
+	bool        search   = false;
+	std::string plan;
+
+	for(int i = 0;i < info->nConstraint;++i) {
+		auto &constraint = info->aConstraint[i];
+
+		if(!constraint.usable || constraint.iColumn < 0) {
+			continue;
+		}
+
+		switch(constraint.op) {
+		case SQLITE_INDEX_CONSTRAINT_EQ:
+		case SQLITE_INDEX_CONSTRAINT_LT:
+		case SQLITE_INDEX_CONSTRAINT_LE:
+		case SQLITE_INDEX_CONSTRAINT_GT:
+		case SQLITE_INDEX_CONSTRAINT_GE:
+			break;
+		default:
+			continue;
+		}
+
+		auto &column = columns[constraint.iColumn];
+
+		/* Text is only compared bytewise */
+		if(column.type == types::typeId::string &&
+				sqlite3_stricmp(sqlite3_vtab_collation(info, i), "BINARY") != 0) {
+			continue;
+		}
+
+		info->aConstraintUsage[i].argvIndex = ++argument;
+		info->aConstraintUsage[i].omit      = 0;
+		plan += std::to_string(constraint.iColumn) + ":" + std::to_string(constraint.op) + ",";
+
+		if(constraint.op == SQLITE_INDEX_CONSTRAINT_EQ) {
+			rows = std::max(column.sorted ? 1.0 : rows / 10.0, 1.0);
+		}else{
+			rows = std::max(rows / 4.0, 1.0);
+		}
+
+		search = search || column.sorted;
+	}
+
+	/* The rows are returned in memory order so a sorted
+	 * column does not need to be sorted again.
+	 */
+	if(info->nOrderBy == 1 && info->aOrderBy[0].iColumn >= 0 &&
+			columns[info->aOrderBy[0].iColumn].sorted && !info->aOrderBy[0].desc) {
+		info->orderByConsumed = 1;
+	}
+
+	if(search) {
+		cost = std::log2(std::max<double>(static_cast<VirtualTable*>(vtab)->table->size(), 2.0)) + rows;
+	}
+
+	if(!plan.empty()) {
+		info->idxStr           = sqlite3_mprintf("%s", plan.c_str());
+		info->needToFreeIdxStr = 1;
+	}
+
+	info->estimatedCost = cost;
+	info->estimatedRows = static_cast<sqlite3_int64>(rows);
+	return SQLITE_OK;
+}
+
+int ecs::db3::Sqlite3MemoryTableModule::xOpen(sqlite3_vtab *vtab, sqlite3_vtab_cursor **cursor) {
+	auto result   = new Cursor();
+	result->table = static_cast<VirtualTable*>(vtab)->table.get();
+	result->row   = 0;
+	result->end   = 0;
+	*cursor       = result;
+	return SQLITE_OK;
+}
+
+int ecs::db3::Sqlite3MemoryTableModule::xClose(sqlite3_vtab_cursor *cursor) {
+	auto self = static_cast<Cursor*>(cursor);
+
+	for(auto &filter : self->filters) {
+		sqlite3_value_free(filter.value);
+	}
+
+	delete self;
+	return SQLITE_OK;
+}
+
+bool ecs::db3::Sqlite3MemoryTableModule::comparable(types::typeId type, int valueType) {
+	switch(type) {
+	case types::typeId::int64_T:
+	case types::typeId::double_T:
+		return valueType == SQLITE_INTEGER || valueType == SQLITE_FLOAT;
+	default:
+		return valueType == SQLITE_TEXT;
+	}
+}
+
+bool ecs::db3::Sqlite3MemoryTableModule::compare(const MemoryTable *table, std::size_t row,
+		std::size_t column, sqlite3_value *value, int &result) {
+	auto valueType = sqlite3_value_type(value);
+	auto type      = table->getColumns()[column].type;
+
+	if(!comparable(type, valueType)) {
+		return false;
+	}
+
+	if(type == types::typeId::int64_T && valueType == SQLITE_INTEGER) {
+		auto a = table->getInt64(row, column);
+		auto b = sqlite3_value_int64(value);
+		result = (a > b) - (a < b);
+	}else if(type == types::typeId::int64_T) {
+		auto a = static_cast<double>(table->getInt64(row, column));
+		auto b = sqlite3_value_double(value);
+		result = (a > b) - (a < b);
+	}else if(type == types::typeId::double_T) {
+		auto a = table->getDouble(row, column);
+		auto b = sqlite3_value_double(value);
+		result = (a > b) - (a < b);
+	}else{
+		auto a = table->getText(row, column);
+		auto b = std::string_view(reinterpret_cast<const char*>(sqlite3_value_text(value)),
+				sqlite3_value_bytes(value));
+		auto c = a.compare(b);
+		result = (c > 0) - (c < 0);
+	}
+
+	return true;
+}
+
+bool ecs::db3::Sqlite3MemoryTableModule::matches(int comparison, unsigned char op) {
+	switch(op) {
+	case SQLITE_INDEX_CONSTRAINT_EQ:
+		return comparison == 0;
+	case SQLITE_INDEX_CONSTRAINT_LT:
+		return comparison < 0;
+	case SQLITE_INDEX_CONSTRAINT_LE:
+		return comparison <= 0;
+	case SQLITE_INDEX_CONSTRAINT_GT:
+		return comparison > 0;
+	case SQLITE_INDEX_CONSTRAINT_GE:
+		return comparison >= 0;
+	default:
+		return true;
+	}
+}
+
+void ecs::db3::Sqlite3MemoryTableModule::moveToMatch(Cursor *cursor) {
+	for(;cursor->row < cursor->end;++cursor->row) {
+		bool match = true;
+
+		for(auto &filter : cursor->filters) {
+			int comparison;
+
+			if(compare(cursor->table, cursor->row, filter.column, filter.value, comparison) &&
+					!matches(comparison, filter.op)) {
+				match = false;
+				break;
+			}
+		}
+
+		if(match) {
+			return;
+		}
+	}
+}
+
+int ecs::db3::Sqlite3MemoryTableModule::xFilter(sqlite3_vtab_cursor *cursor, int idxNum,
+		const char *idxStr, int argc, sqlite3_value **argv) {
+	auto self    = static_cast<Cursor*>(cursor);
+	auto table   = self->table;
+	auto &columns = table->getColumns();
+
+	for(auto &filter : self->filters) {
+		sqlite3_value_free(filter.value);
+	}
+
+	self->filters.clear();
+	self->row = 0;
+	self->end = table->size();
+
+	for(int i = 0;i < argc && idxStr != nullptr;++i) {
+		char *next;
+		Filter filter;
+		filter.column = std::strtoul(idxStr, &next, 10);
+		filter.op     = static_cast<unsigned char>(std::strtoul(next + 1, &next, 10));
+		idxStr        = next + 1;
+
+		/* A comparison with NULL is never true */
+		if(sqlite3_value_type(argv[i]) == SQLITE_NULL) {
+			self->end = self->row;
+			return SQLITE_OK;
+		}
+
+		filter.value = sqlite3_value_dup(argv[i]);
+
+		if(filter.value == nullptr) {
+			return SQLITE_NOMEM;
+		}
+
+		self->filters.push_back(filter);
+		int comparison;
+
+		if(!columns[filter.column].sorted ||
+				!comparable(columns[filter.column].type, sqlite3_value_type(filter.value))) {
+			continue;
+		}
+
+		/* Narrow the row range with a binary search. The predicates
+		 * select the first row not less or the first row greater than
+		 * the value.
+		 */
+		auto firstRow = [&](bool orEqual) {
+			std::size_t low = self->row, high = self->end;
+			while(low < high) {
+				auto middle = low + (high - low) / 2;
+				compare(table, middle, filter.column, filter.value, comparison);
+				if(comparison < 0 || (comparison == 0 && !orEqual)) {
+					low = middle + 1;
+				}else{
+					high = middle;
+				}
+			}
+			return low;
+		};
+
+		switch(filter.op) {
+		case SQLITE_INDEX_CONSTRAINT_EQ: {
+			auto begin = firstRow(true);
+			self->end  = firstRow(false);
+			self->row  = begin;
+			break;
+		}
+		case SQLITE_INDEX_CONSTRAINT_LT:
+			self->end = firstRow(true);
+			break;
+		case SQLITE_INDEX_CONSTRAINT_LE:
+			self->end = firstRow(false);
+			break;
+		case SQLITE_INDEX_CONSTRAINT_GT:
+			self->row = firstRow(false);
+			break;
+		case SQLITE_INDEX_CONSTRAINT_GE:
+			self->row = firstRow(true);
+			break;
+		}
+
+		self->end = std::max(self->row, self->end);
+	}
+
+	moveToMatch(self);
+	return SQLITE_OK;
+}
+
+int ecs::db3::Sqlite3MemoryTableModule::xNext(sqlite3_vtab_cursor *cursor) {
+	auto self = static_cast<Cursor*>(cursor);
+	self->row++;
+	moveToMatch(self);
+	return SQLITE_OK;
+}
+
+int ecs::db3::Sqlite3MemoryTableModule::xEof(sqlite3_vtab_cursor *cursor) {
+	auto self = static_cast<Cursor*>(cursor);
+	return self->row >= self->end;
+}
+
+int ecs::db3::Sqlite3MemoryTableModule::xColumn(sqlite3_vtab_cursor *cursor,
+		sqlite3_context *context, int column) {
+	auto self = static_cast<Cursor*>(cursor);
+
+	switch(self->table->getColumns()[column].type) {
+	case types::typeId::int64_T:
+		sqlite3_result_int64(context, self->table->getInt64(self->row, column));
+		break;
+	case types::typeId::double_T:
+		sqlite3_result_double(context, self->table->getDouble(self->row, column));
+		break;
+	default: {
+		auto text = self->table->getText(self->row, column);
+		sqlite3_result_text64(context, text.empty() ? "" : text.data(), text.size(), SQLITE_TRANSIENT, SQLITE_UTF8);
+		break;
+	}
+	}
+
+	return SQLITE_OK;
+}
+
+int ecs::db3::Sqlite3MemoryTableModule::xRowid(sqlite3_vtab_cursor *cursor, sqlite3_int64 *rowid) {
+	*rowid = static_cast<sqlite3_int64>(static_cast<Cursor*>(cursor)->row);
+	return SQLITE_OK;
+}
@@ -0,0 +1,228 @@
+/*
+ * Prefetch.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <ecs/database/sqlite3/Prefetch.hpp>
+#include <algorithm>
+#include <utility>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+using namespace ecs::db3;
+
+void Sqlite3RowBatch::clear() {
+	values.clear();
+	data.clear();
+	rows = 0;
+}
+
+void Sqlite3RowBatch::append(sqlite3_stmt *stmt, int columns) {
+	for(int i = 0;i < columns;++i) {
+		Value value;
+		value.type  = sqlite3_column_type(stmt, i);
+		value.bytes = 0;
+
+		switch(value.type) {
+			case SQLITE_INTEGER:
+				value.integer = sqlite3_column_int64(stmt, i);
+				break;
+			case SQLITE_FLOAT:
+				value.floating = sqlite3_column_double(stmt, i);
+				break;
+			case SQLITE3_TEXT:
+			case SQLITE_BLOB: {
+				/* The pointer has to be taken before the length */
+				auto bytes = value.type == SQLITE3_TEXT ?
+						static_cast<const void*>(sqlite3_column_text(stmt, i)) : sqlite3_column_blob(stmt, i);
+				value.bytes  = sqlite3_column_bytes(stmt, i);
+				value.offset = data.size();
+				data.append(static_cast<const char*>(bytes), value.bytes);
+				break;
+			}
+			default:
+				value.integer = 0;
+				break;
+		}
+
+		values.push_back(value);
+	}
+	rows++;
+}
+
+Sqlite3RowQueue::Sqlite3RowQueue(std::size_t depth) : slots(depth > 0 ? depth : 1),
+		wakeBatches(std::max<std::size_t>(slots.size() / 2, 1)) {
+
+}
+
+template<typename P>
+void Sqlite3RowQueue::wait(std::atomic<bool> &waiting, P ready) {
+	/* The other side checks the flag after changing the indices.
+	 * Both are sequentially consistent so either the flag is seen
+	 * or the change is seen by ready().
+	 */
+	std::unique_lock<std::mutex> lock(mutex);
+	waiting.store(true);
+	condition.wait(lock, ready);
+	waiting.store(false);
+}
+
+void Sqlite3RowQueue::wake(std::atomic<bool> &waiting) {
+	if(waiting.load()) {
+		{
+			std::scoped_lock lock(mutex);
+		}
+		condition.notify_all();
+	}
+}
+
+bool Sqlite3RowQueue::push(batch_T &batch) {
+	auto position = tail.load(std::memory_order_relaxed);
+	auto full     = [&](){
+		return position - head.load() >= slots.size();
+	};
+
+	if(full()) {
+		wait(producerWaiting, [&](){
+			return !full() || cancelled.load();
+		});
+	}
+	if(cancelled.load()) {
+		return false;
+	}
+
+	std::swap(slots[position % slots.size()], batch);
+	tail.store(position + 1);
+	if(position + 1 - head.load() >= wakeBatches) {
+		wake(consumerWaiting);
+	}
+	return true;
+}
+
+bool Sqlite3RowQueue::pop(batch_T &batch) {
+	auto position = head.load(std::memory_order_relaxed);
+	auto empty    = [&](){
+		return tail.load() == position;
+	};
+
+	if(empty()) {
+		wait(consumerWaiting, [&](){
+			return !empty() || closed.load();
+		});
+
+		/* The last batch is pushed before the queue is closed */
+		if(empty()) {
+			return false;
+		}
+	}
+
+	std::swap(slots[position % slots.size()], batch);
+	head.store(position + 1);
+	if(slots.size() - (tail.load() - position - 1) >= wakeBatches) {
+		wake(producerWaiting);
+	}
+	return true;
+}
+
+void Sqlite3RowQueue::close() {
+	closed.store(true);
+	wake(consumerWaiting);
+}
+
+void Sqlite3RowQueue::cancel() {
+	cancelled.store(true);
+	wake(producerWaiting);
+}
+
+bool Sqlite3RowQueue::isCancelled() const {
+	return cancelled.load();
+}
+
+Sqlite3Prefetcher::Sqlite3Prefetcher(step_T step, std::size_t depth, std::size_t batchRows) :
+		step(std::move(step)), batchRows(batchRows > 0 ? batchRows : 1), queue(depth) {
+	worker = std::thread(&Sqlite3Prefetcher::run, this);
+}
+
+Sqlite3Prefetcher::~Sqlite3Prefetcher() {
+	queue.cancel();
+	if(worker.joinable()) {
+		worker.join();
+	}
+}
+
+void Sqlite3Prefetcher::run() {
+	try {
+		Sqlite3RowQueue::batch_T batch;
+		bool                     more = true;
+
+		while(more && !queue.isCancelled()) {
+			batch.clear();
+
+			while(batch.rows < batchRows) {
+				if(step(batch) != 1) {
+					more = false;
+					break;
+				}
+			}
+
+			if(batch.rows > 0 && !queue.push(batch)) {
+				break;
+			}
+		}
+	}catch(...) {
+		/* Rethrown on the fetching thread at the end of the rows */
+		error = std::current_exception();
+	}
+
+	queue.close();
+}
+
+const Sqlite3RowBatch *Sqlite3Prefetcher::next(std::size_t &row) {
+	while(position >= current.rows) {
+		current.clear();
+		position = 0;
+
+		if(!queue.pop(current)) {
+			if(worker.joinable()) {
+				worker.join();
+			}
+			if(error) {
+				std::rethrow_exception(std::exchange(error, nullptr));
+			}
+			return nullptr;
+		}
+	}
+
+	row = position++;
+	return &current;
+}
+
+bool Sqlite3Prefetcher::hasSpareCpu() {
+#if defined(__linux__)
+	cpu_set_t cpus;
+	if(sched_getaffinity(0, sizeof(cpus), &cpus) == 0) {
+		return CPU_COUNT(&cpus) > 1;
+	}
+#endif
+	return std::thread::hardware_concurrency() != 1;
+}
@@ -0,0 +1,183 @@
+/*
+ * QueryLog.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <ecs/database/sqlite3/QueryLog.hpp>
+#include <map>
+#include <vector>
+
+using namespace ecs::db3;
+
+namespace {
+
+thread_local int untraced = 0;
+
+}
+
+Sqlite3QueryLog::Untraced::Untraced() {
+	untraced++;
+}
+
+Sqlite3QueryLog::Untraced::~Untraced() {
+	untraced--;
+}
+
+Sqlite3QueryLog::Sqlite3QueryLog(sqlite3 *connection, std::chrono::nanoseconds threshold, slowQuerySink_T sink,
+		bool captureWorkload) :
+		connection(connection), threshold(threshold), sink(std::move(sink)),
+		pending(0), dropped(0), captureWorkload(captureWorkload) {
+	if(this->sink) {
+		executor = std::make_unique<SerialExecutor>();
+	}
+	sqlite3_trace_v2(connection, SQLITE_TRACE_PROFILE, &Sqlite3QueryLog::trace, this);
+}
+
+Sqlite3QueryLog::~Sqlite3QueryLog() {
+	/* No more callbacks after this returns because the trace is
+	 * called while the connection is locked.
+	 */
+	sqlite3_trace_v2(connection, 0, nullptr, nullptr);
+	executor.reset();
+}
+
+std::uint64_t Sqlite3QueryLog::getDropped() const {
+	return dropped.load();
+}
+
+bool Sqlite3QueryLog::isCapturingWorkload() const {
+	return captureWorkload;
+}
+
+std::vector<Sqlite3WorkloadEntry> Sqlite3QueryLog::getWorkload() const {
+	std::vector<Sqlite3WorkloadEntry> result;
+
+	std::scoped_lock lock(workloadMutex);
+	result.reserve(workload.size());
+	for(auto &entry : workload) {
+		result.push_back(entry.second);
+	}
+	return result;
+}
+
+std::string Sqlite3QueryLog::explain(sqlite3 *connection, const std::string &query) {
+	sqlite3_stmt *stmt = nullptr;
+	std::string   explainQuery = "EXPLAIN QUERY PLAN " + query;
+
+	if(sqlite3_prepare_v2(connection, explainQuery.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+		sqlite3_finalize(stmt);
+		return std::string();
+	}
+
+	/* Columns are id, parent, notused and detail */
+	std::map<int, std::size_t> depths;
+	std::string                result;
+	while(sqlite3_step(stmt) == SQLITE_ROW) {
+		auto id     = sqlite3_column_int(stmt, 0);
+		auto parent = sqlite3_column_int(stmt, 1);
+		auto detail = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
+
+		auto it    = depths.find(parent);
+		auto depth = it != depths.end() ? it->second + 1 : 0;
+		depths[id] = depth;
+
+		result.append(2 * depth, ' ');
+		result += detail != nullptr ? detail : "";
+		result += '\n';
+	}
+
+	sqlite3_finalize(stmt);
+	return result;
+}
+
+int Sqlite3QueryLog::trace(unsigned type, void *data, void *statement, void *value) {
+	if(type == SQLITE_TRACE_PROFILE) {
+		static_cast<Sqlite3QueryLog*>(data)->profile(static_cast<sqlite3_stmt*>(statement),
+				*static_cast<sqlite3_int64*>(value));
+	}
+	return 0;
+}
+
+void Sqlite3QueryLog::profile(sqlite3_stmt *statement, sqlite3_int64 nanoseconds) {
+	/* The counters are reset after every execution so they
+	 * only cover the execution which is reported.
+	 */
+	auto slowQuery = std::make_shared<SlowQuery>();
+	slowQuery->fullscanSteps = sqlite3_stmt_status(statement, SQLITE_STMTSTATUS_FULLSCAN_STEP, 1);
+	slowQuery->sorts         = sqlite3_stmt_status(statement, SQLITE_STMTSTATUS_SORT, 1);
+	slowQuery->autoindexes   = sqlite3_stmt_status(statement, SQLITE_STMTSTATUS_AUTOINDEX, 1);
+	slowQuery->vmSteps       = sqlite3_stmt_status(statement, SQLITE_STMTSTATUS_VM_STEP, 1);
+
+	/* Plans of the explained statements are not interesting */
+	if(untraced > 0 || sqlite3_stmt_isexplain(statement) != 0) {
+		return;
+	}
+
+	if(captureWorkload && (slowQuery->fullscanSteps > 0 || slowQuery->autoindexes > 0)) {
+		std::string query = sqlite3_sql(statement);
+
+		std::scoped_lock lock(workloadMutex);
+		auto it = workload.find(query);
+		if(it == workload.end() && workload.size() < maxWorkload) {
+			it = workload.emplace(query, Sqlite3WorkloadEntry()).first;
+			it->second.query = query;
+		}
+
+		if(it != workload.end()) {
+			it->second.executions++;
+			it->second.fullscanSteps += slowQuery->fullscanSteps;
+			it->second.autoindexes   += slowQuery->autoindexes;
+			it->second.vmSteps       += slowQuery->vmSteps;
+		}
+	}
+
+	if(!sink || std::chrono::nanoseconds(nanoseconds) < threshold) {
+		return;
+	}
+
+	if(pending.load() >= maxPending) {
+		dropped++;
+		return;
+	}
+
+	slowQuery->duration = std::chrono::nanoseconds(nanoseconds);
+	slowQuery->time     = std::chrono::system_clock::now();
+
+	if(auto expanded = sqlite3_expanded_sql(statement)) {
+		slowQuery->sql = expanded;
+		sqlite3_free(expanded);
+	}else{
+		slowQuery->sql = sqlite3_sql(statement);
+	}
+
+	/* Explained while sqlite holds the connection mutex for the
+	 * trace. On the thread of the sink the plan would run along
+	 * with the statements of the application and overwrite the
+	 * error message of the connection.
+	 */
+	slowQuery->plan = explain(connection, sqlite3_sql(statement));
+
+	pending++;
+	executor->post([this, slowQuery](){
+		pending--;
+		sink(*slowQuery);
+	});
+}
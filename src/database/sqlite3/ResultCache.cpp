@@ -0,0 +1,205 @@
+/*
+ * ResultCache.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * Copyright (C) 2017 Geoffrey Mellar <mellar@gamma-kappa.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <ecs/database/sqlite3/ResultCache.hpp>
+#include <iterator>
+
+using namespace ecs::db3;
+
+namespace {
+
+std::size_t cellBytes(const types::cell_T &cell) {
+	std::size_t result = sizeof(types::cell_T);
+
+	if(cell.has_value()) {
+		/* Value holder allocated on the heap */
+		result += 2 * sizeof(void*) + sizeof(std::int64_t);
+		if(cell.getTypeId() == types::typeId::string) {
+			result += cell.cast_reference<types::String::type>().capacity();
+		}
+	}
+
+	return result;
+}
+
+}
+
+bool Sqlite3CachedResult::append(RowBase &row) {
+	for(decltype(row.size()) i = 0;i < row.size();++i) {
+		auto &cell = row[i];
+
+		if(cell.getTypeId() == types::typeId::blob || cell.getTypeId() == types::typeId::blobInput) {
+			return false;
+		}
+
+		cells.push_back(cell);
+		bytes += cellBytes(cells.back());
+	}
+
+	rows++;
+	return true;
+}
+
+Row::uniquePtr_T Sqlite3CachedResult::copyRow(std::size_t n) const {
+	auto row     = std::make_unique<Row>();
+	auto columns = columnNames.size();
+
+	for(std::size_t i = n * columns;i < (n + 1) * columns;++i) {
+		*row << std::make_unique<types::cell_T>(cells[i]);
+	}
+
+	return row;
+}
+
+Sqlite3ResultCache::Sqlite3ResultCache(std::size_t capacity) :
+		capacity(capacity), version(0), bytes(0),
+		hits(0), misses(0), invalidations(0), evictions(0) {
+
+}
+
+std::shared_ptr<const Sqlite3CachedResult> Sqlite3ResultCache::lookup(const std::string &key) {
+	std::scoped_lock lock(mutex);
+
+	auto entry = entries.find(key);
+	if(entry == entries.end()) {
+		misses++;
+		return nullptr;
+	}
+
+	hits++;
+	lru.splice(lru.begin(), lru, entry->second.position);
+	return entry->second.result;
+}
+
+std::uint64_t Sqlite3ResultCache::getVersion() const {
+	std::scoped_lock lock(mutex);
+	return version;
+}
+
+void Sqlite3ResultCache::insert(const std::string &key, std::shared_ptr<const Sqlite3CachedResult> result,
+		std::uint64_t version) {
+	auto resultBytes = result->bytes + key.size();
+
+	std::scoped_lock lock(mutex);
+
+	/* A table changed while the result was read */
+	if(version != this->version || resultBytes > capacity) {
+		return;
+	}
+
+	if(entries.count(key) > 0) {
+		remove(key);
+	}
+
+	while(bytes + resultBytes > capacity && !lru.empty()) {
+		remove(lru.back());
+		evictions++;
+	}
+
+	lru.push_front(key);
+	for(auto &table : result->tables) {
+		tableKeys[table].insert(key);
+	}
+
+	entries.emplace(key, Entry{std::move(result), lru.begin()});
+	bytes += resultBytes;
+}
+
+void Sqlite3ResultCache::invalidate(const std::string &table) {
+	std::scoped_lock lock(mutex);
+	version++;
+
+	auto keys = tableKeys.find(table);
+	if(keys == tableKeys.end()) {
+		return;
+	}
+
+	/* Removing the results modifies the key set */
+	std::vector<std::string> removed(keys->second.begin(), keys->second.end());
+	for(auto &key : removed) {
+		remove(key);
+		invalidations++;
+	}
+}
+
+void Sqlite3ResultCache::clear() {
+	std::scoped_lock lock(mutex);
+
+	version++;
+	invalidations += entries.size();
+	entries.clear();
+	tableKeys.clear();
+	lru.clear();
+	bytes = 0;
+}
+
+void Sqlite3ResultCache::remove(const std::string &key) {
+	auto entry = entries.find(key);
+	if(entry == entries.end()) {
+		return;
+	}
+
+	/* The key may reference the lru list which is erased last */
+	auto result = std::move(entry->second.result);
+	auto position = entry->second.position;
+	bytes -= result->bytes + entry->first.size();
+
+	for(auto &table : result->tables) {
+		auto keys = tableKeys.find(table);
+		if(keys != tableKeys.end()) {
+			keys->second.erase(entry->first);
+			if(keys->second.empty()) {
+				tableKeys.erase(keys);
+			}
+		}
+	}
+
+	entries.erase(entry);
+	lru.erase(position);
+}
+
+void Sqlite3ResultCache::addVolatileTable(const std::string &name) {
+	std::scoped_lock lock(mutex);
+	volatileTables.insert(name);
+}
+
+bool Sqlite3ResultCache::isVolatileTable(const std::string &name) const {
+	std::scoped_lock lock(mutex);
+	return volatileTables.count(name) > 0;
+}
+
+std::size_t Sqlite3ResultCache::getCapacity() const {
+	return capacity;
+}
+
+void Sqlite3ResultCache::getStatistics(ResultCacheStatistics &statistics) const {
+	std::scoped_lock lock(mutex);
+
+	statistics.capacity      = capacity;
+	statistics.bytes         = bytes;
+	statistics.entries       = entries.size();
+	statistics.hits          = hits;
+	statistics.misses        = misses;
+	statistics.invalidations = invalidations;
+	statistics.evictions     = evictions;
+}
@@ -22,7 +22,8 @@
 
 /* Add your header comment here */
 #include <ecs/config.hpp>
-#include <ecs/Timestamp.hpp>
+#include <ecs/Time.hpp>
+#include <chrono>
 #include <ecs/database/sqlite3/sqlite3ext.h>
 
 #ifdef SQLITE_CORE
@@ -36,28 +37,26 @@
 SQLITE_EXTENSION_INIT1
 
 /* Insert your extension code here */
-static void UTCTIME(sqlite3_context *context, int argc, sqlite3_value **argv)
+template<ecs::time::Precision precision, bool localtime>
+static void formatNow(sqlite3_context *context, int argc, sqlite3_value **argv)
 {
 	if (argc == 0) {
-		sqlite3_result_text(context, ecs::time::ISO8601::now().c_str(), -1, SQLITE_TRANSIENT);
-		return;
-	}else if(argc == 1) {
-		sqlite3_result_null(context);
+		char timeString[ecs::time::ISO8601BufferSize];
+		auto length = ecs::time::formatISO8601(std::chrono::system_clock::now(), timeString, precision, localtime);
+		sqlite3_result_text(context, timeString, static_cast<int>(length), SQLITE_TRANSIENT);
 		return;
 	}
 	sqlite3_result_null(context);
 }
 
+static void UTCTIME(sqlite3_context *context, int argc, sqlite3_value **argv)
+{
+	formatNow<ecs::time::Precision::seconds, false>(context, argc, argv);
+}
+
 static void UTCLOCALTIME(sqlite3_context *context, int argc, sqlite3_value **argv)
 {
-	if (argc == 0) {
-		sqlite3_result_text(context, ecs::time::ISO8601::now(std::chrono::seconds(0),true).c_str(), -1, SQLITE_TRANSIENT);
-		return;
-	}else if(argc == 1) {
-		sqlite3_result_null(context);
-		return;
-	}
-	sqlite3_result_null(context);
+	formatNow<ecs::time::Precision::seconds, true>(context, argc, argv);
 }
 /* End extension code */
 
@@ -69,16 +68,26 @@ extern "C" ECS_EXPORT int EXTENSION_ENTRY_POINT(
 	int rc = SQLITE_OK;
 	SQLITE_EXTENSION_INIT2(pApi);
 
-	sqlite3_create_function_v2(db, "UTCTIME", -1, SQLITE_UTF8, 
+	const int flags = SQLITE_UTF8 | SQLITE_INNOCUOUS;
+
+	sqlite3_create_function_v2(db, "UTCTIME", -1, flags, 
 		NULL,&UTCTIME,NULL,NULL,NULL);
 	sqlite3_create_function_v2(db, 
-		"UTCLOCALTIME", -1, SQLITE_UTF8, 
+		"UTCLOCALTIME", -1, flags, 
 		NULL,&UTCLOCALTIME,NULL,NULL,NULL);	
-	sqlite3_create_function_v2(db, "utc_timestamp", -1, SQLITE_UTF8, 
+	sqlite3_create_function_v2(db, "utc_timestamp", -1, flags, 
 		NULL,&UTCTIME,NULL,NULL,NULL);
 	sqlite3_create_function_v2(db, 
-		"utc_timestamp_local", -1, SQLITE_UTF8, 
+		"utc_timestamp_local", -1, flags, 
 		NULL,&UTCLOCALTIME,NULL,NULL,NULL);
+	sqlite3_create_function_v2(db, "utc_timestamp_ms", -1, flags, 
+		NULL,&formatNow<ecs::time::Precision::milliseconds, false>,NULL,NULL,NULL);
+	sqlite3_create_function_v2(db, "utc_timestamp_us", -1, flags, 
+		NULL,&formatNow<ecs::time::Precision::microseconds, false>,NULL,NULL,NULL);
+	sqlite3_create_function_v2(db, "utc_timestamp_local_ms", -1, flags, 
+		NULL,&formatNow<ecs::time::Precision::milliseconds, true>,NULL,NULL,NULL);
+	sqlite3_create_function_v2(db, "utc_timestamp_local_us", -1, flags, 
+		NULL,&formatNow<ecs::time::Precision::microseconds, true>,NULL,NULL,NULL);
   return rc;
 }
  
@@ -22,11 +22,9 @@
 
 /* Add your header comment here */
 #include <ecs/config.hpp>
-#include <boost/uuid/uuid.hpp>            
-#include <boost/uuid/uuid_generators.hpp> 
-#include <boost/uuid/uuid_io.hpp>
+#include <ecs/UUID.hpp>
 #include <ecs/database/sqlite3/sqlite3ext.h>
-#include <mutex>
+#include <cstring>
 
 #ifdef SQLITE_CORE
 /* Extension name */
@@ -43,37 +41,118 @@ SQLITE_EXTENSION_INIT1
  */
 
 /* Insert your extension code here */
+namespace {
+
+constexpr int uuidBytes      = 16;
+constexpr int uuidTextLength = ecs::tools::UUID::StringSize;
+
+/** The generators keep their state per thread so inserting
+ * rows from several threads never waits for a lock.
+ */
+const ecs::tools::UUIDGenerator  randomGenerator;
+const ecs::tools::UUIDGenerator7 timeOrderedGenerator;
+
+/** Get the binary form of a blob or text argument */
+bool argumentUUID(sqlite3_value *value, ecs::tools::UUID &uuid) {
+	switch(sqlite3_value_type(value)) {
+	case SQLITE_BLOB:
+		if(sqlite3_value_bytes(value) != uuidBytes) {
+			return false;
+		}
+		std::memcpy(uuid.data(), sqlite3_value_blob(value), uuidBytes);
+		return true;
+	case SQLITE_TEXT: {
+		auto text = reinterpret_cast<const char*>(sqlite3_value_text(value));
+		return ecs::tools::UUID::parse(std::string_view(text, sqlite3_value_bytes(value)), uuid);
+	}
+	default:
+		return false;
+	}
+}
+
+}
+
 static void UUID4(sqlite3_context *context, int argc, sqlite3_value **argv)
 {
-	static boost::uuids::random_generator generator;
-	static std::mutex                     generatorMutex;
-	
-	std::lock_guard<std::mutex> lock(generatorMutex);
-	boost::uuids::uuid generatedUUID = generator();
-	std::string UUIDString = boost::uuids::to_string(generatedUUID);
-	
 	if (argc == 0) {
-		sqlite3_result_text(context, UUIDString.c_str(), -1, SQLITE_TRANSIENT);
+		ecs::tools::UUID generatedUUID(randomGenerator);
+		char             text[uuidTextLength];
+
+		generatedUUID.format(text);
+		sqlite3_result_text(context, text, uuidTextLength, SQLITE_TRANSIENT);
 		return;
 	}
 	sqlite3_result_null(context);
 }
 
+/** Time ordered UUID version 7 in the text form */
+static void UUID7(sqlite3_context *context, int argc, sqlite3_value **argv)
+{
+	ecs::tools::UUID generatedUUID(timeOrderedGenerator);
+	char             text[uuidTextLength];
+
+	generatedUUID.format(text);
+	sqlite3_result_text(context, text, uuidTextLength, SQLITE_TRANSIENT);
+}
+
 static void UUID_NIL(sqlite3_context *context, int argc, sqlite3_value **argv)
 {
-	static boost::uuids::nil_generator generator;
-	static std::mutex                  generatorMutex;
-	
-	std::lock_guard<std::mutex> lock(generatorMutex);
-	boost::uuids::uuid generatedUUID = generator();
-	std::string UUIDString = boost::uuids::to_string(generatedUUID);
-	
 	if (argc == 0) {
-		sqlite3_result_text(context, UUIDString.c_str(), -1, SQLITE_TRANSIENT);
+		sqlite3_result_text(context, "00000000-0000-0000-0000-000000000000", uuidTextLength, SQLITE_STATIC);
 		return;
 	}
 	sqlite3_result_null(context);
 }
+
+/** Random UUID in the 16 byte binary form which is less
+ * than half the size of the text form inside an index.
+ */
+static void UUID_BLOB(sqlite3_context *context, int argc, sqlite3_value **argv)
+{
+	ecs::tools::UUID generatedUUID(randomGenerator);
+	sqlite3_result_blob(context, generatedUUID.data(), uuidBytes, SQLITE_TRANSIENT);
+}
+
+/** Time ordered UUID version 7 in the binary form. New rows
+ * are appended to the end of the primary key index.
+ */
+static void UUID_BLOB_V7(sqlite3_context *context, int argc, sqlite3_value **argv)
+{
+	ecs::tools::UUID generatedUUID(timeOrderedGenerator);
+	sqlite3_result_blob(context, generatedUUID.data(), uuidBytes, SQLITE_TRANSIENT);
+}
+
+/** Converts a binary or text UUID into the canonical text form.
+ * Invalid input results in NULL.
+ */
+static void UUID_STR(sqlite3_context *context, int argc, sqlite3_value **argv)
+{
+	ecs::tools::UUID uuid;
+	char             text[uuidTextLength];
+
+	if (!argumentUUID(argv[0], uuid)) {
+		sqlite3_result_null(context);
+		return;
+	}
+
+	uuid.format(text);
+	sqlite3_result_text(context, text, uuidTextLength, SQLITE_TRANSIENT);
+}
+
+/** Converts a text or binary UUID into the 16 byte binary
+ * form. Invalid input results in NULL.
+ */
+static void UUID_BIN(sqlite3_context *context, int argc, sqlite3_value **argv)
+{
+	ecs::tools::UUID uuid;
+
+	if (!argumentUUID(argv[0], uuid)) {
+		sqlite3_result_null(context);
+		return;
+	}
+
+	sqlite3_result_blob(context, uuid.data(), uuidBytes, SQLITE_TRANSIENT);
+}
 /* End extension code */
 
 extern "C" ECS_EXPORT int EXTENSION_ENTRY_POINT(
@@ -84,12 +163,28 @@ extern "C" ECS_EXPORT int EXTENSION_ENTRY_POINT(
 	int rc = SQLITE_OK;
 	SQLITE_EXTENSION_INIT2(pApi);
 
+	/* None of the functions has side effects so they may be used
+	 * in views, triggers and schema definitions.
+	 */
+	const int random        = SQLITE_UTF8 | SQLITE_INNOCUOUS;
+	const int deterministic = SQLITE_UTF8 | SQLITE_INNOCUOUS | SQLITE_DETERMINISTIC;
+
 	sqlite3_create_function_v2(db, "UUID4", -1, 
-		SQLITE_UTF8, NULL, &UUID4, NULL, NULL, NULL);
+		random, NULL, &UUID4, NULL, NULL, NULL);
 	sqlite3_create_function_v2(db, "uuid_generate_v4", -1, 
-		SQLITE_UTF8, NULL, &UUID4, NULL, NULL, NULL);
+		random, NULL, &UUID4, NULL, NULL, NULL);
+	sqlite3_create_function_v2(db, "uuid_generate_v7", 0, 
+		random, NULL, &UUID7, NULL, NULL, NULL);
 	sqlite3_create_function_v2(db, "uuid_nil", -1, 
-		SQLITE_UTF8, NULL, &UUID_NIL, NULL, NULL, NULL);	
+		deterministic, NULL, &UUID_NIL, NULL, NULL, NULL);	
+	sqlite3_create_function_v2(db, "uuid_blob", 0, 
+		random, NULL, &UUID_BLOB, NULL, NULL, NULL);
+	sqlite3_create_function_v2(db, "uuid_blob_v7", 0, 
+		random, NULL, &UUID_BLOB_V7, NULL, NULL, NULL);
+	sqlite3_create_function_v2(db, "uuid_str", 1, 
+		deterministic, NULL, &UUID_STR, NULL, NULL, NULL);
+	sqlite3_create_function_v2(db, "uuid_bin", 1, 
+		deterministic, NULL, &UUID_BIN, NULL, NULL, NULL);
   return rc;
 }
 
@@ -21,6 +21,7 @@
  */
 
 #include <ecs/database/sqlite3/sqlite3.hpp>
+#include <ecs/Profiler.hpp>
 #include "MigratorImplSqlite3.cpp"
 #include <boost/iostreams/stream_buffer.hpp>
 
@@ -58,23 +59,43 @@ BlobBuffer::int_type Sqlite3Blob::underflow(){
 }
 
 
-Sqlite3Statement::Sqlite3Statement(sqlite3 *connection, const std::string &query) : sqlite3Con(connection),
-		sqlite3Stmt(nullptr, &sqliteStatementDeleter), status(0) {
+Sqlite3Statement::Sqlite3Statement(sqlite3 *connection, const std::string &query,
+		std::shared_ptr<Sqlite3Hooks> hooks, std::size_t prefetchDepth, bool nativeTimestamps) :
+		status(0), sqlite3Con(connection),
+		sqlite3Stmt(nullptr, &sqliteStatementDeleter), fetchState(FetchState::done), planOwnBlobs(false),
+		hooks(std::move(hooks)), classified(false), cacheable(false), collectorVersion(0), cachedRow(0),
+		prefetchDepth(prefetchDepth), nativeTimestamps(nativeTimestamps) {
 	sqlite3_stmt *stmt = nullptr;
-	auto res = sqlite3_prepare_v2(sqlite3Con, query.c_str(), -1, &stmt, &pzTail);
+	int           res;
+
+	if(this->hooks && this->hooks->isActive()) {
+		cache      = this->hooks->getResultCache();
+		res        = this->hooks->prepare(query, &stmt, &pzTail, access);
+		classified = true;
+	}else{
+		res = sqlite3_prepare_v2(sqlite3Con, query.c_str(), -1, &stmt, &pzTail);
+	}
+
 	if(res == SQLITE_OK){
 		sqlite3Stmt.reset(stmt);
 	}else{
 		throw std::runtime_error("Statement creation failed: " + std::to_string(res));
 	}
 
-	doFetchRow = [](Sqlite3Statement *stmt){
-		return std::unique_ptr<Row>();
-	};
+	/* Transaction control statements are read only as well so only
+	 * statements returning columns are cached.
+	 */
+	if(cache && stmt != nullptr && access.deterministic &&
+			sqlite3_stmt_readonly(stmt) && sqlite3_column_count(stmt) > 0) {
+		cacheable = true;
+		bindingKeys.resize(sqlite3_bind_parameter_count(stmt),
+				std::string(1, static_cast<char>(types::typeId::null)));
+	}
 }
 
 Sqlite3Statement::~Sqlite3Statement(){
-
+	/* The thread must not step a finalized statement */
+	prefetcher.reset();
 }
 
 int Sqlite3Statement::getStatus() const {
@@ -82,102 +103,401 @@ int Sqlite3Statement::getStatus() const {
 }
 
 Row::uniquePtr_T Sqlite3Statement::fetch() {
+	ECS_PROFILE_ZONE("Sqlite3Statement::fetch");
+
 	using namespace ecs::tools;
 	using namespace types;
 
-	return doFetchRow(this);
+	auto result = nextRow();
+
+	if(collector) {
+		if(!result) {
+			/* Only complete results are cached */
+			if(status == SQLITE_DONE) {
+				cache->insert(resultKey, std::move(collector), collectorVersion);
+			}
+			collector.reset();
+		}else if(!collector->append(*result) || collector->bytes > cache->getCapacity()) {
+			collector.reset();
+		}
+	}
+
+	return result;
 }
 
-int Sqlite3Statement::step(Row::uniquePtr_T &row) {
-	using namespace ecs::tools;
+bool Sqlite3Statement::bindingKey(const ecs::db3::types::cell_T &parameter, std::string &key) {
 	using namespace types;
 
-	bool        rc          = false;
+	key.assign(1, static_cast<char>(parameter.getTypeId()));
+
+	switch(parameter.getTypeId()){
+		case types::typeId::int64_T:
+			key.append(reinterpret_cast<const char*>(parameter.cast<Int64::type>()), sizeof(Int64::type));
+			break;
+		case types::typeId::uint64_T:
+			key.append(reinterpret_cast<const char*>(parameter.cast<Uint64::type>()), sizeof(Uint64::type));
+			break;
+		case types::typeId::string:
+			key.append(parameter.cast_reference<String::type>());
+			break;
+		case types::typeId::double_T:
+			key.append(reinterpret_cast<const char*>(parameter.cast<Double::type>()), sizeof(Double::type));
+			break;
+		case types::typeId::float_T:
+			key.append(reinterpret_cast<const char*>(parameter.cast<Float::type>()), sizeof(Float::type));
+			break;
+		case types::typeId::boolean_T:
+			key.push_back(parameter.cast_reference<Boolean::type>() ? 1 : 0);
+			break;
+		case types::typeId::timestamp:
+			{
+				auto microseconds = parameter.cast_reference<types::Timestamp::type>().getMicroseconds();
+				key.append(reinterpret_cast<const char*>(&microseconds), sizeof(microseconds));
+			}
+			break;
+		case types::typeId::uuid:
+			key.append(reinterpret_cast<const char*>(parameter.cast_reference<Uuid::type>().data()), 16);
+			break;
+		case types::typeId::null:
+			break;
+		default:
+			/* Streams can only be read once */
+			key.clear();
+			return false;
+	}
+
+	return true;
+}
+
+bool Sqlite3Statement::makeResultKey(std::string &key) const {
+	key = sqlite3_sql(sqlite3Stmt.get());
+
+	for(auto &binding : bindingKeys) {
+		if(binding.empty()) {
+			return false;
+		}
+
+		/* Length prefix keeps the parameters apart */
+		auto size = static_cast<std::uint32_t>(binding.size());
+		key.append(reinterpret_cast<const char*>(&size), sizeof(size));
+		key.append(binding);
+	}
+
+	return true;
+}
+
+bool Sqlite3Statement::isDeclaredAs(const char *declaredType, const char *type) {
+	if(declaredType == nullptr) {
+		return false;
+	}
+
+	/* Declared types are case insensitive and may have a size like TIMESTAMP(6) */
+	auto length = std::strlen(type);
+	return sqlite3_strnicmp(declaredType, type, length) == 0 &&
+			(declaredType[length] == '\0' || declaredType[length] == '(' || declaredType[length] == ' ');
+}
+
+int Sqlite3Statement::step(Row::uniquePtr_T &row) {
+	StepState state;
+	auto      rc = step(row, state);
+
+	status       = state.status;
+	busyRetries += state.busyRetries;
+	if(rc < 0) {
+		setErrorString(state.error);
+	}
+
+	return rc;
+}
+
+int Sqlite3Statement::step(Row::uniquePtr_T &row, StepState &state) {
+	auto rc = advance(state);
+	if(rc != 1) {
+		return rc;
+	}
+
+	if(plan.empty()) {
+		buildPlan();
+	}
+
+	row = std::make_unique<Row>();
+	row->data.reserve(plan.size());
+
+	StatementColumns columns{sqlite3Stmt.get()};
+	for(std::size_t i = 0;i < plan.size();++i){
+		if(!plan[i](columns, static_cast<int>(i), *row)) {
+			row.reset();
+			state.error = "Unsupported row result";
+			return -1;
+		}
+	}
+
+	return 1;
+}
+
+int Sqlite3Statement::step(Sqlite3RowBatch &batch, StepState &state) {
+	auto rc = advance(state);
+	if(rc == 1) {
+		batch.append(sqlite3Stmt.get(), static_cast<int>(plan.size()));
+	}
+	return rc;
+}
+
+int Sqlite3Statement::advance(StepState &state) {
+	ECS_PROFILE_ZONE("Sqlite3Statement::step");
+
 	std::size_t busycounter = 1000;
+	auto        mutex       = sqlite3_db_mutex(sqlite3Con);
 
 	while(1) {
-		status = sqlite3_step(sqlite3Stmt.get());
+		/* Other threads may use the connection at the same time so
+		 * the message is taken before the mutex is released.
+		 */
+		sqlite3_mutex_enter(mutex);
+		state.status = sqlite3_step(sqlite3Stmt.get());
+		if(state.status != SQLITE_ROW && state.status != SQLITE_DONE && state.status != SQLITE_OK) {
+			state.error = sqlite3_errmsg(sqlite3Con);
+		}
+		sqlite3_mutex_leave(mutex);
 
-		if(status == SQLITE_SCHEMA){
-			setErrorString(sqlite3_errmsg(sqlite3Con));
+		if(state.status == SQLITE_SCHEMA){
 			return -1;
-		}else if(status == SQLITE_ABORT){
-			setErrorString(sqlite3_errmsg(sqlite3Con));
+		}else if(state.status == SQLITE_ABORT){
 			return -1;
-		}else if(status == SQLITE_OK || status == SQLITE_DONE){
+		}else if(state.status == SQLITE_OK || state.status == SQLITE_DONE){
 			return 0;
-		}else if (status == SQLITE_MISUSE) {
-			setErrorString(sqlite3_errmsg(sqlite3Con));
+		}else if (state.status == SQLITE_MISUSE) {
 			return -1;
-		}else if(status == SQLITE_CONSTRAINT){
-			setErrorString(sqlite3_errmsg(sqlite3Con));
+		}else if(state.status == SQLITE_CONSTRAINT){
 			return -1;
-		}else if (status == SQLITE_BUSY) {
+		}else if (state.status == SQLITE_BUSY) {
 			busycounter--;
 			if(busycounter){
+				state.busyRetries++;
+				state.error.clear();
 				std::this_thread::sleep_for(std::chrono::milliseconds(1));
 				continue;
 			}
-			setErrorString(sqlite3_errmsg(sqlite3Con));
 			return -1;
-		}else if (status == SQLITE_ERROR) {
-			status = -1;
-			setErrorString(sqlite3_errmsg(sqlite3Con));
+		}else if (state.status == SQLITE_ERROR) {
+			state.status = -1;
 			return -1;
-		}else if (status == SQLITE_ROW) {
-			row = std::make_unique<Row>();
-			std::shared_ptr<boost::iostreams::stream_buffer<BlobSource>> blobBuffer;
-
-			/* Get the number of columns */
-			int columns = sqlite3_column_count(sqlite3Stmt.get());
-
-			/* Iterate as los as there are columns */
-			for(int i = 0;i < columns;++i){
-
-				/* Get the column type */
-				switch (sqlite3_column_type(sqlite3Stmt.get(), i)) {
-					case SQLITE3_TEXT:
-						*row << any::make<String>(reinterpret_cast<const char*>(sqlite3_column_text(sqlite3Stmt.get(),i)), 
-							sqlite3_column_bytes(sqlite3Stmt.get(),i)
-						);
-						break;
-					case SQLITE_INTEGER:
-						*row << any::make<Int64>(static_cast<int64_t>(sqlite3_column_int64(sqlite3Stmt.get(),i)));
-						break;
-					case SQLITE_FLOAT:
-						*row << any::make<Double>(sqlite3_column_double(sqlite3Stmt.get(),i));
-						break;
-					case SQLITE_NULL:
-						*row << std::make_unique<cell_T>(nullptr, Null());
-						break;
-					case SQLITE_BLOB:
-						blobBuffer = std::make_shared<boost::iostreams::stream_buffer<BlobSource>>(
-								static_cast<char*>(const_cast<void*>(sqlite3_column_blob(sqlite3Stmt.get(), i))),
-								sqlite3_column_bytes(sqlite3Stmt.get(), i)
-						);
-
-						*row << any::make<Blob>(blobBuffer);
-						break;
-					default:
-						row.reset();
-						setErrorString("Unsupported row result");
-						return -1;
-						break;
-				}
-			}
-
+		}else if (state.status == SQLITE_ROW) {
 			return 1;
 		}else{
 			/* No return status matches so we exit the loop.
 			 * This means there was an unknown error we cannot
 			 * handle at this time.
 			 */
-			setErrorString("No matching return status " + std::to_string(status));
+			state.error = "No matching return status " + std::to_string(state.status);
 			return -1;
 		}
 	}
 }
 
+Sqlite3Statement::ColumnKind Sqlite3Statement::getColumnKind(const char *declaredType) {
+	if(declaredType == nullptr) {
+		return ColumnKind::any;
+	}
+
+	if(isDeclaredAs(declaredType, "TIMESTAMP") || isDeclaredAs(declaredType, "DATETIME")) {
+		return ColumnKind::timestamp;
+	}else if(isDeclaredAs(declaredType, "UUID")) {
+		return ColumnKind::uuid;
+	}
+
+	auto contains = [declaredType](const char *pattern){
+		return sqlite3_strlike(pattern, declaredType, 0) == 0;
+	};
+
+	if(contains("%INT%")) {
+		return ColumnKind::integer;
+	}else if(contains("%CHAR%") || contains("%CLOB%") || contains("%TEXT%")) {
+		return ColumnKind::text;
+	}else if(contains("%BLOB%")) {
+		return ColumnKind::blob;
+	}else if(contains("%REAL%") || contains("%FLOA%") || contains("%DOUB%")) {
+		return ColumnKind::floating;
+	}
+
+	return ColumnKind::any;
+}
+
+template<Sqlite3Statement::ColumnKind kind, bool ownBlobs, typename Columns>
+bool Sqlite3Statement::decodeColumn(const Columns &columns, int column, Row &row) {
+	using namespace ecs::tools;
+	using namespace types;
+
+	auto type = columns.type(column);
+
+	/* Columns mostly hold values of their declared type */
+	if constexpr (kind == ColumnKind::integer) {
+		if(type == SQLITE_INTEGER) {
+			row << any::make<Int64>(static_cast<int64_t>(columns.integer(column)));
+			return true;
+		}
+	}else if constexpr (kind == ColumnKind::floating) {
+		if(type == SQLITE_FLOAT) {
+			row << any::make<Double>(columns.floating(column));
+			return true;
+		}
+	}else if constexpr (kind == ColumnKind::text) {
+		if(type == SQLITE3_TEXT) {
+			auto text = columns.text(column);
+			row << any::make<String>(text, columns.bytes(column));
+			return true;
+		}
+	}
+
+	switch (type) {
+		case SQLITE3_TEXT: {
+			auto text = columns.text(column);
+			row << any::make<String>(text, columns.bytes(column));
+			return true;
+		}
+		case SQLITE_INTEGER:
+			/* Timestamps are stored as microseconds since the epoch */
+			if constexpr (kind == ColumnKind::timestamp) {
+				row << any::make<types::Timestamp>(ecs::time::Timestamp::fromMicroseconds(
+						columns.integer(column)));
+			}else{
+				row << any::make<Int64>(static_cast<int64_t>(columns.integer(column)));
+			}
+			return true;
+		case SQLITE_FLOAT:
+			row << any::make<Double>(columns.floating(column));
+			return true;
+		case SQLITE_NULL:
+			row << std::make_unique<cell_T>(nullptr, Null());
+			return true;
+		case SQLITE_BLOB: {
+			auto blob  = const_cast<void*>(columns.blob(column));
+			auto bytes = columns.bytes(column);
+
+			if constexpr (kind == ColumnKind::uuid) {
+				if(bytes == 16) {
+					auto uuid = any::make<Uuid>();
+					std::memcpy(uuid->cast<Uuid::type>()->data(), blob, 16);
+					row << uuid;
+					return true;
+				}
+			}
+
+			/* The prefetched rows outlive the step so they get a copy */
+			if constexpr (ownBlobs) {
+				row << any::make<Blob>(std::make_shared<Sqlite3Blob>(blob, bytes));
+			}else{
+				row << any::make<Blob>(std::make_shared<boost::iostreams::stream_buffer<BlobSource>>(
+						static_cast<char*>(blob), bytes));
+			}
+			return true;
+		}
+		default:
+			return false;
+	}
+}
+
+template<typename Columns>
+Sqlite3Statement::decode_T<Columns> Sqlite3Statement::getDecoder(ColumnKind kind, bool ownBlobs) {
+	switch(kind) {
+		case ColumnKind::integer:
+			return ownBlobs ? &decodeColumn<ColumnKind::integer, true, Columns> : &decodeColumn<ColumnKind::integer, false, Columns>;
+		case ColumnKind::floating:
+			return ownBlobs ? &decodeColumn<ColumnKind::floating, true, Columns> : &decodeColumn<ColumnKind::floating, false, Columns>;
+		case ColumnKind::text:
+			return ownBlobs ? &decodeColumn<ColumnKind::text, true, Columns> : &decodeColumn<ColumnKind::text, false, Columns>;
+		case ColumnKind::blob:
+			return ownBlobs ? &decodeColumn<ColumnKind::blob, true, Columns> : &decodeColumn<ColumnKind::blob, false, Columns>;
+		case ColumnKind::timestamp:
+			return ownBlobs ? &decodeColumn<ColumnKind::timestamp, true, Columns> : &decodeColumn<ColumnKind::timestamp, false, Columns>;
+		case ColumnKind::uuid:
+			return ownBlobs ? &decodeColumn<ColumnKind::uuid, true, Columns> : &decodeColumn<ColumnKind::uuid, false, Columns>;
+		default:
+			return ownBlobs ? &decodeColumn<ColumnKind::any, true, Columns> : &decodeColumn<ColumnKind::any, false, Columns>;
+	}
+}
+
+void Sqlite3Statement::buildPlan() {
+	int columnCount = sqlite3_column_count(sqlite3Stmt.get());
+
+	plan.clear();
+	plan.reserve(columnCount);
+	batchPlan.clear();
+	for(int i = 0;i < columnCount;++i) {
+		auto kind = getColumnKind(sqlite3_column_decltype(sqlite3Stmt.get(), i));
+		if(kind == ColumnKind::timestamp && !nativeTimestamps) {
+			kind = ColumnKind::integer;
+		}
+		plan.push_back(getDecoder<StatementColumns>(kind, planOwnBlobs));
+
+		/* The batches are reused so their blobs are copied */
+		if(planOwnBlobs) {
+			batchPlan.push_back(getDecoder<BatchColumns>(kind, true));
+		}
+	}
+}
+
+Row::uniquePtr_T Sqlite3Statement::nextRow() {
+	Row::uniquePtr_T result;
+
+	switch(fetchState) {
+		case FetchState::first:
+			fetchState = prefetcher ? FetchState::prefetched : FetchState::stepping;
+			return std::move(row);
+		case FetchState::stepping:
+			if(step(result) != 1) {
+				fetchState = FetchState::done;
+			}
+			return result;
+		case FetchState::prefetched: {
+			const Sqlite3RowBatch *batch;
+			std::size_t            index = 0;
+
+			/* A failure of the thread reaches the caller like a
+			 * failure of the fetching thread.
+			 */
+			try {
+				batch = prefetcher->next(index);
+			}catch(const std::exception &e) {
+				failPrefetch(e.what());
+				throw;
+			}catch(...) {
+				failPrefetch("Prefetching the rows failed");
+				throw;
+			}
+
+			if(!batch) {
+				finishPrefetch();
+				fetchState = FetchState::done;
+				return result;
+			}
+
+			result = std::make_unique<Row>();
+			result->data.reserve(batchPlan.size());
+
+			BatchColumns columns{&batch->values[index * batchPlan.size()], batch->data.data()};
+			for(std::size_t i = 0;i < batchPlan.size();++i) {
+				if(!batchPlan[i](columns, static_cast<int>(i), *result)) {
+					failPrefetch("Unsupported row result");
+					return Row::uniquePtr_T();
+				}
+			}
+			return result;
+		}
+		case FetchState::cached:
+			if(cachedRow < cachedResult->rows) {
+				return cachedResult->copyRow(cachedRow++);
+			}
+			cachedResult.reset();
+			fetchState = FetchState::done;
+			return result;
+		case FetchState::done:
+			break;
+	}
+
+	return result;
+}
+
 int Sqlite3Statement::execute(Table *dbResultTable){
 	using namespace ecs::tools;
 	using namespace types;
@@ -186,47 +506,80 @@ int Sqlite3Statement::execute(Table *dbResultTable){
 		setErrorString("There is no sqlite statement available");
 		return -1;
 	}
+
+	prefetcher.reset();
+	cachedResult.reset();
+	collector.reset();
+	if(cacheable && makeResultKey(resultKey)) {
+		auto cached = cache->lookup(resultKey);
+
+		if(cached) {
+			row.reset();
+			status = SQLITE_DONE;
+			dbResultTable->columnNames = cached->columnNames;
+			cachedResult = std::move(cached);
+			cachedRow    = 0;
+			fetchState   = FetchState::cached;
+			return 0;
+		}
+
+		/* Collect the rows while they are fetched */
+		collectorVersion   = cache->getVersion();
+		collector          = std::make_shared<Sqlite3CachedResult>();
+		collector->tables  = access.reads;
+	}
 	
+	/* Blobs of the first row are copied as well because the
+	 * prefetch thread steps before the row is fetched.
+	 */
+	bool prefetch = prefetchDepth > 0 && sqlite3_stmt_readonly(sqlite3Stmt.get()) &&
+			sqlite3_column_count(sqlite3Stmt.get()) > 0;
+
+	plan.clear();
+	planOwnBlobs = prefetch;
+
 	row.reset();
 	auto rc = step(row);
-	if(rc < 0) {
-		doFetchRow = [](Sqlite3Statement *stmt){
-			return std::unique_ptr<Row>();
-		};
-
-	}else if(rc == 0) {
-		/* No more values expected */
-		rc = 0;
-		doFetchRow = [](Sqlite3Statement *stmt){
-			return std::unique_ptr<Row>();
-		};
-	}else if(rc == 1) {
+	if(rc == 1) {
 		/* More values expected which need a fetch */
-		rc = 0;
-		doFetchRow = [](Sqlite3Statement *stmt){
-			stmt->doFetchRow = [](Sqlite3Statement *stmt){
-				std::unique_ptr<Row> row;
-				stmt->step(row);
-				return row;
-			};
-
-			return std::move(stmt->row);
-		};
+		rc         = 0;
+		fetchState = FetchState::first;
+
+		if(prefetch) {
+			prefetchState = StepState();
+			prefetcher    = std::make_unique<Sqlite3Prefetcher>([this](Sqlite3RowBatch &batch){
+				return step(batch, prefetchState);
+			}, prefetchDepth, prefetchBatchRows);
+		}
 	}else{
-		doFetchRow = [](Sqlite3Statement *stmt){
-			return std::unique_ptr<Row>();
-		};
-		/* Unexpected result code */
-		rc = -1;
+		fetchState = FetchState::done;
 	}
 
-	/* Check if there are result rows and set names */
+	/* Check if there are result rows and set names. The prefetch
+	 * thread only steps so reading the names is safe.
+	 */
 	int columnCount = sqlite3_column_count(sqlite3Stmt.get());
 	for(int i = 0;i < columnCount;++i) {
 			/* Set column name */
 			dbResultTable->columnNames.push_back(sqlite3_column_name(sqlite3Stmt.get(), i));
 	}
 
+	if(collector) {
+		if(rc < 0) {
+			collector.reset();
+		}else{
+			collector->columnNames = dbResultTable->columnNames;
+		}
+	}
+
+	if(hooks && !classified && hooks->isCapturing()) {
+		hooks->classify(sqlite3Stmt.get(), access);
+		classified = true;
+	}
+	if(classified) {
+		hooks->executed(access, rc >= 0);
+	}
+
 	return rc;
 }
 
@@ -327,10 +680,24 @@ bool Sqlite3Statement::bind(ecs::db3::types::cell_T *parameter, const std::strin
 		case types::typeId::boolean_T:
 			status = sqlite3_bind_int(sqlite3Stmt.get(),n+1,any::cast_reference<Boolean>(*parameter) == true ? 1 : 0);
 			break;
+		case types::typeId::timestamp:
+			status = sqlite3_bind_int64(sqlite3Stmt.get(),n+1,any::cast_reference<types::Timestamp>(*parameter).getMicroseconds());
+			break;
+		case types::typeId::uuid:
+			status = sqlite3_bind_blob(sqlite3Stmt.get(),n+1,any::cast_reference<Uuid>(*parameter).data(),16,SQLITE_TRANSIENT);
+			break;
 		default:
 			break;
 	}
 
+	if(cacheable) {
+		if(static_cast<std::size_t>(n) >= bindingKeys.size()) {
+			bindingKeys.resize(n + 1);
+		}
+
+		bindingKey(*parameter, bindingKeys[n]);
+	}
+
 	if(status == SQLITE_OK) {
 		return true;
 	}
@@ -338,7 +705,28 @@ bool Sqlite3Statement::bind(ecs::db3::types::cell_T *parameter, const std::strin
 	return false;
 }
 
+void Sqlite3Statement::finishPrefetch() {
+	prefetcher.reset();
+
+	status       = prefetchState.status;
+	busyRetries += prefetchState.busyRetries;
+	if(!prefetchState.error.empty()) {
+		setErrorString(prefetchState.error);
+	}
+	prefetchState = StepState();
+}
+
+void Sqlite3Statement::failPrefetch(const std::string &error) {
+	finishPrefetch();
+	fetchState = FetchState::done;
+	status     = -1;
+	setErrorString(error);
+}
+
 void Sqlite3Statement::reset(){
+	prefetcher.reset();
+	cachedResult.reset();
+	fetchState = FetchState::done;
 	sqlite3_reset(sqlite3Stmt.get());
 }
 
@@ -347,7 +735,7 @@ void Sqlite3Statement::clearBindings(){
 }
 
 
-Sqlite3Connection::Sqlite3Connection() : sqlite3Con(nullptr) {
+Sqlite3Connection::Sqlite3Connection() : sqlite3Con(nullptr), prefetchDepth(0), nativeTimestamps(false) {
 
 }
 
@@ -373,7 +761,7 @@ std::string Sqlite3Connection::getPluginName() {
 
 StatementImpl::ptr_T Sqlite3Connection::prepare(const std::string &query){
 	try {
-		auto result = std::make_unique<Sqlite3Statement>(sqlite3Con, query);
+		auto result = std::make_unique<Sqlite3Statement>(sqlite3Con, query, hooks, prefetchDepth, nativeTimestamps);
 		return result.release();
 	}catch(...){
 		setErrorMessage(sqlite3_errmsg(sqlite3Con));
@@ -383,6 +771,8 @@ StatementImpl::ptr_T Sqlite3Connection::prepare(const std::string &query){
 }
 
 bool Sqlite3Connection::connect(const ConnectionParameters &parameters){
+	ECS_PROFILE_ZONE("Sqlite3Connection::connect");
+
 	int status;
 
 	if(sqlite3Con != nullptr){
@@ -423,6 +813,37 @@ bool Sqlite3Connection::connect(const ConnectionParameters &parameters){
 	/* Register extension functions */
 	SQLITE3_UTC_EXT(sqlite3Con, NULL, NULL);
 	SQLITE3_UUID_EXT(sqlite3Con, NULL, NULL);
+
+	/* Move checkpoints and vacuum away from the committing writers */
+	if(parameters.getWalCheckpointPages() > 0) {
+		try {
+			maintenance = std::make_unique<Sqlite3Maintenance>(sqlite3Con,
+					parameters.getWalCheckpointPages(), parameters.getMaintenanceIdleTime(),
+					parameters.getIncrementalVacuumPages());
+		}catch(const std::exception &e){
+			/* The connection is still usable with automatic checkpoints */
+			setErrorMessage(e.what());
+		}
+	}
+
+	if(parameters.getResultCacheBytes() > 0) {
+		resultCache = std::make_shared<Sqlite3ResultCache>(parameters.getResultCacheBytes());
+	}
+
+	/* Without a cache the authorizer is only installed by prepare
+	 * once captureChanges was called.
+	 */
+	hooks = std::make_shared<Sqlite3Hooks>(sqlite3Con, resultCache);
+	/* With a single cpu the thread only adds the handoff */
+	prefetchDepth    = Sqlite3Prefetcher::hasSpareCpu() ? parameters.getPrefetchDepth() : 0;
+	nativeTimestamps = parameters.getNativeTimestamps();
+
+	auto slowQuerySink = parameters.getSlowQueryThreshold().count() > 0 ? parameters.getSlowQuerySink() : slowQuerySink_T();
+	if(slowQuerySink || parameters.getWorkloadCapture()) {
+		queryLog = std::make_unique<Sqlite3QueryLog>(sqlite3Con,
+				parameters.getSlowQueryThreshold(), std::move(slowQuerySink), parameters.getWorkloadCapture());
+	}
+
 	return true;
 }
 
@@ -432,17 +853,162 @@ bool Sqlite3Connection::disconnect(){
 		return false;
 	}
 
+	maintenance.reset();
+	queryLog.reset();
+
+	/* Statements may keep the hooks alive after the connection is closed */
+	if(hooks) {
+		hooks->detach();
+		hooks.reset();
+	}
+	resultCache.reset();
+
 	status = sqlite3_close_v2(sqlite3Con);
 	sqlite3Con = nullptr;
 
 	return true;
 }
 
+void Sqlite3Connection::startTransation() {
+	executeTransactionQuery("BEGIN;");
+}
+
+void Sqlite3Connection::commitTransaction() {
+	executeTransactionQuery("COMMIT;");
+}
+
+void Sqlite3Connection::rollbackTransaction() {
+	executeTransactionQuery("ROLLBACK;");
+}
+
+void Sqlite3Connection::executeTransactionQuery(const char *query) {
+	char *message = nullptr;
+
+	if(sqlite3_exec(sqlite3Con, query, nullptr, nullptr, &message) != SQLITE_OK) {
+		std::string error(message ? message : sqlite3_errmsg(sqlite3Con));
+		sqlite3_free(message);
+		setErrorMessage(error);
+		throw std::runtime_error("Transaction control failed: " + error);
+	}
+}
+
 ecs::db3::MigratorImpl* Sqlite3Connection::getMigrator(DbConnection *connection) {
 	auto result = std::make_unique<ecs::db3::MigratorImplSqlite3>(connection);
 	return result.release();
 }
 
+bool Sqlite3Connection::backup(ConnectionImpl *destination, int pagesPerStep,
+		std::chrono::milliseconds sleep,
+		const std::function<void(int, int)> &progress) {
+	auto target = dynamic_cast<Sqlite3Connection*>(destination);
+
+	if(target == nullptr || target->sqlite3Con == nullptr || sqlite3Con == nullptr) {
+		setErrorMessage("Backup is only possible between two open sqlite3 connections");
+		return false;
+	}
+
+	sqlite3_backup *backup = sqlite3_backup_init(target->sqlite3Con, "main", sqlite3Con, "main");
+
+	if(backup == nullptr) {
+		setErrorMessage(sqlite3_errmsg(target->sqlite3Con));
+		return false;
+	}
+
+	int status;
+
+	/* Every step only holds the source lock while copying the given
+	 * amount of pages. When the source is locked by a writer we just
+	 * try again after sleeping.
+	 */
+	do {
+		status = sqlite3_backup_step(backup, pagesPerStep);
+
+		if(progress) {
+			progress(sqlite3_backup_remaining(backup), sqlite3_backup_pagecount(backup));
+		}
+
+		if(status == SQLITE_OK || status == SQLITE_BUSY || status == SQLITE_LOCKED) {
+			std::this_thread::sleep_for(sleep);
+		}
+	}while(status == SQLITE_OK || status == SQLITE_BUSY || status == SQLITE_LOCKED);
+
+	/* Finish releases the backup object in every case */
+	sqlite3_backup_finish(backup);
+
+	if(status != SQLITE_DONE) {
+		setErrorMessage(sqlite3_errstr(status));
+		return false;
+	}
+
+	return true;
+}
+
+void Sqlite3Connection::getMaintenanceStatistics(MaintenanceStatistics &statistics) {
+	if(maintenance) {
+		maintenance->getStatistics(statistics);
+	}
+}
+
+void Sqlite3Connection::getResultCacheStatistics(ResultCacheStatistics &statistics) {
+	if(resultCache) {
+		resultCache->getStatistics(statistics);
+	}
+}
+
+bool Sqlite3Connection::captureChanges(std::function<void(ChangeBatch&&)> publish) {
+	if(sqlite3Con == nullptr) {
+		setErrorMessage("Not connected");
+		return false;
+	}
+
+	hooks->captureChanges(std::move(publish));
+	return true;
+}
+
+bool Sqlite3Connection::adviseIndexes(std::vector<IndexAdvice> &advice) {
+	if(!queryLog || !queryLog->isCapturingWorkload()) {
+		setErrorMessage("The workload capture is disabled in the connection parameters");
+		return false;
+	}
+
+	try {
+		Sqlite3IndexAdvisor advisor(sqlite3Con);
+		for(auto &entry : queryLog->getWorkload()) {
+			advisor.add(entry);
+		}
+		advice = advisor.getAdvice();
+	}catch(const std::exception &e){
+		setErrorMessage(e.what());
+		return false;
+	}
+
+	return true;
+}
+
+bool Sqlite3Connection::locksDatabaseOnWrite() const {
+	return true;
+}
+
+bool Sqlite3Connection::registerTable(const std::string &name, MemoryTable::sharedPtr_T table) {
+	if(sqlite3Con == nullptr) {
+		setErrorMessage("Not connected");
+		return false;
+	}
+
+	if(resultCache) {
+		resultCache->addVolatileTable(name);
+	}
+
+	auto status = Sqlite3MemoryTableModule::registerTable(sqlite3Con, name, std::move(table));
+
+	if(status != SQLITE_OK) {
+		setErrorMessage(sqlite3_errmsg(sqlite3Con));
+		return false;
+	}
+
+	return true;
+}
+
 /** @} */
 
 DYNLIB_BEGIN_CLASS_DEFINITION()
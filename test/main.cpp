@@ -10,7 +10,17 @@
 #include <sstream>
 #include <fstream>
 #include <chrono>
+#include <atomic>
+#include <thread>
+#include <unordered_set>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <algorithm>
 #include <ecs/TicToc.hpp>
+#include <ecs/Timestamp.hpp>
+#include <ecs/UUID.hpp>
+#include <ecs/Profiler.hpp>
 #include <boost/filesystem.hpp>
 
 #include <boost/iostreams/stream.hpp>
@@ -357,6 +367,80 @@ TEST_CASE( "Testing a lot of inserts with auto generated uuid values", "[ecsdb]"
 	t.toc();
 }
 
+TEST_CASE( "Binary uuid values and uuid conversion functions", "[ecsdb]" ) {
+	using namespace ecs::db3;
+
+	ConnectionParameters memoryParams(params);
+	memoryParams.setBackend("sqlite3");
+	memoryParams.setDbFilename(":memory:");
+	auto connection = memoryParams.connect();
+
+	REQUIRE(connection->execute(
+		"CREATE TABLE uuids (id BLOB PRIMARY KEY DEFAULT (uuid_blob()), value INT);"));
+	auto insert = connection->prepare("INSERT INTO uuids(value) VALUES(?);");
+	for(std::int64_t i = 0;i < 100;++i) {
+		insert->bind(i);
+		REQUIRE(insert->execute() == true);
+		insert->reset();
+	}
+
+	auto scalar = [&](const std::string &query) {
+		return connection->prepare(query)->execute().fetch();
+	};
+
+	REQUIRE(scalar("SELECT count(DISTINCT id) FROM uuids WHERE length(id) = 16;").at(0).cast_reference<std::int64_t>() == 100);
+	REQUIRE(scalar("SELECT count(*) FROM uuids WHERE uuid_bin(uuid_str(id)) = id;").at(0).cast_reference<std::int64_t>() == 100);
+	REQUIRE(scalar("SELECT uuid_str('{6BA7B810-9DAD-11D1-80B4-00C04FD430C8}');").at(0).cast_reference<std::string>()
+			== "6ba7b810-9dad-11d1-80b4-00c04fd430c8");
+	REQUIRE(scalar("SELECT uuid_str(uuid_bin('6ba7b8109dad11d180b400c04fd430c8'));").at(0).cast_reference<std::string>()
+			== "6ba7b810-9dad-11d1-80b4-00c04fd430c8");
+	REQUIRE(scalar("SELECT uuid_bin('not a uuid') IS NULL;").at(0).cast_reference<std::int64_t>() == 1);
+	REQUIRE(scalar("SELECT uuid_str(x'0102') IS NULL;").at(0).cast_reference<std::int64_t>() == 1);
+	REQUIRE(scalar("SELECT length(uuid_generate_v4());").at(0).cast_reference<std::int64_t>() == 36);
+	REQUIRE(scalar("SELECT uuid_nil();").at(0).cast_reference<std::string>() == "00000000-0000-0000-0000-000000000000");
+}
+
+TEST_CASE( "UUID value type and generators", "[ecsuuid]" ) {
+	using ecs::tools::UUID;
+
+	UUID parsed = UUID::fromString("{6BA7B810-9DAD-11D1-80B4-00C04FD430C8}");
+	REQUIRE(parsed.toString() == "6ba7b810-9dad-11d1-80b4-00c04fd430c8");
+	REQUIRE(parsed.getVersion() == 1);
+	REQUIRE(UUID::fromString("6ba7b8109dad11d180b400c04fd430c8") == parsed);
+	REQUIRE_THROWS(UUID::fromString("6ba7b810-9dad-11d1-80b4-00c04fd430cx"));
+	REQUIRE(UUID().isNil());
+
+	std::vector<UUID> random(1000);
+	ecs::tools::UUIDGenerator().generate(random.data(), random.size());
+	std::unordered_set<UUID> unique(random.begin(), random.end());
+	REQUIRE(unique.size() == random.size());
+	REQUIRE(std::all_of(random.begin(), random.end(), [](const UUID &uuid){
+		return uuid.getVersion() == 4 && (uuid.getBytes()[8] & 0xc0) == 0x80;
+	}));
+
+	/* Version 7 is strictly increasing inside one thread */
+	std::vector<UUID> ordered(10000);
+	ecs::tools::UUIDGenerator7().generate(ordered.data(), ordered.size());
+	REQUIRE(std::is_sorted(ordered.begin(), ordered.end()));
+	REQUIRE(std::adjacent_find(ordered.begin(), ordered.end()) == ordered.end());
+	REQUIRE(ordered.front().getVersion() == 7);
+
+	ecs::db3::ConnectionParameters memoryParams(params);
+	memoryParams.setBackend("sqlite3");
+	memoryParams.setDbFilename(":memory:");
+	auto connection = memoryParams.connect();
+
+	REQUIRE(connection->execute("CREATE TABLE ordered (id BLOB PRIMARY KEY DEFAULT (uuid_blob_v7()), value INT);"));
+	for(std::int64_t i = 0;i < 100;++i) {
+		REQUIRE(connection->execute("INSERT INTO ordered(value) VALUES(" + std::to_string(i) + ");"));
+	}
+	auto table = connection->prepare("SELECT value FROM ordered ORDER BY id;")->execute().fetchAll();
+	REQUIRE(table.size() == 100);
+	for(std::size_t i = 0;i < table.size();++i) {
+		REQUIRE(table.at(i).at(0).cast_reference<std::int64_t>() == static_cast<std::int64_t>(i));
+	}
+}
+
 TEST_CASE("Testing if throwing works when executing invalid SQL statements", "[ecsdb]") {
 	using namespace ecs::db3;
 	PluginLoader         loader;
@@ -377,6 +461,128 @@ TEST_CASE("Testing if throwing works when executing invalid SQL statements", "[e
 	REQUIRE_NOTHROW(connection->prepare("CREATE TABLE testtable(col2 INT);"));
 }
 
+TEST_CASE( "Formatting timestamps without locking", "[ecstime]" ) {
+	using namespace std::chrono;
+
+	/* Compare against strftime for dates around leap years and before the epoch */
+	for(std::int64_t second : {std::int64_t(0), std::int64_t(-1), std::int64_t(951782400), std::int64_t(4107542399), std::int64_t(1621246830)}) {
+		std::time_t t = static_cast<std::time_t>(second);
+		std::tm tm = ecs::time::gmtime(&t);
+		char expected[64];
+		std::strftime(expected, sizeof(expected), "%FT%TZ", &tm);
+
+		char buffer[ecs::time::ISO8601BufferSize];
+		auto length = ecs::time::formatISO8601(system_clock::time_point(seconds(second)), buffer);
+		REQUIRE(std::string(buffer, length) == expected);
+	}
+
+	char buffer[ecs::time::ISO8601BufferSize];
+	auto time = system_clock::time_point(seconds(1621246830) + microseconds(123456));
+	REQUIRE(std::string(buffer, ecs::time::formatISO8601(time, buffer, ecs::time::Precision::milliseconds))
+			== "2021-05-17T10:20:30.123Z");
+	REQUIRE(std::string(buffer, ecs::time::formatISO8601(time, buffer, ecs::time::Precision::microseconds))
+			== "2021-05-17T10:20:30.123456Z");
+	REQUIRE(std::string(buffer, ecs::time::formatISO8601(system_clock::time_point(microseconds(-1)), buffer,
+			ecs::time::Precision::microseconds)) == "1969-12-31T23:59:59.999999Z");
+
+	auto local = ecs::time::ISO8601::now(seconds(0), true, ecs::time::Precision::milliseconds);
+	REQUIRE(local.size() == 28);
+	REQUIRE(local[19] == '.');
+
+	ecs::db3::ConnectionParameters memoryParams(params);
+	memoryParams.setBackend("sqlite3");
+	memoryParams.setDbFilename(":memory:");
+	auto connection = memoryParams.connect();
+	auto result = connection->prepare("SELECT utc_timestamp(), utc_timestamp_ms(), utc_timestamp_us();")->execute().fetch();
+	REQUIRE(result.at(0).cast_reference<std::string>().size() == 20);
+	REQUIRE(result.at(1).cast_reference<std::string>().size() == 24);
+	REQUIRE(result.at(2).cast_reference<std::string>().size() == 27);
+}
+
+TEST_CASE( "Timestamp value type", "[ecstime]" ) {
+	using namespace std::chrono;
+	using ecs::time::Timestamp;
+
+	static_assert(sizeof(Timestamp) == sizeof(std::int64_t), "Timestamp must stay a single integer");
+
+	Timestamp parsed;
+	REQUIRE(Timestamp::parse("2021-05-17T10:20:30.123456Z", parsed));
+	REQUIRE(parsed.getMicroseconds() == 1621246830123456);
+	REQUIRE(parsed.toISO8601() == "2021-05-17T10:20:30.123456Z");
+	REQUIRE(parsed.toISO8601(ecs::time::Precision::seconds) == "2021-05-17T10:20:30Z");
+
+	REQUIRE(Timestamp::fromISO8601("2021-05-17 12:20:30.123456789+02:00") == parsed);
+	REQUIRE(Timestamp::fromISO8601("2021-05-17T12:20:30.123456+0200") == parsed);
+	REQUIRE(Timestamp::fromISO8601("2021-05-17T10:20:30,123456") == parsed);
+	REQUIRE(Timestamp::fromISO8601("2021-05-17T10:20Z") == Timestamp::fromISO8601("2021-05-17T10:20:00Z"));
+	REQUIRE(Timestamp::fromISO8601("1970-01-01") == Timestamp());
+	REQUIRE(Timestamp::fromISO8601("1969-12-31T23:59:59Z").getMicroseconds() == -1000000);
+	REQUIRE(Timestamp::fromISO8601("2000-02-29T00:00:00Z").toISO8601(ecs::time::Precision::seconds) == "2000-02-29T00:00:00Z");
+
+	for(auto invalid : {"", "2021-02-29", "2021-13-01T00:00:00Z", "2021-05-17T24:00:00Z", "2021-05-17T10:20:3xZ",
+			"2021-05-17T10:20:30.Z", "2021-05-17T10:20:30+2", "2021/05/17T10:20:30Z", "2021-05-17T10:20:30Zjunk"}) {
+		REQUIRE_FALSE(Timestamp::parse(invalid, parsed));
+	}
+	REQUIRE_THROWS(Timestamp::fromISO8601("yesterday"));
+
+	auto later = parsed + minutes(90);
+	REQUIRE(later - parsed == minutes(90));
+	REQUIRE(later > parsed);
+	REQUIRE(later - hours(1) - minutes(30) == parsed);
+	REQUIRE(Timestamp(later.toTimePoint()) == later);
+	REQUIRE(Timestamp::now() > parsed);
+}
+
+TEST_CASE( "Native timestamp and uuid columns", "[ecsdb]" ) {
+	using namespace ecs::db3;
+
+	ConnectionParameters memoryParams(params);
+	memoryParams.setBackend("sqlite3");
+	memoryParams.setDbFilename(":memory:");
+	memoryParams.setNativeTimestamps(true);
+	auto connection = memoryParams.connect();
+
+	REQUIRE(connection->execute("CREATE TABLE events (id UUID, ts TIMESTAMP, value INT);"));
+
+	auto base   = ecs::time::Timestamp::fromISO8601("2024-02-29T23:59:59.250000Z");
+	auto insert = connection->prepare("INSERT INTO events(id, ts, value) VALUES(?, ?, ?);");
+	for(std::int64_t i = 0;i < 10;++i) {
+		ecs::tools::UUID::bytes_T id{};
+		id[15] = static_cast<std::uint8_t>(i);
+		insert->bind(ecs::tools::UUID(id));
+		insert->bind(base + std::chrono::seconds(i));
+		insert->bind(i);
+		REQUIRE(insert->execute() == true);
+		insert->reset();
+	}
+
+	auto range = connection->prepare("SELECT id, ts, value FROM events WHERE ts >= ? AND ts < ? ORDER BY ts DESC;");
+	range->bind(base + std::chrono::seconds(2));
+	range->bind(base + std::chrono::seconds(5));
+	auto table = range->execute().fetchAll();
+
+	REQUIRE(table.size() == 3);
+	REQUIRE(table.at(0).at(0).getTypeId() == types::typeId::uuid);
+	REQUIRE(table.at(0).at(0).cast_reference<ecs::tools::UUID>().getBytes()[15] == 4);
+	REQUIRE(table.at(0).at(1).getTypeId() == types::typeId::timestamp);
+	REQUIRE(table.at(0).at(1).cast_reference<ecs::time::Timestamp>() == base + std::chrono::seconds(4));
+	REQUIRE(table.at(2).at(1).cast_reference<ecs::time::Timestamp>().toISO8601() == "2024-03-01T00:00:01.250000Z");
+
+	/* Other declared types keep returning plain integers */
+	auto value = connection->prepare("SELECT value FROM events WHERE value = 7;")->execute().fetch();
+	REQUIRE(value.at(0).getTypeId() == types::typeId::int64_T);
+	/* Without the flag the stored microseconds are returned */
+	memoryParams.setNativeTimestamps(false);
+	memoryParams.setDbFilename(":memory:");
+	auto plain = memoryParams.connect();
+	REQUIRE(plain->execute("CREATE TABLE events (ts TIMESTAMP);"));
+	auto insertPlain = plain->prepare("INSERT INTO events(ts) VALUES(?);");
+	insertPlain->bind(base);
+	REQUIRE(insertPlain->execute() == true);
+	auto stored = plain->prepare("SELECT ts FROM events;")->execute().fetch();
+	REQUIRE(stored.at(0).cast_reference<std::int64_t>() == base.getMicroseconds());
+}
+
 TEST_CASE( "Testing a lot of inserts with auto generated timestamp values", "[ecsdb]" ) {
 	using namespace ecs::db3;
 	ecs::tools::TicToc t;
@@ -540,6 +746,1181 @@ TEST_CASE("Migration test", "[ecsdb_migration]") {
 	REQUIRE_NOTHROW(migration.startMigration());
 }
 
+TEST_CASE("Asynchronous execution on the connection worker", "[ecsdb_async]") {
+	using namespace ecs::db3;
+
+	ConnectionParameters memoryParams(params);
+	memoryParams.setBackend("sqlite3");
+	memoryParams.setDbFilename(":memory:");
+
+	std::vector<DbConnection::sharedPtr_T> connections;
+	std::vector<Statement::sharedPtr_T>    statements;
+
+	for(int i = 0;i < 4;++i) {
+		auto connection = memoryParams.connect();
+		REQUIRE(connection->execute("CREATE TABLE t(a INTEGER);"));
+		REQUIRE(connection->execute(
+			"WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM c WHERE x < 1000) "
+			"INSERT INTO t SELECT x FROM c;"));
+		auto statement = connection->prepare("SELECT count(*), sum(a) FROM t WHERE a > ?;");
+		statement->bind(static_cast<std::int64_t>(i * 100));
+		connections.push_back(connection);
+		statements.push_back(statement);
+	}
+
+	/* Every connection runs its query on its own worker */
+	std::vector<std::future<Result>> futures;
+	for(auto &statement : statements) {
+		futures.push_back(statement->executeAsync());
+	}
+
+	for(std::size_t i = 0;i < futures.size();++i) {
+		auto result = futures[i].get();
+		auto table  = result.fetchAllAsync().get();
+		REQUIRE(table.size() == 1);
+		REQUIRE(table.at(0).at(0).cast_reference<std::int64_t>() == 1000 - static_cast<std::int64_t>(i) * 100);
+	}
+
+	/* Blocks the query reading it until it is released */
+	struct LatchTable : public MemoryTable {
+		std::vector<MemoryColumn>  columns{{"a", types::typeId::int64_T, false}};
+		mutable std::promise<void> started;
+		mutable std::atomic<bool>  entered{false};
+		std::shared_future<void>   released;
+
+		const std::vector<MemoryColumn> &getColumns() const override {
+			return columns;
+		}
+
+		std::size_t size() const override {
+			return 1;
+		}
+
+		std::int64_t getInt64(std::size_t row, std::size_t column) const override {
+			if(!entered.exchange(true)) {
+				started.set_value();
+			}
+			released.wait();
+			return 42;
+		}
+	};
+
+	std::promise<void> release;
+	auto latch      = std::make_shared<LatchTable>();
+	latch->released = release.get_future().share();
+	auto started    = latch->started.get_future();
+	connections[0]->registerTable("latch", latch);
+
+	/* Statements of one connection are serialized. The second one
+	 * belongs to the worker until the blocked first query has finished.
+	 */
+	auto slow = connections[0]->prepare("SELECT a FROM latch;");
+	auto fast = connections[0]->prepare("SELECT count(*) FROM t;");
+	auto slowResult = slow->executeAsync();
+	started.wait();
+	auto fastResult = fast->executeAsync();
+	REQUIRE_THROWS(fast->bind(static_cast<std::int64_t>(1)));
+	release.set_value();
+	REQUIRE(slowResult.get().fetch().at(0).cast_reference<std::int64_t>() == 42);
+	REQUIRE(fastResult.get().fetch().at(0).cast_reference<std::int64_t>() == 1000);
+
+	/* Failures are rethrown by the future */
+	REQUIRE(connections[1]->execute("CREATE TABLE u(a INTEGER NOT NULL);"));
+	auto failing = connections[1]->prepare("INSERT INTO u VALUES(NULL);");
+	REQUIRE_THROWS(failing->executeAsync().get());
+}
+
+TEST_CASE("Group commit of concurrent writers", "[ecsdb_groupcommit]") {
+	using namespace ecs::db3;
+
+	ConnectionParameters fileParams(params);
+	fileParams.setBackend("sqlite3");
+	fileParams.setDbFilename("./groupcommit.sqlite3");
+	boost::filesystem::remove(fileParams.getDbFilename());
+
+	auto connection = fileParams.connect();
+	REQUIRE(connection->execute("CREATE TABLE t(a INTEGER PRIMARY KEY, b INTEGER NOT NULL);"));
+
+	std::atomic<int> failed(0);
+	{
+		GroupCommit groupCommit(connection, std::chrono::milliseconds(5), 64);
+		std::vector<std::thread> writers;
+
+		for(int thread = 0;thread < 8;++thread) {
+			writers.emplace_back([&, thread](){
+				for(std::int64_t i = 0;i < 50;++i) {
+					std::int64_t key = thread * 1000 + i;
+					auto done = groupCommit.submit([key](DbConnection &connection){
+						auto insert = connection.prepare("INSERT INTO t(a, b) VALUES(?, ?);");
+						insert->bind(key);
+						/* Every tenth row violates the NOT NULL constraint */
+						if(key % 10 == 0) {
+							insert->bind(nullptr);
+						}else{
+							insert->bind(key);
+						}
+						insert->execute();
+					});
+
+					try {
+						done.get();
+					}catch(std::exception &) {
+						failed++;
+					}
+				}
+			});
+		}
+
+		for(auto &writer : writers) {
+			writer.join();
+		}
+
+		auto statistics = groupCommit.getStatistics();
+		REQUIRE(statistics.submissions == 400);
+		REQUIRE(statistics.failures == 40);
+		REQUIRE(statistics.transactions < statistics.submissions);
+		REQUIRE(statistics.largestBatch > 1);
+	}
+
+	REQUIRE(failed == 40);
+	auto count = connection->prepare("SELECT count(*) FROM t;")->execute().fetch();
+	REQUIRE(count.at(0).cast_reference<std::int64_t>() == 360);
+
+	/* The instrumented backend reports the capability of sqlite3 */
+	ConnectionParameters instrumentedParams(fileParams);
+	instrumentedParams.setBackend("instrumented");
+	instrumentedParams.setWrappedBackend("sqlite3");
+	auto instrumented = instrumentedParams.connect();
+	REQUIRE(connection->locksDatabaseOnWrite());
+	REQUIRE(instrumented->locksDatabaseOnWrite());
+
+	/* A submission which ends the transaction breaks the rollback to
+	 * its savepoint so the whole batch fails.
+	 */
+	{
+		GroupCommit groupCommit(instrumented, std::chrono::seconds(10), 3);
+		auto first  = groupCommit.submit([](DbConnection &connection){
+			connection.execute("INSERT INTO t(a, b) VALUES(9001, 1);");
+		});
+		auto second = groupCommit.submit([](DbConnection &connection){
+			connection.execute("COMMIT;");
+			throw std::runtime_error("Submission failed");
+		});
+		auto third  = groupCommit.submit([](DbConnection &connection){
+			connection.execute("INSERT INTO t(a, b) VALUES(9003, 1);");
+		});
+
+		REQUIRE_THROWS(first.get());
+		REQUIRE_THROWS(second.get());
+		REQUIRE_THROWS(third.get());
+
+		auto statistics = groupCommit.getStatistics();
+		REQUIRE(statistics.transactions == 1);
+		REQUIRE(statistics.failures == 3);
+	}
+
+	/* The batch stopped at the broken submission */
+	count = connection->prepare("SELECT count(*) FROM t WHERE a = 9003;")->execute().fetch();
+	REQUIRE(count.at(0).cast_reference<std::int64_t>() == 0);
+}
+
+TEST_CASE("Write behind inserts from many threads", "[ecsdb_writebehind]") {
+	using namespace ecs::db3;
+
+	ConnectionParameters fileParams(params);
+	fileParams.setBackend("sqlite3");
+	fileParams.setDbFilename("./writebehind.sqlite3");
+	boost::filesystem::remove(fileParams.getDbFilename());
+
+	auto connection = fileParams.connect();
+	REQUIRE(connection->execute("CREATE TABLE samples(thread INTEGER, ts TIMESTAMP, value DOUBLE);"));
+
+	/* A small buffer forces the writers to wait for the flusher */
+	WriteBehindTable table(connection, "INSERT INTO samples(thread, ts, value) VALUES(?, ?, ?);",
+			256, 100, std::chrono::milliseconds(20));
+
+	std::vector<std::thread> writers;
+	for(std::int64_t thread = 0;thread < 4;++thread) {
+		writers.emplace_back([&table, thread](){
+			for(int i = 0;i < 2500;++i) {
+				table.append(thread, ecs::time::Timestamp::now(), i * 0.5);
+			}
+		});
+	}
+	for(auto &writer : writers) {
+		writer.join();
+	}
+
+	table.flush();
+	auto count = connection->prepare("SELECT count(*), count(DISTINCT thread) FROM samples;")->execute().fetch();
+	REQUIRE(count.at(0).cast_reference<std::int64_t>() == 10000);
+	REQUIRE(count.at(1).cast_reference<std::int64_t>() == 4);
+
+	auto statistics = table.getStatistics();
+	REQUIRE(statistics.rowsWritten == 10000);
+	REQUIRE(statistics.rowsFailed == 0);
+	REQUIRE(statistics.flushes >= 100);
+	REQUIRE(statistics.lastError.empty());
+
+	/* Rows are written once they are older than the age limit */
+	REQUIRE(table.tryAppend(std::int64_t(9), ecs::time::Timestamp::now(), 1.0));
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+	while(table.getStatistics().rowsWritten < 10001 && std::chrono::steady_clock::now() < deadline) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	}
+	REQUIRE(table.getStatistics().rowsWritten == 10001);
+
+	/* A failing row is counted and keeps the reason */
+	REQUIRE(connection->execute("CREATE TRIGGER reject BEFORE INSERT ON samples WHEN NEW.thread < 0 "
+			"BEGIN SELECT RAISE(ABORT, 'negative thread'); END;"));
+	table.append(std::int64_t(-1), ecs::time::Timestamp::now(), 1.0);
+	table.flush();
+	statistics = table.getStatistics();
+	REQUIRE(statistics.rowsWritten == 10001);
+	REQUIRE(statistics.rowsFailed == 1);
+	REQUIRE(statistics.lastError.find("negative thread") != std::string::npos);
+
+	/* Only the failing row of a batch is rolled back */
+	table.append(std::int64_t(1), ecs::time::Timestamp::now(), 1.0);
+	table.append(std::int64_t(-1), ecs::time::Timestamp::now(), 1.0);
+	table.append(std::int64_t(1), ecs::time::Timestamp::now(), 1.0);
+	table.flush();
+	statistics = table.getStatistics();
+	REQUIRE(statistics.rowsWritten == 10003);
+	REQUIRE(statistics.rowsFailed == 2);
+	count = connection->prepare("SELECT count(*) FROM samples;")->execute().fetch();
+	REQUIRE(count.at(0).cast_reference<std::int64_t>() == 10003);
+
+	table.close();
+	REQUIRE(table.isClosed());
+	REQUIRE_FALSE(table.tryAppend(std::int64_t(9), ecs::time::Timestamp::now(), 1.0));
+	REQUIRE_THROWS(table.append(std::int64_t(9), ecs::time::Timestamp::now(), 1.0));
+}
+
+TEST_CASE("Online backup into an in-memory database", "[ecsdb_backup]") {
+	using namespace ecs::db3;
+
+	params.setBackend("sqlite3");
+	params.setDbFilename("./backup_source.sqlite3");
+	boost::filesystem::remove(params.getDbFilename());
+
+	auto source = params.connect();
+	REQUIRE(source->execute("CREATE TABLE t(a INTEGER, b VARCHAR);"));
+	REQUIRE(source->execute("BEGIN TRANSACTION;"));
+	auto stmt = source->prepare("INSERT INTO t(a, b) VALUES(?, ?);");
+	for(std::int64_t i = 0;i < 1000;++i) {
+		stmt->bind(i);
+		stmt->bind("Some text to fill more than a single page");
+		stmt->execute();
+		stmt->reset();
+	}
+	REQUIRE(source->execute("END TRANSACTION;"));
+
+	ConnectionParameters memoryParams(params);
+	memoryParams.setDbFilename(":memory:");
+	auto destination = memoryParams.connect();
+
+	/* The progress function is called from the backup thread */
+	std::atomic<int> steps(0);
+	std::atomic<int> lastRemaining(-1);
+	auto backup = source->backupTo(*destination, 4, std::chrono::milliseconds(0), [&](int remaining, int pageCount){
+		lastRemaining = remaining;
+		steps++;
+	});
+	REQUIRE_NOTHROW(backup.get());
+	REQUIRE(steps > 1);
+	REQUIRE(lastRemaining == 0);
+
+	auto result = destination->prepare("SELECT count(*) FROM t;")->execute();
+	REQUIRE(result.fetch().at(0).cast_reference<std::int64_t>() == 1000);
+}
+
+TEST_CASE("Background WAL checkpoints and incremental vacuum", "[ecsdb_maintenance]") {
+	using namespace ecs::db3;
+
+	ConnectionParameters maintenanceParams(params);
+	maintenanceParams.setBackend("sqlite3");
+	maintenanceParams.setDbFilename("./maintenance.sqlite3");
+	maintenanceParams.setWalCheckpointPages(32);
+	maintenanceParams.setMaintenanceIdleTime(std::chrono::milliseconds(50));
+	maintenanceParams.setIncrementalVacuumPages(1000);
+	boost::filesystem::remove(maintenanceParams.getDbFilename());
+
+	auto connection = maintenanceParams.connect();
+	REQUIRE(connection->getMaintenanceStatistics().active);
+	/* Incremental vacuum can only be enabled outside of WAL mode
+	 * when the library default is not incremental.
+	 */
+	REQUIRE(connection->execute("PRAGMA journal_mode = DELETE;"));
+	REQUIRE(connection->execute("PRAGMA auto_vacuum = INCREMENTAL;"));
+	REQUIRE(connection->execute("VACUUM;"));
+	REQUIRE(connection->execute("PRAGMA journal_mode = WAL;"));
+	REQUIRE(connection->execute("CREATE TABLE t(a INTEGER, b VARCHAR);"));
+
+	auto stmt = connection->prepare("INSERT INTO t(a, b) VALUES(?, ?);");
+	for(std::int64_t i = 0;i < 2000;++i) {
+		stmt->bind(i);
+		stmt->bind(std::string(200, 'x'));
+		stmt->execute();
+		stmt->reset();
+	}
+	REQUIRE(connection->execute("DELETE FROM t;"));
+
+	/* Wait for the idle run after the last commit */
+	MaintenanceStatistics statistics;
+	for(int i = 0;i < 200;++i) {
+		statistics = connection->getMaintenanceStatistics();
+		if(statistics.idleCheckpoints > 0 && statistics.vacuums > 0) {
+			break;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+
+	REQUIRE(statistics.sizeCheckpoints > 0);
+	REQUIRE(statistics.idleCheckpoints > 0);
+	REQUIRE(statistics.checkpointedFrames > 0);
+	REQUIRE(statistics.vacuums > 0);
+	REQUIRE(statistics.vacuumedPages > 0);
+	REQUIRE(statistics.walPagesWritten >= statistics.maxWalPages);
+	REQUIRE(statistics.totalCheckpointDuration >= statistics.maxCheckpointDuration);
+}
+
+TEST_CASE("Joining persisted tables against memory tables", "[ecsdb_memorytable]") {
+	using namespace ecs::db3;
+
+	struct Item {
+		std::int64_t id;
+		std::string  name;
+		double       price;
+	};
+
+	std::vector<Item> items;
+	for(std::int64_t i = 0;i < 1000;++i) {
+		items.push_back(Item{i, "item" + std::to_string(i), i * 0.5});
+	}
+
+	std::vector<std::int64_t> orderIds   = {1, 2, 3};
+	std::vector<std::string>  orderNames = {"first", "second", "third"};
+
+	ConnectionParameters memoryParams(params);
+	memoryParams.setBackend("sqlite3");
+	memoryParams.setDbFilename(":memory:");
+	auto connection = memoryParams.connect();
+
+	auto itemTable = std::make_shared<RowVectorTable<Item>>(items);
+	itemTable->field("id", &Item::id, true).field("name", &Item::name).field("price", &Item::price);
+	connection->registerTable("items", itemTable);
+
+	auto batch = std::make_shared<ColumnBatch>();
+	batch->column("id", orderIds, true).column("name", orderNames);
+	connection->registerTable("orders", batch);
+
+	REQUIRE(connection->execute("CREATE TABLE positions(orderId INTEGER, itemId INTEGER);"));
+	REQUIRE(connection->execute("INSERT INTO positions VALUES(1, 10), (1, 20), (3, 999);"));
+
+	auto count = [&](const std::string &query) {
+		return connection->prepare(query)->execute().fetch().at(0).cast_reference<std::int64_t>();
+	};
+
+	REQUIRE(count("SELECT count(*) FROM items;") == 1000);
+	REQUIRE(count("SELECT count(*) FROM items WHERE id = 500;") == 1);
+	REQUIRE(count("SELECT count(*) FROM items WHERE id >= 100 AND id < 200;") == 100);
+	REQUIRE(count("SELECT count(*) FROM items WHERE id > 998.5;") == 1);
+	REQUIRE(count("SELECT count(*) FROM items WHERE price <= 10;") == 21);
+	REQUIRE(count("SELECT count(*) FROM items WHERE name = 'item7';") == 1);
+	REQUIRE(count("SELECT count(*) FROM items WHERE name = 'ITEM7' COLLATE NOCASE;") == 1);
+	REQUIRE(count("SELECT count(*) FROM items WHERE id = NULL;") == 0);
+	REQUIRE(count("SELECT sum(i.id) FROM positions p JOIN items i ON i.id = p.itemId "
+			"JOIN orders o ON o.id = p.orderId WHERE o.name = 'first';") == 30);
+
+	/* The table reads the live data */
+	items[500].name = "changed";
+	auto result = connection->prepare("SELECT name FROM items WHERE id = 500;")->execute();
+	REQUIRE(result.fetch().at(0).cast_reference<std::string>() == "changed");
+
+	std::vector<std::int64_t> shortColumn = {1};
+	REQUIRE_THROWS(ColumnBatch().column("a", orderIds).column("b", shortColumn));
+}
+
+TEST_CASE("Query result cache with table invalidation", "[ecsdb_resultcache]") {
+	using namespace ecs::db3;
+
+	ConnectionParameters memoryParams(params);
+	memoryParams.setBackend("sqlite3");
+	memoryParams.setDbFilename(":memory:");
+	memoryParams.setResultCacheBytes(64 * 1024);
+
+	auto connection = memoryParams.connect();
+	REQUIRE(connection->execute("CREATE TABLE items(id INTEGER PRIMARY KEY, name TEXT, price DOUBLE);"));
+	REQUIRE(connection->execute("CREATE TABLE other(a INTEGER);"));
+	REQUIRE(connection->execute(
+		"WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM c WHERE x < 100) "
+		"INSERT INTO items SELECT x, 'item' || x, NULL FROM c;"));
+
+	auto select = connection->prepare("SELECT id, name, price FROM items WHERE id <= ? ORDER BY id;");
+	auto query  = [&](std::int64_t limit) {
+		select->reset();
+		select->bind(limit);
+		return select->execute().fetchAll();
+	};
+
+	/* Second execution is answered from the cache */
+	auto first = query(10);
+	REQUIRE(first.size() == 10);
+	REQUIRE(connection->getResultCacheStatistics().misses == 1);
+	auto second = query(10);
+	REQUIRE(second.size() == 10);
+	REQUIRE(second.at(9).at(1).cast_reference<std::string>() == "item10");
+	REQUIRE(second.at(0).at(2).getTypeId() == types::typeId::null);
+	REQUIRE(second.getColumnName(1) == "name");
+
+	auto statistics = connection->getResultCacheStatistics();
+	REQUIRE(statistics.hits == 1);
+	REQUIRE(statistics.entries == 1);
+	REQUIRE(statistics.bytes > 0);
+
+	/* Other parameters are a different entry */
+	REQUIRE(query(5).size() == 5);
+	REQUIRE(connection->getResultCacheStatistics().entries == 2);
+
+	/* Writes to unrelated tables keep the results */
+	REQUIRE(connection->execute("INSERT INTO other VALUES(1);"));
+	REQUIRE(connection->getResultCacheStatistics().entries == 2);
+
+	/* Writes to a read table invalidate them */
+	REQUIRE(connection->execute("UPDATE items SET name = 'changed' WHERE id = 1;"));
+	statistics = connection->getResultCacheStatistics();
+	REQUIRE(statistics.entries == 0);
+	REQUIRE(statistics.invalidations == 2);
+	REQUIRE(query(10).at(0).at(1).cast_reference<std::string>() == "changed");
+
+	/* Rolled back changes invalidate results read inside the transaction */
+	REQUIRE(connection->execute("BEGIN;"));
+	REQUIRE(connection->execute("DELETE FROM items WHERE id = 2;"));
+	REQUIRE(query(10).size() == 9);
+	REQUIRE(connection->execute("ROLLBACK;"));
+	REQUIRE(query(10).size() == 10);
+
+	/* Results of volatile functions are never cached */
+	auto random = connection->prepare("SELECT random() FROM items WHERE id = 1;");
+	random->execute().fetchAll();
+	random->reset();
+	auto hits = connection->getResultCacheStatistics().hits;
+	random->execute().fetchAll();
+	REQUIRE(connection->getResultCacheStatistics().hits == hits);
+
+	/* The budget is kept by evicting the least recently used results */
+	ConnectionParameters smallParams(memoryParams);
+	smallParams.setResultCacheBytes(8 * 1024);
+	auto small = smallParams.connect();
+	REQUIRE(small->execute(
+		"CREATE TABLE t AS WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM c WHERE x < 1000) "
+		"SELECT x AS a FROM c;"));
+	auto range = small->prepare("SELECT a FROM t WHERE a > ? AND a <= ? + 20;");
+	for(std::int64_t i = 0;i < 50;++i) {
+		range->reset();
+		range->bind(i * 20);
+		range->bind(i * 20);
+		REQUIRE(range->execute().fetchAll().size() == 20);
+	}
+
+	statistics = small->getResultCacheStatistics();
+	REQUIRE(statistics.evictions > 0);
+	REQUIRE(statistics.bytes <= statistics.capacity);
+	REQUIRE(statistics.capacity == 8 * 1024);
+}
+
+TEST_CASE("Change capture of committed transactions", "[ecsdb_changes]") {
+	using namespace ecs::db3;
+
+	ConnectionParameters memoryParams(params);
+	memoryParams.setBackend("sqlite3");
+	memoryParams.setDbFilename(":memory:");
+
+	auto connection = memoryParams.connect();
+	REQUIRE(connection->execute("CREATE TABLE items(id INTEGER PRIMARY KEY, name TEXT);"));
+
+	std::mutex               mutex;
+	std::condition_variable  published;
+	std::vector<ChangeBatch> batches;
+
+	/* Statements prepared before the subscription report their savepoints as well */
+	auto savepointEarly = connection->prepare("SAVEPOINT early;");
+	auto rollbackEarly  = connection->prepare("ROLLBACK TO early;");
+	auto releaseEarly   = connection->prepare("RELEASE early;");
+
+	connection->subscribeChanges([&](ChangeBatch &batch){
+		std::scoped_lock lock(mutex);
+		batches.push_back(batch);
+		published.notify_all();
+	});
+
+	auto waitFor = [&](std::size_t count) {
+		std::unique_lock lock(mutex);
+		return published.wait_for(lock, std::chrono::seconds(5), [&](){
+			return batches.size() >= count;
+		});
+	};
+
+	/* Every autocommit statement is a batch */
+	REQUIRE(connection->execute("INSERT INTO items VALUES(1, 'first');"));
+	REQUIRE(waitFor(1));
+
+	/* Changes are published on commit and rolled back ones are dropped */
+	REQUIRE(connection->execute("BEGIN;"));
+	REQUIRE(connection->execute("INSERT INTO items VALUES(2, 'second');"));
+	REQUIRE(connection->execute("SAVEPOINT undone;"));
+	REQUIRE(connection->execute("INSERT INTO items VALUES(3, 'third');"));
+	REQUIRE(connection->execute("ROLLBACK TO undone;"));
+	REQUIRE(connection->execute("RELEASE undone;"));
+	savepointEarly->execute();
+	REQUIRE(connection->execute("INSERT INTO items VALUES(4, 'fourth');"));
+	rollbackEarly->execute();
+	releaseEarly->execute();
+	REQUIRE(connection->execute("UPDATE items SET name = 'changed' WHERE id = 1;"));
+	REQUIRE(connection->execute("COMMIT;"));
+
+	REQUIRE(connection->execute("BEGIN;"));
+	REQUIRE(connection->execute("DELETE FROM items WHERE id = 2;"));
+	REQUIRE(connection->execute("ROLLBACK;"));
+
+	REQUIRE(connection->execute("DELETE FROM items WHERE id = 2;"));
+	REQUIRE(waitFor(3));
+
+	std::scoped_lock lock(mutex);
+	REQUIRE(batches.size() == 3);
+	REQUIRE(batches[0].sequence < batches[1].sequence);
+
+	auto &insert = batches[0].events.at(0);
+	REQUIRE(insert.operation == ChangeOperation::insert);
+	REQUIRE(insert.table == "items");
+	REQUIRE(insert.database == "main");
+	REQUIRE(insert.newRowid == 1);
+	REQUIRE(insert.newValues.size() == 2);
+	REQUIRE(insert.newValues[1].cast_reference<std::string>() == "first");
+
+	REQUIRE(batches[1].events.size() == 2);
+	REQUIRE(batches[1].events[0].newRowid == 2);
+	auto &update = batches[1].events[1];
+	REQUIRE(update.operation == ChangeOperation::update);
+	REQUIRE(update.oldValues[1].cast_reference<std::string>() == "first");
+	REQUIRE(update.newValues[1].cast_reference<std::string>() == "changed");
+
+	auto &remove = batches[2].events.at(0);
+	REQUIRE(remove.operation == ChangeOperation::remove);
+	REQUIRE(remove.oldRowid == 2);
+	REQUIRE(remove.oldValues[1].cast_reference<std::string>() == "second");
+	REQUIRE(remove.newValues.empty());
+}
+
+TEST_CASE("Listening without notification support", "[ecsdb_notify]") {
+	using namespace ecs::db3;
+
+	ConnectionParameters memoryParams(params);
+	memoryParams.setBackend("sqlite3");
+	memoryParams.setDbFilename(":memory:");
+
+	/* Only postgresql delivers notifications */
+	auto connection = memoryParams.connect();
+	REQUIRE_THROWS(connection->listen("changes", [](const Notification &notification){}));
+	REQUIRE_THROWS(connection->listen("changes", notificationListener_T()));
+}
+
+TEST_CASE("Statement metrics and latency histograms", "[ecsdb_metrics]") {
+	using namespace ecs::db3;
+
+	REQUIRE(StatementMetrics::normalize("SELECT  *\n FROM t WHERE a = 12 AND b = 'it''s' AND c1 = ?;") ==
+			"SELECT * FROM t WHERE a = ? AND b = ? AND c1 = ?;");
+
+	/* Buckets are exact for small values and within 12.5% above */
+	LatencyHistogram histogram;
+	for(std::uint64_t value = 1;value <= 1000;value++) {
+		histogram.record(value * 1000);
+	}
+	REQUIRE(histogram.getCount() == 1000);
+	REQUIRE(histogram.getMax() == 1000000);
+	REQUIRE(histogram.percentile(0.5) >= 500000);
+	REQUIRE(histogram.percentile(0.5) <= 562500);
+	REQUIRE(histogram.percentile(1.0) == 1000000);
+	REQUIRE(LatencyHistogram::bucketUpperBound(LatencyHistogram::bucketIndex(7)) == 7);
+
+	ConnectionParameters memoryParams(params);
+	memoryParams.setBackend("sqlite3");
+	memoryParams.setDbFilename(":memory:");
+	memoryParams.setStatementMetrics(true);
+
+	auto connection = memoryParams.connect();
+	REQUIRE(connection->execute("CREATE TABLE items(id INTEGER PRIMARY KEY, name TEXT);"));
+
+	auto insert = connection->prepare("INSERT INTO items(name) VALUES(?);");
+	for(int i = 0;i < 100;i++) {
+		insert->reset();
+		insert->bind(std::string("abcd"));
+		insert->execute();
+	}
+
+	/* Both literals end up in the same statement */
+	REQUIRE(connection->prepare("SELECT id, name FROM items WHERE id <= 10;")->execute().fetchAll().size() == 10);
+	REQUIRE(connection->prepare("SELECT id, name FROM items WHERE id <= 20;")->execute().fetchAll().size() == 20);
+
+	auto statistics = connection->getStatementStatistics();
+	auto find       = [&](const std::string &statement) {
+		auto it = std::find_if(statistics.begin(), statistics.end(), [&](const StatementStatistics &entry){
+			return entry.statement == statement;
+		});
+		REQUIRE(it != statistics.end());
+		return *it;
+	};
+
+	auto inserts = find("INSERT INTO items(name) VALUES(?);");
+	REQUIRE(inserts.prepares == 1);
+	REQUIRE(inserts.executions == 100);
+	REQUIRE(inserts.errors == 0);
+	REQUIRE(inserts.execute.getCount() == 100);
+
+	auto selects = find("SELECT id, name FROM items WHERE id <= ?;");
+	REQUIRE(selects.prepares == 2);
+	REQUIRE(selects.executions == 2);
+	REQUIRE(selects.rows == 30);
+	REQUIRE(selects.bytes == 30 * (8 + 4));
+	REQUIRE(selects.fetch.getCount() >= 30);
+
+	auto text = connection->dumpMetrics();
+	REQUIRE(text.find("# TYPE ecs_db_statement_execute_seconds histogram") != std::string::npos);
+	REQUIRE(text.find("ecs_db_statement_executions_total{statement=\"INSERT INTO items(name) VALUES(?);\"} 100") != std::string::npos);
+	REQUIRE(text.find("ecs_db_statement_execute_seconds_count{statement=\"INSERT INTO items(name) VALUES(?);\"} 100") != std::string::npos);
+	REQUIRE(text.find("le=\"+Inf\"") != std::string::npos);
+
+	/* Every thread records into its own shard */
+	StatementMetrics metrics;
+	auto id = metrics.getStatementId("SELECT 1");
+	std::vector<std::thread> threads;
+	for(int t = 0;t < 4;t++) {
+		threads.emplace_back([&](){
+			for(int i = 0;i < 10000;i++) {
+				metrics.recordExecute(id, std::chrono::microseconds(i % 100), true, 1);
+			}
+		});
+	}
+	for(auto &thread : threads) {
+		thread.join();
+	}
+
+	auto merged = metrics.getStatistics();
+	REQUIRE(merged.size() == 1);
+	REQUIRE(merged[0].statement == "SELECT ?");
+	REQUIRE(merged[0].executions == 40000);
+	REQUIRE(merged[0].busyRetries == 40000);
+	REQUIRE(merged[0].execute.getCount() == 40000);
+
+	/* Disabled metrics are empty */
+	memoryParams.setStatementMetrics(false);
+	REQUIRE(memoryParams.connect()->getStatementStatistics().empty());
+}
+
+TEST_CASE("Slow query log with query plans", "[ecsdb_slowquery]") {
+	using namespace ecs::db3;
+
+	std::mutex               mutex;
+	std::condition_variable  received;
+	std::vector<SlowQuery>   slowQueries;
+
+	ConnectionParameters memoryParams(params);
+	memoryParams.setBackend("sqlite3");
+	memoryParams.setDbFilename(":memory:");
+	memoryParams.setSlowQueryThreshold(std::chrono::microseconds(1));
+	memoryParams.setSlowQuerySink([&](const SlowQuery &slowQuery){
+		std::scoped_lock lock(mutex);
+		slowQueries.push_back(slowQuery);
+		received.notify_all();
+	});
+
+	auto connection = memoryParams.connect();
+	REQUIRE(connection->execute("CREATE TABLE items(id INTEGER PRIMARY KEY, name TEXT);"));
+	REQUIRE(connection->execute(
+		"WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM c WHERE x < 200000) "
+		"INSERT INTO items SELECT x, 'item' || x FROM c;"));
+
+	/* Filtering on a column without index scans the table. The
+	 * scan must take at least a millisecond to be measured.
+	 */
+	auto select = connection->prepare("SELECT id FROM items WHERE name = ? ORDER BY name;");
+	select->bind(std::string("item42"));
+	REQUIRE(select->execute().fetchAll().size() == 1);
+
+	SlowQuery scan;
+	{
+		std::unique_lock lock(mutex);
+		REQUIRE(received.wait_for(lock, std::chrono::seconds(10), [&](){
+			return std::any_of(slowQueries.begin(), slowQueries.end(), [](const SlowQuery &slowQuery){
+				return slowQuery.sql.find("SELECT id FROM items") != std::string::npos;
+			});
+		}));
+		scan = *std::find_if(slowQueries.begin(), slowQueries.end(), [](const SlowQuery &slowQuery){
+			return slowQuery.sql.find("SELECT id FROM items") != std::string::npos;
+		});
+	}
+
+	REQUIRE(scan.sql == "SELECT id FROM items WHERE name = 'item42' ORDER BY name;");
+	REQUIRE(scan.duration >= std::chrono::microseconds(1));
+	REQUIRE(scan.fullscanSteps >= 199999);
+	REQUIRE(scan.vmSteps > 0);
+	REQUIRE(scan.plan.find("SCAN items") != std::string::npos);
+
+	/* Explaining a failed slow query keeps its error message */
+	auto failing = connection->prepare(
+		"SELECT CASE WHEN id = 200000 THEN abs(-9223372036854775807 - 1) ELSE id END FROM items;");
+	auto failingResult = failing->execute();
+	while(failingResult.fetch()) {
+	}
+	REQUIRE(failingResult.getErrorMessage().find("integer overflow") != std::string::npos);
+}
+
+TEST_CASE("Index advice for the captured workload", "[ecsdb_indexadvisor]") {
+	using namespace ecs::db3;
+
+	ConnectionParameters memoryParams(params);
+	memoryParams.setBackend("sqlite3");
+	memoryParams.setDbFilename(":memory:");
+
+	/* Advice needs the workload capture */
+	REQUIRE_THROWS(memoryParams.connect()->adviseIndexes());
+
+	memoryParams.setWorkloadCapture(true);
+	auto connection = memoryParams.connect();
+	REQUIRE(connection->execute("CREATE TABLE customers(id INTEGER PRIMARY KEY, name TEXT);"));
+	REQUIRE(connection->execute("CREATE TABLE orders(id INTEGER PRIMARY KEY, customer INTEGER, status TEXT, total DOUBLE);"));
+	REQUIRE(connection->execute(
+		"WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM c WHERE x < 100) "
+		"INSERT INTO customers SELECT x, 'customer' || x FROM c;"));
+	REQUIRE(connection->execute(
+		"WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM c WHERE x < 5000) "
+		"INSERT INTO orders SELECT x, x % 100, CASE x % 3 WHEN 0 THEN 'open' ELSE 'done' END, x FROM c;"));
+
+	auto orders = connection->prepare("SELECT id, total FROM orders WHERE customer = ? AND status = ?;");
+	for(std::int64_t i = 0;i < 20;i++) {
+		orders->reset();
+		orders->bind(i);
+		orders->bind(std::string("open"));
+		orders->execute().fetchAll();
+	}
+
+	auto customers = connection->prepare("SELECT id FROM customers WHERE name = ?;");
+	customers->bind(std::string("customer7"));
+	REQUIRE(customers->execute().fetchAll().size() == 1);
+
+	/* Searching by primary key needs no index */
+	auto byId = connection->prepare("SELECT name FROM customers WHERE id = ?;");
+	byId->bind(std::int64_t(7));
+	REQUIRE(byId->execute().fetchAll().size() == 1);
+
+	auto advice = connection->adviseIndexes();
+	REQUIRE(advice.size() == 2);
+
+	/* Both equality columns end up in one index */
+	REQUIRE(advice[0].table == "orders");
+	std::vector<std::string> columns(advice[0].columns);
+	std::sort(columns.begin(), columns.end());
+	REQUIRE(columns == std::vector<std::string>{"customer", "status"});
+	REQUIRE(advice[0].savedSteps >= 20 * 4999);
+	REQUIRE(advice[0].statements.size() == 1);
+
+	REQUIRE(advice[1].table == "customers");
+	REQUIRE(advice[1].columns == std::vector<std::string>{"name"});
+	REQUIRE(advice[1].savedSteps < advice[0].savedSteps);
+
+	/* The proposed statements are valid */
+	for(auto &index : advice) {
+		REQUIRE(connection->execute(index.createStatement));
+	}
+}
+
+TEST_CASE("Scoped zones merged into a call tree", "[ecstools_profiler]") {
+	using namespace ecs::tools;
+	static constexpr ProfilerZone outer{"outer", __FILE__, __LINE__};
+	static constexpr ProfilerZone inner{"inner", __FILE__, __LINE__};
+	static constexpr ProfilerZone leaf{"leaf", __FILE__, __LINE__};
+
+	auto &profiler = Profiler::instance();
+	profiler.clear();
+
+	auto work = [&](){
+		for(int i = 0;i < 100;i++) {
+			ProfilerScope outerScope(outer);
+			for(int j = 0;j < 3;j++) {
+				ProfilerScope innerScope(inner);
+				ProfilerScope leafScope(leaf);
+			}
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for(int i = 0;i < 4;i++) {
+		threads.emplace_back(work);
+	}
+	for(auto &thread : threads) {
+		thread.join();
+	}
+
+	REQUIRE(profiler.getDropped() == 0);
+	REQUIRE(profiler.getEvents().size() == 4 * 100 * 7);
+
+	auto tree = profiler.getCallTree();
+	REQUIRE(tree.children.size() == 1);
+	auto &outerNode = tree.children.front();
+	REQUIRE(std::string(outerNode.name) == "outer");
+	REQUIRE(outerNode.calls == 400);
+	REQUIRE(outerNode.children.size() == 1);
+	auto &innerNode = outerNode.children.front();
+	REQUIRE(std::string(innerNode.name) == "inner");
+	REQUIRE(innerNode.calls == 1200);
+	REQUIRE(innerNode.children.size() == 1);
+	REQUIRE(innerNode.children.front().calls == 1200);
+	REQUIRE(outerNode.totalNanoseconds >= innerNode.totalNanoseconds);
+	REQUIRE(outerNode.selfNanoseconds == outerNode.totalNanoseconds - innerNode.totalNanoseconds);
+
+	std::ostringstream trace;
+	profiler.writeChromeTrace(trace);
+	REQUIRE(trace.str().find("\"traceEvents\"") != std::string::npos);
+	REQUIRE(trace.str().find("\"name\":\"leaf\"") != std::string::npos);
+
+	profiler.clear();
+	REQUIRE(profiler.getEvents().empty());
+}
+
+TEST_CASE("Instrumented backend wrapping sqlite3", "[ecsdb_instrumented]") {
+	using namespace ecs::db3;
+
+	ConnectionParameters memoryParams(params);
+	memoryParams.setBackend("instrumented");
+	memoryParams.setDbFilename(":memory:");
+	REQUIRE_THROWS(memoryParams.connect());
+
+	memoryParams.setWrappedBackend("sqlite");
+	REQUIRE_THROWS(memoryParams.connect());
+
+	memoryParams.setWrappedBackend("sqlite3");
+	memoryParams.setStatementMetrics(true);
+
+	auto connection = memoryParams.connect();
+	REQUIRE(connection->execute("CREATE TABLE items(id INTEGER PRIMARY KEY, name TEXT);"));
+
+	auto insert = connection->prepare("INSERT INTO items(name) VALUES(?);");
+	for(int i = 0;i < 50;i++) {
+		insert->reset();
+		insert->bind(std::string("abcd"));
+		insert->execute();
+	}
+	REQUIRE(insert->lastInsertId() == 50);
+
+	auto select = connection->prepare("SELECT id, name FROM items;");
+	REQUIRE(select->execute().fetchAll().size() == 50);
+	REQUIRE_THROWS(connection->prepare("SELECT * FROM missing;"));
+	REQUIRE_THROWS(connection->prepare("INSERT INTO items(id) VALUES(1);")->execute());
+
+	auto backendStatistics = connection->getBackendStatistics();
+	auto find = [](std::vector<StatementStatistics> &statistics, const std::string &statement) {
+		auto it = std::find_if(statistics.begin(), statistics.end(), [&](const StatementStatistics &entry){
+			return entry.statement == statement;
+		});
+		REQUIRE(it != statistics.end());
+		return *it;
+	};
+
+	auto inserted = find(backendStatistics, "INSERT INTO items(name) VALUES(?);");
+	REQUIRE(inserted.prepares == 1);
+	REQUIRE(inserted.binds == 50);
+	REQUIRE(inserted.executions == 50);
+	REQUIRE(inserted.errors == 0);
+
+	auto selected = find(backendStatistics, "SELECT id, name FROM items;");
+	REQUIRE(selected.rows == 50);
+	REQUIRE(selected.bytes == 50 * (8 + 4));
+	REQUIRE(find(backendStatistics, "INSERT INTO items(id) VALUES(?);").errors == 1);
+
+	/* The library measures around the backend */
+	auto statementStatistics = connection->getStatementStatistics();
+	auto wrapped = find(statementStatistics, "SELECT id, name FROM items;");
+	REQUIRE(wrapped.rows == selected.rows);
+	REQUIRE(wrapped.fetch.getSum() >= selected.fetch.getSum());
+
+	/* Only the instrumented backend records backend statistics */
+	ConnectionParameters plainParams(memoryParams);
+	plainParams.setBackend("sqlite3");
+	REQUIRE(plainParams.connect()->getBackendStatistics().empty());
+}
+
+TEST_CASE("Null backend with synthetic results", "[ecsdb_null]") {
+	using namespace ecs::db3;
+
+	ConnectionParameters nullParams(params);
+	nullParams.setBackend("null");
+
+	SyntheticResult synthetic;
+	synthetic.rows      = 1000;
+	synthetic.columns   = {types::typeId::int64_T, types::typeId::string, types::typeId::double_T, types::typeId::null};
+	synthetic.textBytes = 8;
+	nullParams.setSyntheticResult(synthetic);
+
+	auto connection = nullParams.connect();
+	REQUIRE(connection->execute("CREATE TABLE ignored(id INTEGER);"));
+
+	auto statement = connection->prepare("SELECT * FROM anything WHERE id = ?;");
+	statement->bind(std::int64_t(12));
+	auto table = statement->execute().fetchAll({"column1"});
+	REQUIRE(table.size() == 1000);
+	REQUIRE(table.getColumnName(3) == "column3");
+	REQUIRE(table.getText(999, 1) == "xxxxxxxx");
+	REQUIRE(statement->lastInsertId() == 2);
+
+	std::int64_t rows = 0;
+	statement->reset();
+	auto result = statement->execute();
+	while(auto row = result.fetch()) {
+		REQUIRE(row.size() == 4);
+		REQUIRE(row[0].cast_reference<types::Int64::type>() == rows);
+		REQUIRE(row[1].cast_reference<types::String::type>() == "xxxxxxxx");
+		REQUIRE(row[2].cast_reference<types::Double::type>() == static_cast<double>(rows) + 0.5);
+		REQUIRE_FALSE(row[3].has_value());
+		rows++;
+	}
+	REQUIRE(rows == 1000);
+
+	/* There is no schema to migrate */
+	Migrator migrator(connection);
+	REQUIRE_THROWS(migrator.startMigration());
+
+	/* Blobs can not be generated */
+	synthetic.columns.push_back(types::typeId::blob);
+	nullParams.setSyntheticResult(synthetic);
+	REQUIRE_THROWS(nullParams.connect());
+}
+
+TEST_CASE("Prefetching sqlite3 scans on a thread of the statement", "[ecsdb_prefetch]") {
+	using namespace ecs::db3;
+
+	ConnectionParameters prefetchParams(params);
+	prefetchParams.setBackend("sqlite3");
+	prefetchParams.setDbFilename(":memory:");
+	prefetchParams.setPrefetchDepth(4);
+
+	auto connection = prefetchParams.connect();
+	REQUIRE(connection->execute("CREATE TABLE items(id INTEGER PRIMARY KEY, name TEXT, data BLOB);"));
+	REQUIRE(connection->execute(
+		"WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM c WHERE x < 1000) "
+		"INSERT INTO items SELECT x, 'item' || x, CAST('blob' || x AS BLOB) FROM c;"));
+
+	/* Rows and blobs stay valid while the thread steps ahead */
+	auto select = connection->prepare("SELECT id, name, data FROM items ORDER BY id;");
+	auto result = select->execute();
+	std::vector<RowResult> rows;
+	while(auto row = result.fetch()) {
+		rows.push_back(std::move(row));
+	}
+	REQUIRE(rows.size() == 1000);
+	for(std::size_t i = 0;i < rows.size();++i) {
+		auto id   = std::to_string(i + 1);
+		auto blob = rows[i].at(2).cast_reference<types::Blob::type>();
+		REQUIRE(rows[i].at(0).cast_reference<std::int64_t>() == static_cast<std::int64_t>(i + 1));
+		REQUIRE(rows[i].at(1).cast_reference<std::string>() == "item" + id);
+		REQUIRE(std::string(std::istreambuf_iterator<char>(blob.get()), {}) == "blob" + id);
+	}
+
+	/* Stopping in the middle of the scan and executing again */
+	select->reset();
+	result = select->execute();
+	for(int i = 0;i < 10;++i) {
+		REQUIRE(result.fetch());
+	}
+	select->reset();
+	REQUIRE(select->execute().fetchAll().size() == 1000);
+
+	/* Empty results and writes are not prefetched */
+	REQUIRE(connection->prepare("SELECT id FROM items WHERE id < 0;")->execute().fetchAll().size() == 0);
+	REQUIRE(connection->execute("DELETE FROM items WHERE id > 500;"));
+	REQUIRE(connection->prepare("SELECT id FROM items;")->execute().fetchAll().size() == 500);
+
+	/* The statement can be destroyed while the thread is running */
+	auto pending = connection->prepare("SELECT id FROM items;");
+	REQUIRE(pending->execute().fetch());
+	pending.reset();
+
+	/* A failing step ends the result with its error like without prefetch */
+	for(std::size_t depth : {0, 4}) {
+		ConnectionParameters failingParams(prefetchParams);
+		failingParams.setPrefetchDepth(depth);
+
+		auto failing = failingParams.connect()->prepare(
+			"WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM c WHERE x < 1000) "
+			"SELECT CASE WHEN x = 500 THEN abs(-9223372036854775807 - 1) ELSE x END FROM c;");
+		auto failingResult = failing->execute();
+		std::size_t fetched = 0;
+		while(failingResult.fetch()) {
+			fetched++;
+		}
+		REQUIRE(fetched == 499);
+		REQUIRE(failingResult.getErrorMessage().find("integer overflow") != std::string::npos);
+	}
+}
+
+TEST_CASE("Values not matching the declared column type", "[ecsdb_decodeplan]") {
+	using namespace ecs::db3;
+
+	ConnectionParameters memoryParams(params);
+	memoryParams.setBackend("sqlite3");
+	memoryParams.setDbFilename(":memory:");
+
+	auto connection = memoryParams.connect();
+	REQUIRE(connection->execute("CREATE TABLE mixed(a INTEGER, b TEXT, c DOUBLE, d BLOB, e TIMESTAMP);"));
+	REQUIRE(connection->execute("INSERT INTO mixed VALUES(1, 'text', 1.5, X'0102', 42);"));
+	REQUIRE(connection->execute("INSERT INTO mixed VALUES('text', 2, 'text', 3, 'text');"));
+	REQUIRE(connection->execute("INSERT INTO mixed VALUES(2.5, NULL, 4, NULL, NULL);"));
+
+	auto select = connection->prepare("SELECT a, b, c, d, e, a + 1 FROM mixed;");
+	auto result = select->execute();
+
+	auto row = result.fetch();
+	REQUIRE(row.at(0).getTypeId() == types::typeId::int64_T);
+	REQUIRE(row.at(1).cast_reference<std::string>() == "text");
+	REQUIRE(row.at(2).cast_reference<double>() == 1.5);
+	REQUIRE(row.at(3).getTypeId() == types::typeId::blob);
+	/* Timestamps are only mapped with setNativeTimestamps() */
+	REQUIRE(row.at(4).cast_reference<std::int64_t>() == 42);
+	REQUIRE(row.at(5).cast_reference<std::int64_t>() == 2);
+
+	row = result.fetch();
+	REQUIRE(row.at(0).cast_reference<std::string>() == "text");
+	REQUIRE(row.at(1).cast_reference<std::string>() == "2");
+	REQUIRE(row.at(2).cast_reference<std::string>() == "text");
+	REQUIRE(row.at(3).cast_reference<std::int64_t>() == 3);
+	REQUIRE(row.at(4).cast_reference<std::string>() == "text");
+
+	row = result.fetch();
+	REQUIRE(row.at(0).cast_reference<double>() == 2.5);
+	REQUIRE(row.at(1).getTypeId() == types::typeId::null);
+	REQUIRE(row.at(2).cast_reference<double>() == 4.0);
+
+	/* The statement is not stepped again after the last row */
+	REQUIRE_FALSE(result.fetch());
+	REQUIRE_FALSE(result.fetch());
+	/* Stepping prepares the statement again after a schema change */
+	auto all = connection->prepare("SELECT * FROM mixed WHERE a = 1;");
+	REQUIRE(all->execute().fetch().size() == 5);
+	REQUIRE(connection->execute("ALTER TABLE mixed ADD COLUMN f TEXT DEFAULT 'added';"));
+	all->reset();
+	auto added = all->execute();
+	auto grown = added.fetch();
+	REQUIRE(grown.size() == 6);
+	REQUIRE(grown.at(5).cast_reference<std::string>() == "added");
+}
+
+TEST_CASE("Dictionary encoded text columns", "[ecsdb_dictionary]") {
+	using namespace ecs::db3;
+
+	ConnectionParameters memoryParams(params);
+	memoryParams.setBackend("sqlite3");
+	memoryParams.setDbFilename(":memory:");
+
+	auto connection = memoryParams.connect();
+	REQUIRE(connection->execute("CREATE TABLE orders(id INTEGER PRIMARY KEY, status TEXT, country TEXT);"));
+	REQUIRE(connection->execute(
+		"WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM c WHERE x < 1000) "
+		"INSERT INTO orders SELECT x, CASE x % 3 WHEN 0 THEN 'open' WHEN 1 THEN 'paid' ELSE 'shipped' END, "
+		"CASE WHEN x % 10 = 0 THEN NULL ELSE 'DE' END FROM c;"));
+
+	auto select = connection->prepare("SELECT id, status, country FROM orders ORDER BY id;");
+	auto table  = select->execute().fetchAll({"status", "country"});
+	REQUIRE(table.size() == 1000);
+	REQUIRE_FALSE(table.isEncoded(0));
+	REQUIRE(table.isEncoded(1));
+	REQUIRE(table.getText(0, 1) == "paid");
+	REQUIRE(table.getText(1, 1) == "shipped");
+	REQUIRE(table.getText(2, 1) == "open");
+	REQUIRE(table.getText(0, 2) == "DE");
+	REQUIRE(table.at(0).at(1).getTypeId() == types::typeId::dictionary);
+	REQUIRE(table.at(0).at(0).cast_reference<std::int64_t>() == 1);
+
+	/* NULL is kept as it is */
+	REQUIRE(table.at(9).at(2).getTypeId() == types::typeId::null);
+	REQUIRE_THROWS(table.getText(9, 2));
+
+	select->reset();
+	REQUIRE_THROWS(select->execute().fetchAll({"missing"}));
+
+	/* Equal texts share their code and storage */
+	Table encoded;
+	encoded.encodeColumn(0);
+	for(int i = 0;i < 100;i++) {
+		auto row = std::make_unique<Row>();
+		*row << std::make_unique<types::cell_T>(std::string(i % 2 ? "odd" : "even"), types::typeId::string);
+		*row << std::make_unique<types::cell_T>(std::string("plain"), types::typeId::string);
+		encoded << std::move(row);
+	}
+	REQUIRE(encoded.getDictionarySize() == 2);
+	REQUIRE(encoded.getCode(0, 0) == encoded.getCode(98, 0));
+	REQUIRE(encoded.getCode(0, 0) != encoded.getCode(1, 0));
+	REQUIRE(encoded.getCode(0, 1) == Table::noCode);
+	REQUIRE(encoded.getText(0, 0).data() == encoded.getText(98, 0).data());
+	REQUIRE(encoded.getDictionaryValue(encoded.getCode(1, 0)) == "odd");
+	REQUIRE(encoded.getText(5, 1) == "plain");
+
+	/* Rows which are already in the table are encoded as well */
+	encoded.encodeColumn(1);
+	REQUIRE(encoded.getDictionarySize() == 3);
+	REQUIRE(encoded.getText(5, 1) == "plain");
+}
+
+TEST_CASE("PostgreSQL notifications", "[.][postgresql]") {
+	using namespace ecs::db3;
+
+	ConnectionParameters postgresParams(params);
+	postgresParams.setBackend("postgresql");
+	postgresParams.setHostname("localhost");
+	postgresParams.setPort(5432);
+	postgresParams.setDbName("test");
+	postgresParams.setDbPassword("test");
+	postgresParams.setDbUser("test");
+
+	auto connection = postgresParams.connect();
+	REQUIRE(connection.get() != nullptr);
+
+	std::mutex               mutex;
+	std::condition_variable  received;
+	std::vector<std::string> payloads;
+	std::atomic<bool>        released(false);
+
+	connection->listen("ecs_test", [&](const Notification &notification){
+		/* Hold the dispatcher so the queue of the listener fills up */
+		while(!released) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		std::scoped_lock lock(mutex);
+		REQUIRE(notification.channel == "ecs_test");
+		REQUIRE(notification.processId != 0);
+		payloads.push_back(notification.payload);
+		received.notify_all();
+	});
+
+	/* More notifications than the queue of the listener holds */
+	REQUIRE(connection->execute("SELECT pg_notify('ecs_test', i::text) FROM generate_series(1, 10000) AS i;"));
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	released = true;
+
+	{
+		std::unique_lock lock(mutex);
+		REQUIRE(received.wait_for(lock, std::chrono::seconds(30), [&](){
+			return payloads.size() == 10000;
+		}));
+	}
+
+	for(std::size_t i = 0;i < payloads.size();++i) {
+		REQUIRE(payloads[i] == std::to_string(i + 1));
+	}
+
+	connection->unlisten("ecs_test");
+}
+
 TEST_CASE("MariaDB") {
 	using namespace ecs::db3;
 	params.setBackend("mariadb");